@@ -1,12 +1,280 @@
 #include "stdafx.h"
 #include "FFLLAPI.h"	// FFLL API
 #include <iostream>	// for i/o functions
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string.h>
 
 #define OUR_HEALTH	0 // our health is 1st variable
 #define ENEMY_HEALTH	1 // enemy health is 2nd variable
 
+#define STRESS_STEPS	101	// values of each input the stress test tries (0 .. 100)
+#define STRESS_PASSES	50	// times each thread goes through all the values
+
+#define BENCH_ROWS		20000	// rows the batch benchmark evaluates for each model
+#define BENCH_VARS		5		// input variables of the benchmark's large model
+#define BENCH_SETS		9		// sets of each input variable of the large model
+#define BENCH_RULES		3000	// rules of the large model
+
 using namespace std;
 
+// Evaluate one model from many threads at once, each thread with its own child, and
+// check every output against the output calculated on this thread first. While they
+// run another thread opens, loads and closes models so the handle table grows under
+// them. Returns the number of outputs that didn't match.
+long stress_test(int model, const char* fcl)
+{
+	int thread_count = thread::hardware_concurrency() * 2;
+
+	if (thread_count < 4)
+		thread_count = 4;
+
+	// the outputs we expect, from a child used by this thread only
+	vector<double> expected(STRESS_STEPS * STRESS_STEPS);
+
+	int child = ffll_new_child(model);
+
+	for (int i = 0; i < STRESS_STEPS; i++)
+	{
+		for (int j = 0; j < STRESS_STEPS; j++)
+		{
+			ffll_set_value(model, child, OUR_HEALTH, i);
+			ffll_set_value(model, child, ENEMY_HEALTH, j);
+			expected[i * STRESS_STEPS + j] = ffll_get_output_value(model, child);
+		}
+	}
+
+	atomic<long> mismatches(0);
+	atomic<long> evaluations(0);
+	atomic<bool> done(false);
+	vector<thread> threads;
+
+	for (int t = 0; t < thread_count; t++)
+	{
+		threads.push_back(thread([&, t]()
+		{
+			// each thread makes its own child, at the same time as the others
+			int my_child = ffll_new_child(model);
+
+			if (my_child < 0)
+			{
+				mismatches++;
+				return;
+			}
+
+			vector<double> inputs(STRESS_STEPS * 2), outputs(STRESS_STEPS);
+			long my_mismatches = 0;
+
+			for (int pass = 0; pass < STRESS_PASSES; pass++)
+			{
+				// start each thread somewhere else so they don't move together
+				for (int k = 0; k < STRESS_STEPS * STRESS_STEPS; k++)
+				{
+					int entry = (k + t * 7919 + pass * 104729) % (STRESS_STEPS * STRESS_STEPS);
+
+					ffll_set_value(model, my_child, OUR_HEALTH, entry / STRESS_STEPS);
+					ffll_set_value(model, my_child, ENEMY_HEALTH, entry % STRESS_STEPS);
+
+					if (ffll_get_output_value(model, my_child) != expected[entry])
+						my_mismatches++;
+				}
+
+				// and one row with the batch call
+				int row = (t + pass) % STRESS_STEPS;
+
+				for (int j = 0; j < STRESS_STEPS; j++)
+				{
+					inputs[j * 2] = row;
+					inputs[j * 2 + 1] = j;
+				}
+
+				ffll_eval_batch(model, my_child, &inputs[0], STRESS_STEPS, 2, &outputs[0]);
+
+				for (int j = 0; j < STRESS_STEPS; j++)
+				{
+					if (outputs[j] != expected[row * STRESS_STEPS + j])
+						my_mismatches++;
+				}
+			}
+
+			mismatches += my_mismatches;
+			evaluations += STRESS_PASSES * STRESS_STEPS * (STRESS_STEPS + 1);
+		}));
+	}
+
+	// open and close models while the threads are running
+	thread churn([&]()
+	{
+		vector<int> models;
+
+		while (!done)
+		{
+			int other = ffll_new_model();
+
+			if (other >= 0 && ffll_load_fcl_string(other, fcl) >= 0)
+				ffll_new_child(other);
+
+			models.push_back(other);
+
+			// keep a few hundred open so the table needs more than one chunk
+			if (models.size() > 300)
+			{
+				ffll_close_model(models.front());
+				models.erase(models.begin());
+			}
+		}
+
+		for (size_t i = 0; i < models.size(); i++)
+			ffll_close_model(models[i]);
+	});
+
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+
+	done = true;
+	churn.join();
+
+	cout << "Threads: " << thread_count << "  Evaluations: " << evaluations << "  Mismatches: " << mismatches << endl;
+
+	return mismatches;
+
+} // end stress_test()
+
+// Build the FCL for a model with BENCH_VARS inputs of BENCH_SETS narrow sets each and
+// BENCH_RULES rules. Only one or two sets of each input are active at a time so
+// evaluating it one row at a time is faster than firing all the rules for a block
+// of rows with the AVX2 kernel, unlike the small example model.
+string make_bench_fcl()
+{
+	ostringstream fcl;
+	int i, j;
+
+	fcl << "FUNCTION_BLOCK\n\nVAR_INPUT\n";
+
+	for (i = 0; i < BENCH_VARS; i++)
+		fcl << "\tIn" << i << "\tREAL; (* RANGE(0 .. 100) *)\n";
+
+	fcl << "END_VAR\n\nVAR_OUTPUT\n\tOut\tREAL; (* RANGE(0 .. 10) *)\nEND_VAR\n\n";
+
+	for (i = 0; i < BENCH_VARS; i++)
+	{
+		fcl << "FUZZIFY In" << i << "\n";
+
+		for (j = 0; j < BENCH_SETS; j++)
+		{
+			double center = 100.0 * j / (BENCH_SETS - 1);
+			double width = 100.0 / (BENCH_SETS - 1);
+
+			fcl << "\tTERM T" << j << " := (" << center - width << ", 0) (" << center << ", 1) (" << center + width << ", 0);\n";
+		}
+
+		fcl << "END_FUZZIFY\n\n";
+	}
+
+	fcl << "FUZZIFY Out\n\tTERM Low := (0, 0) (0, 1) (5, 0);\n\tTERM Mid := (0, 0) (5, 1) (10, 0);\n\tTERM High := (5, 0) (10, 1) (10, 0);\nEND_FUZZIFY\n\n";
+	fcl << "DEFUZZIFY Out\n\tMETHOD: CoG;\nEND_DEFUZZIFY\n\n";
+	fcl << "RULEBLOCK first\n\tAND:MIN;\n\tACCU:MAX;\n";
+
+	// spread the rules evenly over the combinations of sets
+	const char* out_sets[] = { "Low", "Mid", "High" };
+	int combinations = 1;
+
+	for (i = 0; i < BENCH_VARS; i++)
+		combinations *= BENCH_SETS;
+
+	for (i = 0; i < BENCH_RULES; i++)
+	{
+		int combination = (int)((long long)i * combinations / BENCH_RULES);
+
+		fcl << "\tRULE " << i << ": IF ";
+
+		for (j = 0; j < BENCH_VARS; j++, combination /= BENCH_SETS)
+			fcl << (j ? " AND " : "") << "(In" << j << " IS T" << combination % BENCH_SETS << ")";
+
+		fcl << " THEN (Out IS " << out_sets[i % 3] << ");\n";
+	}
+
+	fcl << "END_RULEBLOCK\n\nEND_FUNCTION_BLOCK\n";
+
+	return fcl.str();
+
+} // end make_bench_fcl()
+
+// Time ffll_eval_batch() against setting the values and getting the output one row
+// at a time, for a model the AVX2 kernel is used for (the example) and one it isn't
+// (see make_bench_fcl()), and check the batch outputs match. Returns the number of
+// outputs that didn't match.
+long batch_bench(const char* fcl)
+{
+	string bench_fcl = make_bench_fcl();
+	const char* names[] = { "Example model", "Large model" };
+	const char* fcls[] = { fcl, bench_fcl.c_str() };
+	int var_counts[] = { 2, BENCH_VARS };
+	long mismatches = 0;
+
+	for (int m = 0; m < 2; m++)
+	{
+		int model = ffll_new_model();
+
+		if (ffll_load_fcl_string(model, fcls[m]) < 0)
+		{
+			cout << names[m] << ": failed to load" << endl;
+			ffll_close_model(model);
+			mismatches++;
+			continue;
+		}
+
+		int child = ffll_new_child(model);
+		int cols = var_counts[m];
+		vector<double> inputs(BENCH_ROWS * cols), batch_outputs(BENCH_ROWS), row_outputs(BENCH_ROWS);
+		unsigned int seed = 12345;
+
+		for (size_t i = 0; i < inputs.size(); i++)
+		{
+			seed = seed * 1103515245 + 12345;
+			inputs[i] = (seed >> 8) % 10001 / 100.0;
+		}
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+		ffll_eval_batch(model, child, &inputs[0], BENCH_ROWS, cols, &batch_outputs[0]);
+
+		chrono::steady_clock::time_point middle = chrono::steady_clock::now();
+
+		for (int row = 0; row < BENCH_ROWS; row++)
+		{
+			for (int var = 0; var < cols; var++)
+				ffll_set_value(model, child, var, inputs[row * cols + var]);
+
+			row_outputs[row] = ffll_get_output_value(model, child);
+		}
+
+		chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+		long model_mismatches = 0;
+
+		for (int row = 0; row < BENCH_ROWS; row++)
+		{
+			if (batch_outputs[row] != row_outputs[row])
+				model_mismatches++;
+		}
+
+		cout << names[m] << ":  Batch: " << chrono::duration<double, nano>(middle - start).count() / BENCH_ROWS << " ns/row"
+			<< "  One row at a time: " << chrono::duration<double, nano>(end - middle).count() / BENCH_ROWS << " ns/row"
+			<< "  Mismatches: " << model_mismatches << endl;
+
+		mismatches += model_mismatches;
+
+		ffll_close_model(model);
+	}
+
+	return mismatches;
+
+} // end batch_bench()
+
 int main(int argc, char* argv[])
 {
 	string myFCL = " \
@@ -81,18 +349,33 @@ END_FUNCTION_BLOCK \n\
 		return 0;
 	}
 
+	// "-stress" (or "/stress") runs the thread stress test and "-bench" (or "/bench")
+	// the batch benchmark without the menu, the exit code is 0 if every output
+	// matched so they can be run from a script
+	if (argc > 1 && (strcmp(argv[1], "-stress") == 0 || strcmp(argv[1], "/stress") == 0))
+		return (stress_test(model, myFCL.c_str()) == 0) ? 0 : 1;
+
+	if (argc > 1 && (strcmp(argv[1], "-bench") == 0 || strcmp(argv[1], "/bench") == 0))
+		return (batch_bench(myFCL.c_str()) == 0) ? 0 : 1;
+
 	// create a child for the model...
 	int child = ffll_new_child(model);
 
 	while (1)
 	{
-		cout << "SELECT AN OPTION:\n\tS - set values\n\tQ - quit";
+		cout << "SELECT AN OPTION:\n\tS - set values\n\tT - thread stress test\n\tB - batch benchmark\n\tQ - quit";
 		cout << endl;
 		cin >> option;
 
 		if (option == 'Q' || option == 'q')
 			break;
 
+		if (option == 'T' || option == 't')
+			stress_test(model, myFCL.c_str());
+
+		if (option == 'B' || option == 'b')
+			batch_bench(myFCL.c_str());
+
 		if (option == 'S' || option == 's')
 		{
 			cout << "Our Health: ";
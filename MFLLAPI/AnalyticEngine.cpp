@@ -0,0 +1,830 @@
+//
+// File:	AnalyticEngine.cpp
+//
+// Purpose:	Implementation of the AnalyticEngine class. This class calculates the
+//			output of a model from the exact node values of the sets rather than
+//			the values[] arrays.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#include "AnalyticEngine.h"
+#include "MemberFuncBase.h"
+#include "RuleArray.h"
+#include "InferenceScratch.h"
+#include <float.h>
+
+#ifdef _DEBUG
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+
+#include "debug.h"
+
+#endif
+
+//
+// Function:	AnalyticEngine()
+//
+// Purpose:		Constructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+AnalyticEngine::AnalyticEngine()
+{
+	inference_min = composition_min = true;
+	use_mom = use_wa = false;
+	rules = NULL;
+
+	var_count = 0;
+	var_first_set_arr.push_back(0);
+
+	out_left_x = out_right_x = 0;
+
+}; // end AnalyticEngine::AnalyticEngine()
+
+//
+// Function:	~AnalyticEngine()
+//
+// Purpose:		Destructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+AnalyticEngine::~AnalyticEngine()
+{
+}; // end AnalyticEngine::~AnalyticEngine()
+
+//
+// Function:	add_set()
+//
+// Purpose:		Add a set to the engine. The sets of each input var must be added
+//				right after the var (see add_input_var()), in the same order as the
+//				var's sets. The output sets must be added after set_output_var().
+//
+// Arguments:
+//
+//		int				var_idx		-	index of the input var the set belongs to, OUTPUT_IDX for the output var
+//		int				func_type	-	type of membership function (MemberFuncBase::TYPE)
+//		int				node_count	-	number of nodes
+//		const RealType*	x			-	exact 'x' value of each node
+//		const RealType*	y			-	exact 'y' value (0 to 1) of each node
+//		int				rule_index	-	set's rule index (ignored for output sets)
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void AnalyticEngine::add_set(int var_idx, int func_type, int node_count, const RealType* x, const RealType* y, int rule_index)
+{
+	int i;	// counter
+	bool output = (var_idx == OUTPUT_IDX);
+
+	assert(output || var_idx == var_count - 1);
+
+	RealType left_x = output ? out_left_x : var_left_arr[var_idx];
+	RealType right_x = output ? out_right_x : var_right_arr[var_idx];
+
+	// clamp the nodes to the variable's range
+	RealType node_x[7];
+
+	for (i = 0; i < node_count && i < 7; i++)
+		{
+		node_x[i] = x[i];
+
+		if (node_x[i] < left_x)
+			node_x[i] = left_x;
+		if (node_x[i] > right_x)
+			node_x[i] = right_x;
+		}
+
+	// get the trapezoid's nodes...
+	RealType a, b, c, d;
+	int shape = SHAPE_TRAPEZOID;
+	int curve_idx = -1;
+
+	switch (func_type)
+		{
+		case MemberFuncBase::TRIANGLE:
+
+			a = node_x[0];
+			b = c = node_x[1];
+			d = node_x[2];
+			break;
+
+		case MemberFuncBase::TRAPEZOID:
+
+			a = node_x[0];
+			b = node_x[1];
+			c = node_x[2];
+			d = node_x[3];
+			break;
+
+		case MemberFuncBase::S_CURVE:
+
+			shape = SHAPE_S_CURVE;
+			curve_idx = static_cast<int>(curve_arr.size());
+
+			for (i = 0; i < 7; i++)
+				curve_arr.push_back(node_x[i]);
+			for (i = 0; i < 7; i++)
+				curve_arr.push_back(y[i]);
+
+			// the trapezoid just covers the curve, the DOM comes from the curve
+			a = b = node_x[0];
+			c = d = node_x[6];
+			break;
+
+		case MemberFuncBase::SINGLETON:
+		default:
+
+			shape = SHAPE_SINGLETON;
+			a = b = c = d = node_x[0];
+			break;
+
+		} // end switch on func type
+
+	// make sure the nodes are in order
+	if (b < a)
+		b = a;
+	if (c < b)
+		c = b;
+	if (d < c)
+		d = c;
+
+	_set_arr& sets = output ? out_sets : in_sets;
+
+	sets.a.push_back(a);
+	sets.b.push_back(b);
+	sets.c.push_back(c);
+	sets.d.push_back(d);
+	sets.left_slope.push_back((b > a) ? 1.0 / (b - a) : 0.0);
+	sets.right_slope.push_back((d > c) ? 1.0 / (d - c) : 0.0);
+	sets.shape.push_back(shape);
+	sets.curve_idx.push_back(curve_idx);
+
+	if (output)
+		{
+		out_trap_arr.push_back((shape == SHAPE_TRAPEZOID) ? 1.0 : 0.0);
+
+		// the mean of the maxima is the middle of the first and last nodes with the highest 'y'
+		RealType max_y = -1;
+		int first = 0, last = 0;
+
+		for (i = 0; i < node_count && i < 7; i++)
+			{
+			if (y[i] > max_y)
+				{
+				max_y = y[i];
+				first = last = i;
+				}
+			else if (y[i] == max_y)
+				last = i;
+			}
+
+		out_mom_arr.push_back((node_x[first] + node_x[last]) / 2.0);
+
+		} // end if output set
+	else
+		{
+		int set_idx = static_cast<int>(in_rule_index_arr.size());
+
+		in_rule_index_arr.push_back(rule_index);
+		in_var_arr.push_back(var_idx);
+
+		if (shape == SHAPE_S_CURVE)
+			in_curve_set_arr.push_back(set_idx);
+
+		var_first_set_arr[var_count] = set_idx + 1;
+
+		} // end else input set
+
+} // end AnalyticEngine::add_set()
+
+//
+// Function:	add_rule()
+//
+// Purpose:		Add a defined rule. The rules must be added in increasing rule index
+//				order, after all the sets are added.
+//
+// Arguments:
+//
+//		int rule_index	-	index of the rule (see FuzzyModelBase::calc_rule_index())
+//		int out_set		-	output set the rule fires
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void AnalyticEngine::add_rule(int rule_index, int out_set)
+{
+	int i;	// counter
+
+	for (i = 0; i < var_count; i++)
+		{
+		if (var_first_set_arr[i + 1] == var_first_set_arr[i])
+			return;	// a var with no sets, no rule can fire
+		}
+
+	int first = static_cast<int>(rule_set_arr.size());
+
+	rule_set_arr.resize(first + var_count);
+
+	// break the rule into its sets, the last var changes fastest
+	for (i = var_count - 1; i >= 0; i--)
+		{
+		int set_count = var_first_set_arr[i + 1] - var_first_set_arr[i];
+
+		rule_set_arr[first + i] = var_first_set_arr[i] + rule_index % set_count;
+		rule_index /= set_count;
+		}
+
+	rule_out_arr.push_back(out_set);
+
+} // end AnalyticEngine::add_rule()
+
+//
+// Function:	calc_output()
+//
+// Purpose:		Calculate the defuzzified output value for the crisp input values passed in.
+//
+// Arguments:
+//
+//		const RealType*		var_value_arr	-	crisp value of each input variable
+//		InferenceScratch*	scratch			-	working memory, one per thread
+//
+// Returns:
+//
+//		RealType - the output value, FLT_MIN if no ouput set is active
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+RealType AnalyticEngine::calc_output(const RealType* var_value_arr, InferenceScratch* scratch) const
+{
+	int i, j;	// counters
+	int in_set_count = static_cast<int>(in_rule_index_arr.size());
+	int out_set_count = static_cast<int>(out_mom_arr.size());
+
+	if (var_count == 0 || in_set_count == 0 || out_set_count == 0 || scratch->alloc(var_count))
+		return FLT_MIN;
+
+	// make sure the scratch arrays are big enough
+	if (static_cast<int>(scratch->real_dom_arr.size()) < in_set_count)
+		{
+		scratch->real_dom_arr.resize(in_set_count);
+		scratch->real_active_arr.resize(in_set_count);
+		}
+	if (static_cast<int>(scratch->real_active_start_arr.size()) < var_count + 1)
+		{
+		scratch->real_active_start_arr.resize(var_count + 1);
+		scratch->real_activation_arr.resize(var_count);
+		}
+	if (static_cast<int>(scratch->real_level_arr.size()) < out_set_count)
+		scratch->real_level_arr.resize(out_set_count);
+
+	RealType*	dom_arr = &scratch->real_dom_arr[0];
+	int*		active_arr = &scratch->real_active_arr[0];
+	int*		active_start_arr = &scratch->real_active_start_arr[0];
+	RealType*	level_arr = &scratch->real_level_arr[0];
+
+	const RealType*	a = &in_sets.a[0];
+	const RealType*	d = &in_sets.d[0];
+	const RealType*	left_slope = &in_sets.left_slope[0];
+	const RealType*	right_slope = &in_sets.right_slope[0];
+
+	// calculate the DOM of every input set...
+	for (i = 0; i < var_count; i++)
+		{
+		RealType x = var_value_arr[i];
+
+		if (x < var_left_arr[i])
+			x = var_left_arr[i];
+		if (x > var_right_arr[i])
+			x = var_right_arr[i];
+
+		// the DOM is the lesser of the rising and falling edge, vertical edges are a step
+		for (j = var_first_set_arr[i]; j < var_first_set_arr[i + 1]; j++)
+			{
+			RealType left = (left_slope[j] != 0) ? (x - a[j]) * left_slope[j] : ((x >= a[j]) ? 1.0 : 0.0);
+			RealType right = (right_slope[j] != 0) ? (d[j] - x) * right_slope[j] : ((x <= d[j]) ? 1.0 : 0.0);
+			RealType dom = (left < right) ? left : right;
+
+			dom = (dom > 1.0) ? 1.0 : dom;
+			dom_arr[j] = (dom < 0.0) ? 0.0 : dom;
+			}
+
+		} // end loop through input vars
+
+	// S-Curves can't be done in the loop above
+	for (i = 0; i < static_cast<int>(in_curve_set_arr.size()); i++)
+		{
+		int set_idx = in_curve_set_arr[i];
+		int var_idx = in_var_arr[set_idx];
+		RealType x = var_value_arr[var_idx];
+
+		if (x < var_left_arr[var_idx])
+			x = var_left_arr[var_idx];
+		if (x > var_right_arr[var_idx])
+			x = var_right_arr[var_idx];
+
+		dom_arr[set_idx] = calc_curve_dom(&curve_arr[in_sets.curve_idx[set_idx]], x);
+		}
+
+	for (i = 0; i < out_set_count; i++)
+		level_arr[i] = 0;
+
+	// collect the active sets for each var, if a var has none no rule can fire
+	int active_count = 0;
+
+	for (i = 0; i < var_count; i++)
+		{
+		active_start_arr[i] = active_count;
+
+		for (j = var_first_set_arr[i]; j < var_first_set_arr[i + 1]; j++)
+			{
+			if (dom_arr[j] > 0)
+				active_arr[active_count++] = j;
+			}
+
+		if (active_count == active_start_arr[i])
+			return defuzzify(level_arr);
+
+		} // end loop through input vars
+
+	active_start_arr[var_count] = active_count;
+
+	// checking a defined rule is a lot cheaper than looking up a combination of active
+	// sets in the rule array, so unless there are many more rules than combinations walk the rules
+	int			rule_count = static_cast<int>(rule_out_arr.size());
+	RealType	combination_count = 1;
+
+	for (i = 0; i < var_count && combination_count * 4 <= rule_count; i++)
+		combination_count *= active_start_arr[i + 1] - active_start_arr[i];
+
+	if (combination_count * 4 > rule_count)
+		{
+		const int* rule_set = rule_set_arr.empty() ? NULL : &rule_set_arr[0];
+
+		for (i = 0; i < rule_count; i++, rule_set += var_count)
+			{
+			RealType activation_level = dom_arr[rule_set[0]];
+
+			for (j = 1; j < var_count && activation_level > 0; j++)
+				{
+				RealType dom = dom_arr[rule_set[j]];
+
+				if (dom == 0)
+					activation_level = 0;	// every set must be active
+				else if (inference_min ? (dom < activation_level) : (dom > activation_level))
+					activation_level = dom;
+				}
+
+			if (activation_level == 0)
+				continue;
+
+			int			out_set = rule_out_arr[i];
+			RealType	current = level_arr[out_set];
+
+			if (current == 0 || (composition_min ? (activation_level < current) : (activation_level > current)))
+				level_arr[out_set] = activation_level;
+			}
+
+		return defuzzify(level_arr);
+
+		} // end if walking the rules
+
+	// walk the cross product of the active sets, like
+	// CompiledModel::fire_rules() does
+	int*		position_arr = scratch->position_arr;
+	int*		rule_index_arr = scratch->rule_index_arr;
+	RealType*	activation_arr = &scratch->real_activation_arr[0];
+	int			last_var = var_count - 1;
+	int			var_num = 0;	// variable we're on
+
+	position_arr[0] = active_start_arr[0];
+
+	while (1)
+		{
+		int			set_idx = active_arr[position_arr[var_num]];
+		RealType	activation_level = dom_arr[set_idx];
+		int			rule_index = in_rule_index_arr[set_idx];
+
+		if (var_num > 0)
+			{
+			RealType prev_level = activation_arr[var_num - 1];
+
+			if (inference_min ? (prev_level < activation_level) : (prev_level > activation_level))
+				activation_level = prev_level;
+
+			rule_index += rule_index_arr[var_num - 1];
+			}
+
+		if (var_num < last_var)
+			{
+			// save where we are and move on to the next variable
+			activation_arr[var_num] = activation_level;
+			rule_index_arr[var_num] = rule_index;
+
+			var_num++;
+			position_arr[var_num] = active_start_arr[var_num];
+
+			continue;
+			}
+
+		RuleArrayType out_set = rules->get_rule(rule_index);
+
+		if (out_set != NO_RULE && out_set < out_set_count)
+			{
+			RealType current = level_arr[out_set];
+
+			// same as CompiledModel::set_output_dom(), 0 means no rule has fired for the set
+			if (current == 0 || (composition_min ? (activation_level < current) : (activation_level > current)))
+				level_arr[out_set] = activation_level;
+			}
+
+		// move to the next active set, backing up to the previous
+		// variable(s) when we run out of sets
+		while (++position_arr[var_num] == active_start_arr[var_num + 1])
+			{
+			if (var_num == 0)
+				return defuzzify(level_arr);
+
+			var_num--;
+			}
+
+		} // end while(1)
+
+} // end AnalyticEngine::calc_output()
+
+//
+// Function:	defuzzify()
+//
+// Purpose:		Calculate the defuzzified output value from the activation
+//				level of each output set.
+//
+// Arguments:
+//
+//		const RealType* level_arr - activation level of each output set
+//
+// Returns:
+//
+//		RealType - the output value, FLT_MIN if no ouput set is active
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Added weighted average
+//
+//
+RealType AnalyticEngine::defuzzify(const RealType* level_arr) const
+{
+	int i;	// counter
+	int out_set_count = static_cast<int>(out_mom_arr.size());
+
+	if (use_mom)
+		{
+		// the set with the highest activation level wins
+		RealType	max_level = 0;
+		int			winner = -1;
+
+		for (i = 0; i < out_set_count; i++)
+			{
+			if (level_arr[i] > max_level)
+				{
+				max_level = level_arr[i];
+				winner = i;
+				}
+			}
+
+		return (winner < 0) ? FLT_MIN : out_mom_arr[winner];
+
+		} // end if MOM
+
+	if (use_wa)
+		{
+		RealType weight_sum = 0.0;	// sum of the activation levels
+		RealType moment_sum = 0.0;	// sum of the activation levels times the sets' positions
+
+		for (i = 0; i < out_set_count; i++)
+			{
+			weight_sum += level_arr[i];
+			moment_sum += level_arr[i] * out_mom_arr[i];
+			}
+
+		return (weight_sum > 0) ? moment_sum / weight_sum : FLT_MIN;
+
+		} // end if weighted average
+
+	RealType area_sum = 0.0;	// sum of the areas
+	RealType moment_sum = 0.0;	// sum of the moments
+	RealType divisor = 0.0;		// number of sets with an area
+
+	const RealType*	a = &out_sets.a[0];
+	const RealType*	b = &out_sets.b[0];
+	const RealType*	c = &out_sets.c[0];
+	const RealType*	d = &out_sets.d[0];
+	const RealType*	trap = &out_trap_arr[0];
+
+	// clipping a trapezoid at 'level' leaves a rising triangle from a to b', a
+	// rectangle from b' to c' and a falling triangle from c' to d. Sum the area 
+	// and moment of each. This is 0 for sets that aren't trapezoids.
+	for (i = 0; i < out_set_count; i++)
+		{
+		RealType level = level_arr[i] * trap[i];
+		RealType b_clip = a[i] + level * (b[i] - a[i]);
+		RealType c_clip = d[i] - level * (d[i] - c[i]);
+
+		RealType rise_area = level * (b_clip - a[i]) * 0.5;
+		RealType top_area = level * (c_clip - b_clip);
+		RealType fall_area = level * (d[i] - c_clip) * 0.5;
+		RealType area = rise_area + top_area + fall_area;
+
+		area_sum += area;
+		moment_sum += rise_area * (a[i] + (b_clip - a[i]) * (2.0 / 3.0)) 
+					+ top_area * ((b_clip + c_clip) * 0.5)
+					+ fall_area * (c_clip + (d[i] - c_clip) * (1.0 / 3.0));
+		divisor += (area > 0) ? 1.0 : 0.0;
+		}
+
+	// singletons and S-Curves
+	for (i = 0; i < out_set_count; i++)
+		{
+		if (trap[i] != 0 || level_arr[i] == 0)
+			continue;
+
+		RealType area, moment;
+
+		if (out_sets.shape[i] == SHAPE_S_CURVE)
+			calc_curve_area(&curve_arr[out_sets.curve_idx[i]], level_arr[i], &area, &moment);
+		else
+			{
+			area = level_arr[i];
+			moment = area * a[i];
+			}
+
+		if (area > 0)
+			{
+			area_sum += area;
+			moment_sum += moment;
+			divisor++;
+			}
+
+		} // end loop through sets
+
+	if (!divisor)
+		{
+		// if no output sets were active, return FLT_MIN - the special value that
+		// ensures we know that there is no output
+		return FLT_MIN;
+		}
+
+	return moment_sum / area_sum;
+
+} // end AnalyticEngine::defuzzify()
+
+//
+// Function:	calc_curve_dom()
+//
+// Purpose:		Calculate the DOM of an S-Curve at the value passed in. The curve
+//				is the same Catmull-Rom spline MemberFuncSCurve uses. For the segment 
+//				that contains the value we find the 't' where the curve's 'x' is the
+//				value (Newton's method, falling back to bisection) then the 'y' for 't'.
+//
+// Arguments:
+//
+//		const RealType*	curve	-	7 'x' values then 7 'y' values of the curve's nodes
+//		RealType		value	-	value to get the DOM for
+//
+// Returns:
+//
+//		RealType - DOM from 0 to 1
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+RealType AnalyticEngine::calc_curve_dom(const RealType* curve, RealType value)
+{
+	const RealType* node_x = curve;
+	const RealType* node_y = curve + 7;
+
+	if (value < node_x[0] || value > node_x[6])
+		return 0;
+
+	for (int seg = 0; seg < 6; seg++)
+		{
+		RealType x2 = node_x[seg];
+		RealType x3 = node_x[seg + 1];
+
+		if (x3 <= x2 || value < x2 || value > x3)
+			continue;	// not this segment
+
+		int p1 = (seg > 0) ? seg - 1 : 0;
+		int p4 = (seg < 5) ? seg + 2 : 6;
+
+		// see MemberFuncSCurve::calc_curve_values() for the equations
+		RealType ax = .5 * (-node_x[p1] + 3 * x2 - 3 * x3 + node_x[p4]);
+		RealType bx = .5 * (2 * node_x[p1] - 5 * x2 + 4 * x3 - node_x[p4]);
+		RealType cx = .5 * (-node_x[p1] + x3);
+
+		RealType lo = 0, hi = 1;
+		RealType t = (value - x2) / (x3 - x2);
+
+		for (int iter = 0; iter < 60; iter++)
+			{
+			RealType f = ((ax * t + bx) * t + cx) * t + x2 - value;
+
+			if (f == 0)
+				break;
+
+			// keep the root bracketed
+			if (f < 0)
+				lo = t;
+			else
+				hi = t;
+
+			RealType slope = (3 * ax * t + 2 * bx) * t + cx;
+			RealType next_t = (slope != 0) ? t - f / slope : -1;
+
+			if (next_t <= lo || next_t >= hi)
+				next_t = (lo + hi) * 0.5;
+
+			if (next_t == t || hi - lo < 1e-15)
+				break;
+
+			t = next_t;
+			}
+
+		RealType ay = .5 * (-node_y[p1] + 3 * node_y[seg] - 3 * node_y[seg + 1] + node_y[p4]);
+		RealType by = .5 * (2 * node_y[p1] - 5 * node_y[seg] + 4 * node_y[seg + 1] - node_y[p4]);
+		RealType cy = .5 * (-node_y[p1] + node_y[seg + 1]);
+
+		RealType y = ((ay * t + by) * t + cy) * t + node_y[seg];
+
+		if (y < 0)
+			y = 0;
+		if (y > 1)
+			y = 1;
+
+		return y;
+
+		} // end loop through segments
+
+	return 0;
+
+} // end AnalyticEngine::calc_curve_dom()
+
+//
+// Function:	calc_curve_area()
+//
+// Purpose:		Calculate the area and moment of an S-Curve clipped at the level
+//				passed in. There's no closed form for this so each segment is
+//				integrated with Gauss-Legendre quadrature.
+//
+// Arguments:
+//
+//		const RealType*	curve	-	7 'x' values then 7 'y' values of the curve's nodes
+//		RealType		level	-	activation level to clip the curve at
+//		RealType*		area	-	gets the area
+//		RealType*		moment	-	gets the moment
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void AnalyticEngine::calc_curve_area(const RealType* curve, RealType level, RealType* area, RealType* moment)
+{
+	// 4 point Gauss-Legendre on [-1, 1]
+	static const RealType gauss_t[4] = { -0.8611363115940526, -0.3399810435848563, 0.3399810435848563, 0.8611363115940526 };
+	static const RealType gauss_w[4] = { 0.3478548451374638, 0.6521451548625461, 0.6521451548625461, 0.3478548451374638 };
+	const int pieces = 16;	// number of pieces to split each segment into
+
+	const RealType* node_x = curve;
+	const RealType* node_y = curve + 7;
+
+	*area = *moment = 0;
+
+	for (int seg = 0; seg < 6; seg++)
+		{
+		if (node_x[seg + 1] <= node_x[seg])
+			continue;	// vertical segment, no area
+
+		int p1 = (seg > 0) ? seg - 1 : 0;
+		int p4 = (seg < 5) ? seg + 2 : 6;
+
+		RealType ax = .5 * (-node_x[p1] + 3 * node_x[seg] - 3 * node_x[seg + 1] + node_x[p4]);
+		RealType bx = .5 * (2 * node_x[p1] - 5 * node_x[seg] + 4 * node_x[seg + 1] - node_x[p4]);
+		RealType cx = .5 * (-node_x[p1] + node_x[seg + 1]);
+		RealType ay = .5 * (-node_y[p1] + 3 * node_y[seg] - 3 * node_y[seg + 1] + node_y[p4]);
+		RealType by = .5 * (2 * node_y[p1] - 5 * node_y[seg] + 4 * node_y[seg + 1] - node_y[p4]);
+		RealType cy = .5 * (-node_y[p1] + node_y[seg + 1]);
+
+		for (int piece = 0; piece < pieces; piece++)
+			{
+			for (int k = 0; k < 4; k++)
+				{
+				// map the Gauss point to 't' in this piece
+				RealType t = (piece + (gauss_t[k] + 1) * 0.5) / pieces;
+				RealType w = gauss_w[k] * 0.5 / pieces;
+
+				RealType x = ((ax * t + bx) * t + cx) * t + node_x[seg];
+				RealType dx = (3 * ax * t + 2 * bx) * t + cx;
+				RealType y = ((ay * t + by) * t + cy) * t + node_y[seg];
+
+				if (y < 0)
+					y = 0;
+				if (y > level)
+					y = level;
+
+				*area += w * y * dx;
+				*moment += w * y * dx * x;
+				}
+			}
+
+		} // end loop through segments
+
+} // end AnalyticEngine::calc_curve_area()
+
+/////////////////////////////////////////////////////////////////////
+////////// Trivial Functions That Don't Require Headers /////////////
+/////////////////////////////////////////////////////////////////////
+
+void AnalyticEngine::add_input_var(RealType left_x, RealType right_x)
+{
+	var_left_arr.push_back(left_x);
+	var_right_arr.push_back(right_x);
+
+	// the new var starts with no sets
+	var_first_set_arr.push_back(var_first_set_arr.back());
+	var_count++;
+};
+
+void AnalyticEngine::set_output_var(RealType left_x, RealType right_x)
+{
+	out_left_x = left_x;
+	out_right_x = right_x;
+};
@@ -0,0 +1,143 @@
+//
+// File:	AnalyticEngine.h
+//
+// Purpose:	Interface for the AnalyticEngine class. This class calculates the
+//			output of a model from the exact node values of the sets rather than
+//			the values[] arrays.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#ifndef _AnalyticEngine_H
+#define _AnalyticEngine_H
+
+#include "FFLLBase.h"
+#include <vector>
+
+class RuleArray;
+class InferenceScratch;
+
+//
+// Class:	AnalyticEngine
+//
+// Normally each membership function is sampled into a values[] array with
+// the variable's x_array_count elements and the DOM is an integer from 0 to
+// FuzzyVariableBase::dom_array_max_idx. This class evaluates the membership functions
+// in double precision from the exact values of their nodes (see MemberFuncBase::get_node_value())
+// so neither the input value nor the DOM is quantized:
+//
+//		Triangles/Trapezoids -	piecewise linear, the DOM is the lesser of the rising and
+//								falling edge (a triangle is a trapezoid with one peak node)
+//		Singletons			 -	1 at the singleton's value, 0 everywhere else
+//		S-Curves			 -	the same Catmull-Rom spline as MemberFuncSCurve, solved for
+//								the 't' that gives the input value
+//
+// The rules are fired the same way as CompiledModel::fire_rules() (only
+// combinations where every set has a non-zero DOM, in rule index order). Unless there are many
+// more defined rules than combinations of active sets, the defined rules are walked instead (like
+// BatchKernel does) so sparse rule bases with many inputs aren't slow. For COG each output
+// set is clipped at its activation level and treated as a point mass, like COGDefuzzSetObj.
+// The area and moment of clipped triangles/trapezoids are calculated in closed form, a
+// singleton's area is its activation level (so a model with singleton outputs gets the
+// weighted average) and S-Curves are integrated numerically. For MOM the output is the mean
+// of the maxima of the set with the highest activation level, like MOMDefuzzSetObj. For WA
+// it's the average of the sets' means of the maxima weighted by their activation levels,
+// like WADefuzzVarObj.
+//
+// The DOMs of the sets of a variable, and the areas/moments of the output sets, are kept in
+// separate arrays for each node so those loops don't branch and the compiler can vectorize them.
+//
+// The set's nodes are clamped to the variable's range, just like they are when the nodes are
+// converted to indexes, as are the input values.
+//
+// FuzzyModelBase fills in the model information (see FuzzyModelBase::init_analytic_engine()).
+// NOTE: the engine is not updated if the model changes.
+//
+
+class AnalyticEngine
+{
+	////////////////////////////////////////
+	////////// Member Functions ////////////
+	////////////////////////////////////////
+
+	public:
+
+		// constructor/destructor funcs
+		AnalyticEngine();
+		virtual ~AnalyticEngine();
+
+		// set functions
+		void add_input_var(RealType left_x, RealType right_x);
+		void set_output_var(RealType left_x, RealType right_x);
+		void add_set(int var_idx, int func_type, int node_count, const RealType* x, const RealType* y, int rule_index);
+		void add_rule(int rule_index, int out_set);
+
+		// misc functions
+		RealType calc_output(const RealType* var_value_arr, InferenceScratch* scratch) const;
+
+	private:
+
+		// don't allow copies. No function bodies for these.
+		AnalyticEngine(const AnalyticEngine& copy_from);
+		AnalyticEngine& operator=(const AnalyticEngine& copy_from);
+
+		// misc functions
+		RealType defuzzify(const RealType* level_arr) const;
+		static RealType calc_curve_dom(const RealType* curve, RealType value);
+		static void calc_curve_area(const RealType* curve, RealType level, RealType* area, RealType* moment);
+
+	////////////////////////////////////////
+	////////// Class Variables /////////////
+	////////////////////////////////////////
+
+	public:
+
+		enum SHAPE { SHAPE_TRAPEZOID, SHAPE_SINGLETON, SHAPE_S_CURVE };
+
+		// model information
+		bool					inference_min;		// true for MIN inference, false for MAX
+		bool					composition_min;	// true for MIN composition, false for MAX
+		bool					use_mom;			// true for MOM defuzzification
+		bool					use_wa;				// true for weighted average defuzzification (COG if neither is set)
+		const RuleArray*		rules;				// model's rules
+
+	private:
+
+		// a set, the trapezoid's nodes are a <= b <= c <= d (for a triangle b == c)
+		typedef struct _set_arr_
+			{
+			std::vector<RealType>	a;			// left foot
+			std::vector<RealType>	b;			// left shoulder
+			std::vector<RealType>	c;			// right shoulder
+			std::vector<RealType>	d;			// right foot
+			std::vector<RealType>	left_slope;	// 1/(b - a), 0 if the left edge is vertical
+			std::vector<RealType>	right_slope;// 1/(d - c), 0 if the right edge is vertical
+			std::vector<int>		shape;		// SHAPE of each set
+			std::vector<int>		curve_idx;	// index into curve_arr of the S-Curve's nodes, -1 if not an S-Curve
+			} _set_arr;
+
+		int						var_count;			// number of input variables
+		std::vector<RealType>	var_left_arr;		// left x value of each input var
+		std::vector<RealType>	var_right_arr;		// right x value of each input var
+		std::vector<int>		var_first_set_arr;	// index of each input var's first set in in_sets (var_count + 1 elements)
+		_set_arr				in_sets;			// the sets of var 0 then var 1...
+		std::vector<int>		in_rule_index_arr;	// rule index of each input set
+		std::vector<int>		in_var_arr;			// input var each input set belongs to
+		std::vector<int>		in_curve_set_arr;	// input sets that are S-Curves
+		_set_arr				out_sets;			// the output variable's sets
+		std::vector<RealType>	out_trap_arr;		// 1 for each output set that's a triangle/trapezoid, 0 for others
+		std::vector<RealType>	out_mom_arr;		// mean of the maxima of each output set
+		RealType				out_left_x;			// left x value of the output var
+		RealType				out_right_x;		// right x value of the output var
+		std::vector<RealType>	curve_arr;			// 7 'x' values then 7 'y' values for each S-Curve
+		std::vector<int>		rule_set_arr;		// for each defined rule, the input set (index into in_sets) for each input var
+		std::vector<int>		rule_out_arr;		// for each defined rule, the output set
+
+}; // end class AnalyticEngine
+
+#else
+
+class AnalyticEngine;
+
+#endif // _AnalyticEngine_H
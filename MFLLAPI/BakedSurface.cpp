@@ -0,0 +1,259 @@
+//
+// File:	BakedSurface.cpp
+//
+// Purpose:	Implementation of the BakedSurface class. This class holds the output
+//			value of a model for every combination of input indexes.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#include "BakedSurface.h"
+#include <float.h>
+
+#ifdef _DEBUG
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+
+#include "debug.h"
+
+#endif
+
+//
+// Function:	BakedSurface()
+//
+// Purpose:		Constructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+BakedSurface::BakedSurface()
+{
+	table = NULL;
+	x_count_arr = NULL;
+	var_count = entry_count = 0;
+	interpolate = false;
+
+}; // end BakedSurface::BakedSurface()
+
+//
+// Function:	~BakedSurface()
+//
+// Purpose:		Destructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+BakedSurface::~BakedSurface()
+{
+	delete[] table;
+	delete[] x_count_arr;
+
+}; // end BakedSurface::~BakedSurface()
+
+//
+// Function:	alloc()
+//
+// Purpose:		Allocate the table for the number of input variables and indexes
+//				passed in.
+//
+// Arguments:
+//
+//		int _var_count - number of input variables in the model
+//		const int* _x_count_arr - for each input variable, the number of indexes
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure (the table would have more than MFLL_BAKE_MAX_ENTRIES
+//				   entries or we couldn't allocate it)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int BakedSurface::alloc(int _var_count, const int* _x_count_arr)
+{
+	int i;			// counter
+	int count = 1;
+
+	if (_var_count <= 0)
+		return -1;
+
+	for (i = 0; i < _var_count; i++)
+		{
+		if (_x_count_arr[i] <= 0)
+			return -1;
+
+		if (count > MFLL_BAKE_MAX_ENTRIES / _x_count_arr[i])
+			return -1; // too big
+
+		count *= _x_count_arr[i];
+		}
+
+	delete[] table;
+	delete[] x_count_arr;
+
+	table = new RealType[count];
+	x_count_arr = new int[_var_count];
+
+	if (table == NULL || x_count_arr == NULL)
+		{
+		var_count = entry_count = 0;
+		return -1;
+		}
+
+	for (i = 0; i < _var_count; i++)
+		x_count_arr[i] = _x_count_arr[i];
+
+	var_count = _var_count;
+	entry_count = count;
+
+	return 0;
+
+} // end BakedSurface::alloc()
+
+//
+// Function:	get_value()
+//
+// Purpose:		Get the output value for the input indexes passed in.
+//
+// Arguments:
+//
+//		const short* var_idx_arr - index into the values[] array for each input var
+//
+// Returns:
+//
+//		RealType - the output value, FLT_MIN if no output set is active
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+RealType BakedSurface::get_value(const short* var_idx_arr) const
+{
+	int entry = 0;
+
+	for (int i = 0; i < var_count; i++)
+		entry = entry * x_count_arr[i] + var_idx_arr[i];
+
+	return table[entry];
+
+} // end BakedSurface::get_value()
+
+//
+// Function:	get_interpolated_value()
+//
+// Purpose:		Get the output value for the input positions passed in by multilinear
+//				interpolation between the indexes on either side of each position.
+//				If any of the surrounding entries has no output (FLT_MIN) we can't
+//				interpolate so the entry at the nearest indexes is returned.
+//
+// Arguments:
+//
+//		const RealType* var_pos_arr - position in the values[] array for each input var.
+//									  This is the index before it's rounded (0 to x_count_arr[N] - 1)
+//
+// Returns:
+//
+//		RealType - the output value, FLT_MIN if no output set is active
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+RealType BakedSurface::get_interpolated_value(const RealType* var_pos_arr) const
+{
+	int			i;				// counter
+	int			nearest = 0;	// entry for the nearest indexes
+	int			base = 0;		// entry for the indexes below each position
+	RealType	sum = 0;		// weighted sum of the surrounding entries
+
+	for (i = 0; i < var_count; i++)
+		{
+		int lo = static_cast<int>(var_pos_arr[i]);
+
+		nearest = nearest * x_count_arr[i] + static_cast<int>(var_pos_arr[i] + .5);
+		base = base * x_count_arr[i] + lo;
+		}
+
+	// visit each corner of the cell around the position. Bit N of the corner
+	// tells us if we use the index above (1) or below (0) the position of var N
+	int corner_count = 1 << var_count;
+
+	for (int corner = 0; corner < corner_count; corner++)
+		{
+		RealType	weight = 1;
+		int			entry = 0;
+		int			stride = 1;
+
+		for (i = var_count - 1; i >= 0; i--, stride *= x_count_arr[i])
+			{
+			int			lo = static_cast<int>(var_pos_arr[i]);
+			RealType	frac = var_pos_arr[i] - lo;
+
+			if (corner & (1 << i))
+				{
+				weight *= frac;
+
+				if (lo < x_count_arr[i] - 1)
+					entry += stride;
+				}
+			else
+				weight *= (1 - frac);
+
+			} // end loop through vars
+
+		if (weight == 0)
+			continue;	// this corner doesn't contribute
+
+		RealType value = table[base + entry];
+
+		if (value == FLT_MIN)
+			return table[nearest];	// no output here, can't interpolate
+
+		sum += weight * value;
+
+		} // end loop through corners
+
+	return sum;
+
+} // end BakedSurface::get_interpolated_value()
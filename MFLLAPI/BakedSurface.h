@@ -0,0 +1,78 @@
+//
+// File:	BakedSurface.h
+//
+// Purpose:	Interface for the BakedSurface class. This class holds the output
+//			value of a model for every combination of input indexes.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#ifndef _BakedSurface_H
+#define _BakedSurface_H
+
+#include "FFLLBase.h"
+
+// largest number of entries we'll bake, enough for 3 input variables
+// with the default x_array_count (201 x 201 x 201)
+#define MFLL_BAKE_MAX_ENTRIES	8388608
+
+//
+// Class:	BakedSurface
+//
+// The inputs of a model are quantized to their variable's x_array_count indexes so
+// the output of a model with only a few input variables has a finite number of values.
+// FuzzyModelBase::bake() calculates all of them once and stores them in this object
+// so the output for an input is a single look-up regardless of the number of rules.
+//
+// The table is stored like the rules array, the last variable changes fastest.
+// Optionally, the output can be interpolated (multilinear) between the indexes
+// either side of the crisp input values rather than using the nearest index.
+//
+// NOTE: the table is a snapshot, it's not updated if the model changes after it's baked.
+//
+
+class BakedSurface
+{
+	////////////////////////////////////////
+	////////// Member Functions ////////////
+	////////////////////////////////////////
+
+	public:
+
+		// constructor/destructor funcs
+		BakedSurface();
+		virtual ~BakedSurface();
+
+		// get functions
+		RealType get_value(const short* var_idx_arr) const;
+		RealType get_interpolated_value(const RealType* var_pos_arr) const;
+
+		// misc functions
+		int alloc(int _var_count, const int* _x_count_arr);
+
+	private:
+
+		// don't allow copies. No function bodies for these.
+		BakedSurface(const BakedSurface& copy_from);
+		BakedSurface& operator=(const BakedSurface& copy_from);
+
+	////////////////////////////////////////
+	////////// Class Variables /////////////
+	////////////////////////////////////////
+
+	public:
+
+		RealType*	table;			// output value for each combination of input indexes (FLT_MIN if no output)
+		int			var_count;		// number of input variables
+		int*		x_count_arr;	// for each input variable, the number of indexes
+		int			entry_count;	// number of entries in the table
+		bool		interpolate;	// if true, interpolate between indexes rather than using the nearest one
+
+}; // end class BakedSurface
+
+#else
+
+class BakedSurface;
+
+#endif // _BakedSurface_H
@@ -0,0 +1,367 @@
+//
+// File:	BatchKernel.cpp
+//
+// Purpose:	Implementation of the BatchKernel class. This class calculates the
+//			output of a model for several input samples at once using AVX2.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#include "BatchKernel.h"
+#include "CompiledModel.h"
+#include <float.h>
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+
+#ifdef _DEBUG
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+
+#include "debug.h"
+
+#endif
+
+//
+// Function:	BatchKernel()
+//
+// Purpose:		Constructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+BatchKernel::BatchKernel()
+{
+	var_count = out_set_count = rule_count = set_count = 0;
+	inference_min = composition_min = true;
+	use_cog = false;
+	left_x = 0;
+	model = NULL;
+
+}; // end BatchKernel::BatchKernel()
+
+//
+// Function:	~BatchKernel()
+//
+// Purpose:		Destructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+BatchKernel::~BatchKernel()
+{
+}; // end BatchKernel::~BatchKernel()
+
+//
+// Function:	is_supported()
+//
+// Purpose:		Find out if the CPU (and OS) support AVX2. This is only
+//				checked once, the first call checks (see check_supported())
+//				and any other thread calling at the same time waits for it.
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		true - calc_block() can be used
+//		false - use the scalar kernel
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Initialize the flag once, safely from any thread
+//
+//
+bool BatchKernel::is_supported()
+{
+	static const bool supported = check_supported();
+
+	return supported;
+
+} // end BatchKernel::is_supported()
+
+//
+// Function:	check_supported()
+//
+// Purpose:		Ask the CPU (and OS) if they support AVX2.
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		true - AVX2 is supported
+//		false - it isn't
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+bool BatchKernel::check_supported()
+{
+	int supported = 0;
+
+#if defined(_MSC_VER)
+	int info[4];	// eax, ebx, ecx, edx
+
+	__cpuid(info, 0);
+
+	if (info[0] >= 7)
+		{
+		__cpuid(info, 1);
+
+		// the CPU must support AVX and the OS must save the YMM registers
+		bool avx = ((info[2] & (1 << 27)) != 0) && ((info[2] & (1 << 28)) != 0);
+
+		if (avx && ((_xgetbv(0) & 6) == 6))
+			{
+			__cpuidex(info, 7, 0);
+
+			if (info[1] & (1 << 5))
+				supported = 1;
+			}
+		}
+#elif defined(__GNUC__)
+	__builtin_cpu_init();
+
+	supported = __builtin_cpu_supports("avx2") ? 1 : 0;
+#endif
+
+	return (supported != 0);
+
+} // end BatchKernel::check_supported()
+
+//
+// Function:	alloc()
+//
+// Purpose:		Allocate the working memory once the model information
+//				has been filled in.
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void BatchKernel::alloc()
+{
+	dom_block.resize(set_count * LANES + 1);
+	out_dom_block.resize(out_set_count * LANES + 1);
+	out_set_dom_arr.resize(out_set_count + 1);
+
+} // end BatchKernel::alloc()
+
+//
+// Function:	calc_block()
+//
+// Purpose:		Calculate the output for LANES samples.
+//
+// Arguments:
+//
+//		const int*	var_idx_block	-	index into the values[] array for each input var for each
+//										sample. The LANES indexes for var 0 come first, then var 1...
+//		RealType*	outputs			-	array of LANES elements that gets the output values
+//										(FLT_MIN for any sample where no output set is active)
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+MFLL_TARGET_AVX2 void BatchKernel::calc_block(const int* var_idx_block, RealType* outputs)
+{
+	int		i, j;	// counters
+	int*	dom = &dom_block[0];
+	int*	out_dom = &out_dom_block[0];
+
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i dom_mask = _mm256_set1_epi32(0xFF);
+
+	// get the DOM of every input set for each sample...
+	for (i = 0; i < var_count; i++)
+		{
+		int first_set = var_first_set_arr[i];
+		int last_set = (i + 1 < var_count) ? var_first_set_arr[i + 1] : set_count;
+
+		// offset of each sample's row in the var's DOM table
+		__m256i x_idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(var_idx_block + i * LANES));
+		__m256i row = _mm256_mullo_epi32(x_idx, _mm256_set1_epi32(last_set - first_set));
+
+		for (j = first_set; j < last_set; j++)
+			{
+			const int* column = reinterpret_cast<const int*>(var_dom_table_arr[i] + (j - first_set));
+
+			// this reads the DOMs of the next sets too, keep just this set's
+			__m256i set_dom = _mm256_and_si256(_mm256_i32gather_epi32(column, row, 1), dom_mask);
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dom + j * LANES), set_dom);
+			}
+
+		} // end loop through input vars
+
+	for (i = 0; i < out_set_count * LANES; i++)
+		out_dom[i] = 0;
+
+	// fire the rules in rule index order...
+	const int* rule_set = rule_set_arr.empty() ? NULL : &rule_set_arr[0];
+
+	for (i = 0; i < rule_count; i++, rule_set += var_count)
+		{
+		__m256i set_dom = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dom + rule_set[0] * LANES));
+		__m256i lowest = set_dom;		// lowest DOM, the rule only fires if all the DOMs are non-zero
+		__m256i activation = set_dom;	// activation level
+
+		for (j = 1; j < var_count; j++)
+			{
+			set_dom = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dom + rule_set[j] * LANES));
+
+			lowest = _mm256_min_epi32(lowest, set_dom);
+
+			if (!inference_min)
+				activation = _mm256_max_epi32(activation, set_dom);
+			}
+
+		if (inference_min)
+			activation = lowest;
+
+		__m256i active = _mm256_cmpgt_epi32(lowest, zero);
+
+		if (_mm256_testz_si256(active, active))
+			continue;	// the rule doesn't fire for any sample
+
+		// SUB 1 from activation level cuz that's from 0 to MAX_DOM and
+		// we're setting an INDEX (see CompiledModel::set_output_dom())
+		__m256i new_dom = _mm256_sub_epi32(activation, one);
+
+		__m256i* out_ptr = reinterpret_cast<__m256i*>(out_dom + rule_out_arr[i] * LANES);
+		__m256i current = _mm256_loadu_si256(out_ptr);
+		__m256i candidate;
+
+		if (composition_min)
+			{
+			// take the new DOM if the current one is 0, otherwise the lower one
+			candidate = _mm256_blendv_epi8(_mm256_min_epi32(current, new_dom), new_dom, _mm256_cmpeq_epi32(current, zero));
+			}
+		else
+			candidate = _mm256_max_epi32(current, new_dom);
+
+		_mm256_storeu_si256(out_ptr, _mm256_blendv_epi8(current, candidate, active));
+
+		} // end loop through rules
+
+	if (!use_cog)
+		{
+		// defuzzify one sample at a time
+		for (j = 0; j < LANES; j++)
+			{
+			for (i = 0; i < out_set_count; i++)
+				out_set_dom_arr[i] = out_dom[i * LANES + j];
+
+			outputs[j] = model->defuzzify(&out_set_dom_arr[0]);
+			}
+
+		return;
+
+		} // end if not COG
+
+	// COG, sum the areas and moments 4 samples at a time (see COGDefuzzVarObj::calc_value())
+	const __m256d	zero_pd = _mm256_setzero_pd();
+	const __m256d	one_pd = _mm256_set1_pd(1.0);
+
+	for (j = 0; j < LANES; j += 4)
+		{
+		__m256d area_sum = zero_pd;
+		__m256d moment_sum = zero_pd;
+		__m256d divisor = zero_pd;
+
+		for (i = 0; i < out_set_count; i++)
+			{
+			if (cog_arr[i] == NULL)
+				continue;	// nothing to calc for this set
+
+			__m128i cog_idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(out_dom + i * LANES + j));
+
+			// the area and moment are pairs so double the index
+			cog_idx = _mm_slli_epi32(cog_idx, 1);
+
+			__m256d area = _mm256_i32gather_pd(cog_arr[i], cog_idx, 8);
+			__m256d moment = _mm256_i32gather_pd(cog_arr[i] + 1, cog_idx, 8);
+			__m256d has_area = _mm256_cmp_pd(area, zero_pd, _CMP_NEQ_OQ);
+
+			area_sum = _mm256_add_pd(area_sum, _mm256_and_pd(area, has_area));
+			moment_sum = _mm256_add_pd(moment_sum, _mm256_and_pd(moment, has_area));
+			divisor = _mm256_add_pd(divisor, _mm256_and_pd(one_pd, has_area));
+
+			} // end loop thru sets
+
+		// be sure to account for the left x (start of the var)
+		__m256d result = _mm256_add_pd(_mm256_set1_pd(left_x), _mm256_div_pd(moment_sum, area_sum));
+
+		// if no output sets were active, return FLT_MIN - the special value that
+		// ensures we know that there is no output
+		__m256d no_output = _mm256_cmp_pd(divisor, zero_pd, _CMP_EQ_OQ);
+
+		result = _mm256_blendv_pd(result, _mm256_set1_pd(FLT_MIN), no_output);
+
+		_mm256_storeu_pd(outputs + j, result);
+
+		} // end loop through samples
+
+} // end BatchKernel::calc_block()
@@ -0,0 +1,111 @@
+//
+// File:	BatchKernel.h
+//
+// Purpose:	Interface for the BatchKernel class. This class calculates the
+//			output of a model for several input samples at once using AVX2.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#ifndef _BatchKernel_H
+#define _BatchKernel_H
+
+#include "FFLLBase.h"
+#include <vector>
+
+class CompiledModel;
+
+// functions that use AVX2 instructions must be marked so GCC/Clang generate them
+// without compiling the whole file with -mavx2. MSVC allows the intrinsics anywhere.
+#if defined(__GNUC__)
+#	define MFLL_TARGET_AVX2	__attribute__((target("avx2")))
+#else
+#	define MFLL_TARGET_AVX2
+#endif
+
+//
+// Class:	BatchKernel
+//
+// Vectorized inference for FuzzyModelBase::calc_output_batch(). Each AVX2 register holds
+// the same value for LANES input samples. The DOMs of every input set are gathered from
+// the variables' DOM tables, then each defined rule is fired for all the samples at once
+// (the AND is a MIN/MAX across the variables and the composition a masked MIN/MAX into the
+// output set's DOM). The rules are fired in increasing rule index order so the output DOMs
+// are exactly the same as the scalar kernel's. For COG the areas and moments are gathered
+// and summed vector-wide too, other defuzzification methods are done one sample at a time.
+//
+// The compiled model fills in the model information (see CompiledModel::init_batch_kernel()).
+// It refuses to for models with many rules and few active sets, where walking the active
+// sets one sample at a time is faster than firing every rule.
+// calc_block() must only be called if is_supported() returns true.
+//
+// NOTE: AVX2 can only gather 32 bit values so the kernel reads 32 bits at each DOM
+// and masks off the other sets' DOMs. The DOM tables are padded so this doesn't read
+// past the end (see FuzzyVariableBase::pack_sets()).
+//
+
+class BatchKernel
+{
+	////////////////////////////////////////
+	////////// Member Functions ////////////
+	////////////////////////////////////////
+
+	public:
+
+		enum { LANES = 8 };	// number of samples calculated at once
+
+		// constructor/destructor funcs
+		BatchKernel();
+		virtual ~BatchKernel();
+
+		// misc functions
+		static bool is_supported();
+		void alloc();
+		MFLL_TARGET_AVX2 void calc_block(const int* var_idx_block, RealType* outputs);
+
+	private:
+
+		// don't allow copies. No function bodies for these.
+		BatchKernel(const BatchKernel& copy_from);
+		BatchKernel& operator=(const BatchKernel& copy_from);
+
+		// misc functions
+		static bool check_supported();
+
+	////////////////////////////////////////
+	////////// Class Variables /////////////
+	////////////////////////////////////////
+
+	public:
+
+		// model information
+		int							var_count;			// number of input variables
+		int							out_set_count;		// number of sets in the output variable
+		int							rule_count;			// number of rules that are defined
+		bool						inference_min;		// true for MIN inference, false for MAX
+		bool						composition_min;	// true for MIN composition, false for MAX
+		int							set_count;			// number of input sets, the sets of var 0 then var 1...
+		std::vector<const PackedDOMType*> var_dom_table_arr;	// for each input var, its DOM table (see CompiledModel)
+		std::vector<int>			var_first_set_arr;	// for each input var, index of its first set
+		std::vector<int>			rule_set_arr;		// for each rule, the index of the set for each input var
+		std::vector<int>			rule_out_arr;		// for each rule, the output set
+		bool						use_cog;			// true if the COG areas/moments are summed vector-wide
+		std::vector<const RealType*> cog_arr;			// for each output set, its COG area/moment pairs (NULL if it has none)
+		RealType					left_x;				// left x value of the output variable
+		const CompiledModel*		model;				// used to defuzzify one sample at a time if not use_cog
+
+	private:
+
+		// working memory
+		std::vector<int>			dom_block;			// DOM of each input set for each sample
+		std::vector<int>			out_dom_block;		// DOM of each output set for each sample
+		std::vector<DOMType>		out_set_dom_arr;	// DOM of each output set for one sample
+
+}; // end class BatchKernel
+
+#else
+
+class BatchKernel;
+
+#endif // _BatchKernel_H
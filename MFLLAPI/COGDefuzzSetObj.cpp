@@ -13,6 +13,7 @@
 #include "COGDefuzzSetObj.h"
 #include "FuzzyOutSet.h"
 #include "FuzzyOutVariable.h"
+#include <vector>
 
 #ifdef _DEBUG
 #undef THIS_FILE
@@ -138,9 +139,11 @@ int COGDefuzzSetObj::init(int array_max)
 // Date:	8/01
 // 
 // Modification History
-// Author		Date		Modification
-// ------		----		------------
-// Michael Z	4/03		removed adding min_x to set_moment()	
+// Author			Date		Modification
+// ------			----		------------
+// Michael Z		4/03		removed adding min_x to set_moment()	
+// Ming-Kai Jiau	2026/10/16	Build the table from running sums of a histogram of
+//								the set's DOMs rather than walking the set for every DOM
 //
  
 
@@ -153,8 +156,11 @@ void COGDefuzzSetObj::calc()
 							// everywhere else but that gets confising here cuz
 							// we're looping through the doms
 	RealType area_sum;		// area sum 
-	RealType area;			// area 
 	RealType moment_sum;	// sum of the moments
+	RealType below_area;	// area of the indexes with a 'y' below dom_idx
+	RealType below_moment;	// moment of the indexes with a 'y' below dom_idx
+	RealType above_count;	// number of indexes with a 'y' of dom_idx or more
+	RealType above_x_sum;	// sum of the indexes with a 'y' of dom_idx or more
 
 	// get the min val and idx_multiplier for the var...
 
@@ -191,35 +197,50 @@ void COGDefuzzSetObj::calc()
 	//                    |                     |
  	//                 start_idx            end_idx
 	//
+	// Rather than walking the curve for every dom_idx, we make one pass to count
+	// the indexes (and sum their 'x' positions) for each 'y' value. For a dom_idx
+	// the indexes with a 'y' below it add their own area/moment and the rest add
+	// dom_idx each, so walking up the doms and moving each 'y' value's indexes
+	// "below" as we pass it gives every area and moment from running sums.
+	// Everything summed is a whole number so the table is exactly the same as
+	// adding up each index.
+	//
 
-	// loop through all the doms
-	for (dom_idx = 0; dom_idx < FuzzyVariableBase::get_dom_array_count(); dom_idx++)
+	int dom_count = FuzzyVariableBase::get_dom_array_count();
+
+	std::vector<RealType> count_arr(dom_count, 0.0);	// number of indexes with each 'y' value
+	std::vector<RealType> x_sum_arr(dom_count, 0.0);	// sum of the indexes with each 'y' value
+
+	above_count = 0.0;
+	above_x_sum = 0.0;
+
+	// go through the DOMs for the curve 
+	for (x_idx = start_idx; x_idx <= end_idx; x_idx++)
 		{
-		// init area and moment for this dom
-		area_sum = 0.0;
-		moment_sum = 0.0;
+		// get the DOM for this 'x' value
+		y = set_base->get_dom(x_idx);
 
-		// go through the DOMs for the curve 
-		for (x_idx = start_idx; x_idx <= end_idx; x_idx++)
-			{
-			// get the DOM for this 'x' value
-			y = set_base->get_dom(x_idx);
+		if (y >= dom_count)
+			y = dom_count - 1;
 
-			// use the LESSER of the 'y' value for this 'x' position or
-			// the dom we're checking
+		count_arr[y] += 1.0;
+		x_sum_arr[y] += x_idx;
 
- 			if (y > dom_idx)
-				 area = dom_idx;
-			else
-				 area = y;
+		above_count += 1.0;
+		above_x_sum += x_idx;
 
-			// add the area to the accumulator
- 			area_sum += area;
+		} // end loop through curve
 
-			// add the moment to the accumulator
-			moment_sum += (RealType)x_idx * area;
+	below_area = 0.0;
+	below_moment = 0.0;
 
-			} // end loop through curve
+	// loop through all the doms
+	for (dom_idx = 0; dom_idx < dom_count; dom_idx++)
+		{
+		// use the LESSER of the 'y' value for each 'x' position or
+		// the dom we're checking
+		area_sum = below_area + dom_idx * above_count;
+		moment_sum = below_moment + dom_idx * above_x_sum;
 
 		set_area(dom_idx, area_sum);
  
@@ -232,6 +253,12 @@ void COGDefuzzSetObj::calc()
 		
 		set_moment(dom_idx, (moment_sum * idx_mult ));
 
+		// the indexes at this 'y' are below the next dom
+		below_area += dom_idx * count_arr[dom_idx];
+		below_moment += dom_idx * x_sum_arr[dom_idx];
+		above_count -= count_arr[dom_idx];
+		above_x_sum -= x_sum_arr[dom_idx];
+
 		} // end loop through DOM
 
 } // end COGDefuzzSetObj::calc()
@@ -297,6 +324,12 @@ RealType COGDefuzzSetObj::get_moment(int _idx) const
 {
 	return values[_idx].moment;
 };
+const RealType* COGDefuzzSetObj::get_area_moment_arr() const
+{
+	// the area and moment for each DOM are next to each other
+	// so element (dom * 2) is the area and (dom * 2 + 1) the moment
+	return &(values[0].area);
+};
 void COGDefuzzSetObj::set_area(int _idx, RealType val)
 {  
 	values[_idx].area = val;
@@ -40,6 +40,7 @@ class   COGDefuzzSetObj : public DefuzzSetObj
 		int get_defuzz_type() const;
  		RealType get_area(int _idx) const;
 		RealType get_moment(int _idx) const;
+		const RealType* get_area_moment_arr() const;
 		RealType get_defuzz_x(int dom);
 
 		// set functions
@@ -183,18 +183,21 @@ RealType COGDefuzzVarObj::calc_value(DOMType* out_set_dom_arr  )
 // Date:	8/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
-//
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Don't dynamic_cast the set or its defuzzification object
 //		
 COGDefuzzSetObj* COGDefuzzVarObj::get_set_defuzz_obj(int set_idx) const
 {
-	FuzzyOutVariable* parent = get_parent();
-	FuzzyOutSet* set = parent->get_set(set_idx);
+	// FuzzyOutVariable::get_set() does a dynamic_cast, the base class's get_set()
+	// and the set's virtual get_defuzz_obj() don't need one
+	DefuzzSetObj* tmp_obj = get_parent()->FuzzyVariableBase::get_set(set_idx)->get_defuzz_obj();
 
-	COGDefuzzSetObj* tmp_obj = dynamic_cast<COGDefuzzSetObj*>(set->get_defuzz_obj()); 
-	
-	return tmp_obj;
+	// the sets always use the variable's defuzzification method (see
+	// FuzzyOutVariable::set_defuzz_method()) so this is the right type
+	assert(tmp_obj == NULL || tmp_obj->get_defuzz_type() == DefuzzVarObj::DEFUZZ_COG);
+
+	return static_cast<COGDefuzzSetObj*>(tmp_obj);
 
 } // end COGDefuzzVarObj::get_set_defuzz_obj()
 
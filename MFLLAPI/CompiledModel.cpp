@@ -0,0 +1,1609 @@
+//
+// File:	CompiledModel.cpp
+//
+// Purpose:	Implementation of the CompiledModel class. This class holds everything
+//			needed to calculate the output of a model in one block of memory.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#include "CompiledModel.h"
+#include "InferenceScratch.h"
+#include "BatchKernel.h"
+#include "DefuzzVarObj.h"
+#include "RuleArray.h"
+#include "MappedFile.h"
+#include <float.h>
+#include <limits.h>
+#include <string.h>
+#include <algorithm>
+
+#ifdef _DEBUG
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+
+#include "debug.h"
+
+#endif
+
+// every section of the block starts on a multiple of this
+static const size_t SECTION_ALIGN = 8;
+
+// compiled model files start with this...
+static const char FILE_MAGIC[4] = { 'M', 'F', 'L', 'C' };
+
+// ...and this, change it whenever the layout of the block changes
+static const int FILE_VERSION = 1;
+
+// the file has the byte order of the machine that wrote it
+static const int FILE_BYTE_ORDER = 0x01020304;
+
+// fixed cost of a sample in calc_output() (looking up the active sets, clearing
+// the output DOMs...) in rule combinations, see choose_batch_kernel()
+static const double SCALAR_OVERHEAD_COMBOS = 16.0;
+
+//
+// Function:	align_offset()
+//
+// Purpose:		Round an offset up to the start of the next section
+//
+// Arguments:
+//
+//		size_t offset - offset to round up
+//
+// Returns:
+//
+//		size_t - the rounded offset
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+static size_t align_offset(size_t offset)
+{
+	return (offset + SECTION_ALIGN - 1) & ~(SECTION_ALIGN - 1);
+
+} // end align_offset()
+
+//
+// Function:	section_fits()
+//
+// Purpose:		Check a section of a block we're loading is inside the block
+//
+// Arguments:
+//
+//		size_t				length		-	size of the block
+//		int					offset		-	offset of the section
+//		unsigned long long	count		-	number of elements in the section
+//		size_t				elem_size	-	size of each element
+//
+// Returns:
+//
+//		bool - true if the section is aligned and ends within the block
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+static bool section_fits(size_t length, int offset, unsigned long long count, size_t elem_size)
+{
+	if (offset < 0 || static_cast<size_t>(offset) > length || (offset % SECTION_ALIGN) != 0)
+		return false;
+
+	return (count <= (length - offset) / elem_size);
+
+} // end section_fits()
+
+//
+// Function:	build_crc_table()
+//
+// Purpose:		Fill in the CRC-32 of each byte value for calc_checksum()
+//
+// Arguments:
+//
+//		unsigned int* table - 256 element table to fill in
+//
+// Returns:
+//
+//		bool - true
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+static bool build_crc_table(unsigned int* table)
+{
+	for (unsigned int i = 0; i < 256; i++)
+		{
+		unsigned int crc = i;
+
+		for (int bit = 0; bit < 8; bit++)
+			crc = (crc & 1) ? (0xEDB88320 ^ (crc >> 1)) : (crc >> 1);
+
+		table[i] = crc;
+		}
+
+	return true;
+
+} // end build_crc_table()
+
+//
+// Function:	CompiledModel()
+//
+// Purpose:		Constructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Initialize the mapped file
+// Ming-Kai Jiau	2026/10/16	Initialize batch_kernel_faster
+//
+//
+CompiledModel::CompiledModel()
+{
+	block = NULL;
+	header = NULL;
+	mapped_file = NULL;
+	batch_kernel_faster = false;
+
+	memset(&build_header, 0, sizeof(build_header));
+
+	build_header.inference_min = 1;
+	build_header.defuzz_method = -1;	// no output var yet
+
+}; // end CompiledModel::CompiledModel()
+
+//
+// Function:	~CompiledModel()
+//
+// Purpose:		Destructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Unmap the block if it's in a mapped file
+//
+//
+CompiledModel::~CompiledModel()
+{
+	free_block();
+
+}; // end CompiledModel::~CompiledModel()
+
+//
+// Function:	add_input_var()
+//
+// Purpose:		Add an input variable. The variables must be added in the same order
+//				as the model's. The DOM table must not change until pack() is called.
+//
+// Arguments:
+//
+//		RealType				left_x			-	left x value of the variable
+//		RealType				idx_multiplier	-	'x' value of each index
+//		int						x_count			-	number of indexes
+//		int						set_count		-	number of sets
+//		const PackedDOMType*	dom_table		-	the variable's DOM table (see FuzzyVariableBase::get_dom_table())
+//		const int*				rule_index_arr	-	rule index of each set
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void CompiledModel::add_input_var(RealType left_x, RealType idx_multiplier, int x_count, int set_count, const PackedDOMType* dom_table, const int* rule_index_arr)
+{
+	_var_source source;
+
+	memset(&source.info, 0, sizeof(source.info));
+
+	source.info.left_x = left_x;
+	source.info.idx_multiplier = idx_multiplier;
+	source.info.x_count = x_count;
+	source.info.set_count = (dom_table == NULL) ? 0 : set_count;
+	source.dom_table = dom_table;
+	source.rule_index_arr.assign(rule_index_arr, rule_index_arr + source.info.set_count);
+
+	// count the active sets so pack() knows how much memory they need
+	source.active_count = 0;
+
+	int size = x_count * source.info.set_count;
+
+	for (int i = 0; i < size; i++)
+		{
+		if (dom_table[i] != 0)
+			source.active_count++;
+		}
+
+	var_source_arr.push_back(source);
+
+} // end CompiledModel::add_input_var()
+
+//
+// Function:	pack()
+//
+// Purpose:		Lay out the model information that was added in one block. The
+//				information that was kept to build the block is freed.
+//
+// Arguments:
+//
+//		int dom_count - number of DOMs in each output set's COG table (FuzzyVariableBase::get_dom_array_count())
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure (the block would be too large or couldn't be allocated)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Free a mapped block
+//
+//
+int CompiledModel::pack(int dom_count)
+{
+	int i, j, x;	// counters
+	_header h = build_header;
+
+	h.var_count = static_cast<int>(var_source_arr.size());
+	h.out_set_count = static_cast<int>(mom_arr.size());
+	h.dom_count = dom_count;
+	h.dense_rules = (h.rule_max <= MFLL_DENSE_RULE_MAX) ? 1 : 0;
+	h.rule_count = h.dense_rules ? h.rule_max : static_cast<int>(rule_out_arr.size());
+
+	// work out where each section goes...
+	size_t offset = align_offset(sizeof(_header));
+
+	h.var_offset = static_cast<int>(offset);
+	offset = align_offset(offset + h.var_count * sizeof(_var_info));
+
+	for (i = 0; i < h.var_count; i++)
+		{
+		_var_info& info = var_source_arr[i].info;
+
+		info.dom_table_offset = static_cast<int>(offset);
+		offset = align_offset(offset + (static_cast<size_t>(info.x_count) * info.set_count + DOM_TABLE_PADDING) * sizeof(PackedDOMType));
+
+		info.active_start_offset = static_cast<int>(offset);
+		offset = align_offset(offset + (info.x_count + 1) * sizeof(int));
+
+		info.active_offset = static_cast<int>(offset);
+		offset = align_offset(offset + var_source_arr[i].active_count * sizeof(_active_set));
+
+		if (offset > INT_MAX)
+			return -1;
+
+		} // end loop through vars
+
+	h.rule_offset = static_cast<int>(offset);
+	offset = align_offset(offset + static_cast<size_t>(h.rule_count) * sizeof(RuleArrayType));
+
+	h.rule_index_offset = static_cast<int>(offset);
+
+	if (!h.dense_rules)
+		offset = align_offset(offset + static_cast<size_t>(h.rule_count) * sizeof(int));
+
+	h.defuzz_offset = static_cast<int>(offset);
+
+	if (h.defuzz_method == DefuzzVarObj::DEFUZZ_COG)
+		offset += static_cast<size_t>(h.out_set_count) * dom_count * 2 * sizeof(RealType);
+	else
+		offset += h.out_set_count * sizeof(RealType);
+
+	if (offset > INT_MAX)
+		return -1;
+
+	h.block_size = static_cast<int>(offset);
+
+	char* new_block = new char[h.block_size];
+
+	if (new_block == NULL)
+		return -1;
+
+	memset(new_block, 0, h.block_size);
+	memcpy(new_block, &h, sizeof(h));
+
+	// fill in the input vars...
+	_var_info* var_arr = reinterpret_cast<_var_info*>(new_block + h.var_offset);
+
+	for (i = 0; i < h.var_count; i++)
+		{
+		const _var_source& source = var_source_arr[i];
+		const _var_info& info = source.info;
+
+		var_arr[i] = info;
+
+		PackedDOMType* dom_table = reinterpret_cast<PackedDOMType*>(new_block + info.dom_table_offset);
+		int* active_start_arr = reinterpret_cast<int*>(new_block + info.active_start_offset);
+		_active_set* active_arr = reinterpret_cast<_active_set*>(new_block + info.active_offset);
+
+		if (info.set_count)
+			memcpy(dom_table, source.dom_table, info.x_count * info.set_count * sizeof(PackedDOMType));
+
+		// the active sets for each index, in set order so the rules are
+		// still fired in rule index order
+		int count = 0;
+		const PackedDOMType* row = dom_table;
+
+		for (x = 0; x < info.x_count; x++, row += info.set_count)
+			{
+			active_start_arr[x] = count;
+
+			for (j = 0; j < info.set_count; j++)
+				{
+				if (row[j] == 0)
+					continue;
+
+				active_arr[count].dom = row[j];
+				active_arr[count].rule_index = source.rule_index_arr[j];
+				active_arr[count].set_idx = j;
+				count++;
+				}
+
+			} // end loop through indexes
+
+		active_start_arr[info.x_count] = count;
+
+		} // end loop through vars
+
+	// the rules...
+	RuleArrayType* rule_arr = reinterpret_cast<RuleArrayType*>(new_block + h.rule_offset);
+
+	if (h.dense_rules)
+		{
+		memset(rule_arr, NO_RULE, h.rule_count * sizeof(RuleArrayType));
+
+		for (i = 0; i < static_cast<int>(rule_out_arr.size()); i++)
+			{
+			if (rule_index_arr[i] >= 0 && rule_index_arr[i] < h.rule_max)
+				rule_arr[rule_index_arr[i]] = rule_out_arr[i];
+			}
+		}
+	else
+		{
+		int* index_arr = reinterpret_cast<int*>(new_block + h.rule_index_offset);
+
+		for (i = 0; i < h.rule_count; i++)
+			{
+			index_arr[i] = rule_index_arr[i];
+			rule_arr[i] = rule_out_arr[i];
+			}
+
+		} // end if sparse rules
+
+	// and the defuzzification tables
+	RealType* defuzz_arr = reinterpret_cast<RealType*>(new_block + h.defuzz_offset);
+
+	for (i = 0; i < h.out_set_count; i++)
+		{
+		if (h.defuzz_method != DefuzzVarObj::DEFUZZ_COG)
+			defuzz_arr[i] = mom_arr[i];
+		else if (cog_source_arr[i] != NULL)
+			memcpy(defuzz_arr + i * dom_count * 2, cog_source_arr[i], dom_count * 2 * sizeof(RealType));
+
+		// a set with no COG table has an area of 0 for every DOM so it's skipped
+
+		} // end loop through output sets
+
+	free_block();
+	block = new_block;
+	header = reinterpret_cast<const _header*>(block);
+
+	choose_batch_kernel();
+
+	// don't need the information any more
+	std::vector<_var_source>().swap(var_source_arr);
+	std::vector<const RealType*>().swap(cog_source_arr);
+	std::vector<RealType>().swap(mom_arr);
+	std::vector<int>().swap(rule_index_arr);
+	std::vector<RuleArrayType>().swap(rule_out_arr);
+
+	return 0;
+
+} // end CompiledModel::pack()
+
+//
+// Function:	calc_output()
+//
+// Purpose:		Calculates the defuzzified output value for the input indexes passed in.
+//				This looks up the active (non-zero DOM) sets for each input variable
+//				then calls fire_rules() to fire the rules for them.
+//
+// Arguments:
+//
+//		const short*		var_idx_arr		-	index value for each input var
+//		DOMType*			out_set_dom_arr -	gets the DOM value for each set in the output variable
+//		InferenceScratch*	scratch			-	working memory, we point at the active sets in it.
+//												Each thread must use its own.
+//
+// Returns:
+//
+//		RealType - the output value, FLT_MIN if no ouput set is active
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+RealType CompiledModel::calc_output(const short* var_idx_arr, DOMType* out_set_dom_arr, InferenceScratch* scratch) const
+{
+	int i;	// counter
+
+	// any partial activations were for the previous inputs
+	scratch->active_valid = false;
+	scratch->partial_var = -1;
+
+	if (header->defuzz_method < 0)
+		return FLT_MIN;	// don't have an output var!
+
+	// zero out the dom arrays...
+	for (i = 0; i < header->out_set_count; i++)
+		out_set_dom_arr[i] = 0;
+
+	if (header->var_count == 0 || header->out_set_count == 0)
+		return FLT_MIN; // no rules can fire
+
+	// make sure the scratch arrays are big enough for this model
+	if (scratch->alloc(header->var_count))
+		return FLT_MIN;
+
+	// look up the active sets for each input var...
+	bool any_inactive = false;	// true if a variable has no active sets
+
+	for (i = 0; i < header->var_count; i++)
+		{
+		scratch->var_active_arr[i] = get_active_sets(i, var_idx_arr[i], &scratch->active_count_arr[i]);
+
+		if (scratch->active_count_arr[i] == 0)
+			any_inactive = true;
+
+		} // end loop through input vars
+
+	scratch->active_valid = true;
+
+	// if no set is active for a variable, no rule can fire
+	if (!any_inactive)
+		fire_rules(scratch, out_set_dom_arr);
+
+	return defuzzify(out_set_dom_arr);
+
+} // end CompiledModel::calc_output()
+
+//
+// Function:	fire_rules()
+//
+// Purpose:		Calculates the DOMs for the output sets from the active sets
+//				collected by calc_output(). This walks the cross product of the
+//				active sets of each input variable (like an odometer, the last
+//				variable changes fastest) so the rules are fired in the same order
+//				as the rule index and each rule is only fired once.
+//
+// Arguments:
+//
+//		InferenceScratch*	scratch			-	holds the active sets for each input variable
+//		DOMType*			out_set_dom_arr	-	Array that holds the DOM value for each
+//												set in the output variable
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void CompiledModel::fire_rules(InferenceScratch* scratch, DOMType* out_set_dom_arr) const
+{
+	const _active_set** var_active_arr = scratch->var_active_arr;
+	int*		active_count_arr = scratch->active_count_arr;
+	int*		position_arr = scratch->position_arr;
+	DOMType*	activation_arr = scratch->activation_arr;
+	int*		rule_index_arr = scratch->rule_index_arr;
+
+	bool		inference_min = (header->inference_min != 0);
+	int			last_var = header->var_count - 1;
+	int			var_num = 0;	// variable we're on
+	DOMType		activation_level;	// activation level combining vars 0 through var_num
+	int			rule_index;		// rule index combining vars 0 through var_num
+
+	position_arr[0] = 0;
+
+	while (1)
+		{
+		const _active_set* set = var_active_arr[var_num] + position_arr[var_num];
+
+		if (var_num == 0)
+			{
+			// if this is the FIRST var, set the activation level
+			activation_level = set->dom;
+			rule_index = set->rule_index;
+			}
+		else
+			{
+			activation_level = activation_arr[var_num - 1];
+
+			// set the activation level to the current set's level dependent on the inference method
+			if (inference_min ? (set->dom < activation_level) : (set->dom > activation_level))
+				activation_level = set->dom;
+
+			rule_index = rule_index_arr[var_num - 1] + set->rule_index;
+			}
+
+		if (var_num < last_var)
+			{
+			// save where we are and move on to the next variable
+			activation_arr[var_num] = activation_level;
+			rule_index_arr[var_num] = rule_index;
+
+			position_arr[++var_num] = 0;
+
+			continue;
+			}
+
+		// we have a set from every input var, if there is a rule for
+		// the rule_index set the output set's DOM
+		RuleArrayType out_set = get_rule(rule_index);
+
+		// SUB 1 from activation level cuz that's from 0 to MAX_DOM and
+		// we're setting an INDEX
+		if (out_set != NO_RULE)
+			set_output_dom(out_set_dom_arr, out_set, activation_level - 1);
+
+		// move to the next active set, backing up to the previous
+		// variable(s) when we run out of sets
+		while (++position_arr[var_num] == active_count_arr[var_num])
+			{
+			if (var_num == 0)
+				return; // done
+
+			var_num--;
+			}
+
+		} // end while(1)
+
+} // end CompiledModel::fire_rules()
+
+//
+// Function:	calc_output_incremental()
+//
+// Purpose:		Calculates the defuzzified output value when at most one input has
+//				changed since the last time the output was calculated with the scratch
+//				passed in. The active sets of the other variables are re-used and their
+//				combinations (the partial activations) are kept in the scratch, so only
+//				the rules involving the changed variable's new active sets are fired. If
+//				the changed variable's active sets have the same DOMs as before the output
+//				sets' DOMs can't have changed and no rules are fired at all.
+//
+// Arguments:
+//
+//		const short*		var_idx_arr		-	index value for each input var
+//		int					changed_var		-	index of the only input var whose index changed since
+//												the last call, -1 if more than one changed
+//		DOMType*			out_set_dom_arr -	DOM value for each set in the output variable, this
+//												must be the same array that was passed for the last call
+//		InferenceScratch*	scratch			-	working memory that holds the cached active sets and
+//												partial activations
+//
+// Returns:
+//
+//		RealType - the output value, FLT_MIN if no ouput set is active
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+RealType CompiledModel::calc_output_incremental(const short* var_idx_arr, int changed_var, DOMType* out_set_dom_arr, InferenceScratch* scratch) const
+{
+	int i, j, k;	// counters
+
+	if (changed_var < 0 || changed_var >= header->var_count || !scratch->active_valid || header->defuzz_method < 0)
+		return calc_output(var_idx_arr, out_set_dom_arr, scratch);
+
+	int count;	// number of active sets for the changed var
+	const _active_set* active = get_active_sets(changed_var, var_idx_arr[changed_var], &count);
+
+	// if the changed var's active sets have the same DOMs the output is the same
+	const _active_set* prev_active = scratch->var_active_arr[changed_var];
+	bool same = (count == scratch->active_count_arr[changed_var]);
+
+	for (i = 0; same && i < count; i++)
+		{
+		if (active[i].dom != prev_active[i].dom || active[i].set_idx != prev_active[i].set_idx)
+			same = false;
+		}
+
+	if (same)
+		return defuzzify(out_set_dom_arr);
+
+	scratch->var_active_arr[changed_var] = active;
+	scratch->active_count_arr[changed_var] = count;
+
+	// combine the active sets of the vars that didn't change (if we haven't already)
+	if (scratch->partial_var != changed_var)
+		calc_partial_activations(scratch, changed_var);
+
+	for (i = 0; i < header->out_set_count; i++)
+		out_set_dom_arr[i] = 0;
+
+	// fire the rules in rule index order, the vars before the changed one
+	// change slowest and the vars after it fastest
+	bool inference_min = (header->inference_min != 0);
+	int prefix_count = static_cast<int>(scratch->prefix_arr.size());
+	int suffix_count = static_cast<int>(scratch->suffix_arr.size());
+
+	for (i = 0; i < prefix_count; i++)
+		{
+		const InferenceScratch::_partial_activation& prefix = scratch->prefix_arr[i];
+
+		for (j = 0; j < count; j++)
+			{
+			DOMType prefix_level = prefix.activation;
+
+			if (inference_min ? (active[j].dom < prefix_level) : (active[j].dom > prefix_level))
+				prefix_level = active[j].dom;
+
+			int prefix_rule = prefix.rule_index + active[j].rule_index;
+
+			for (k = 0; k < suffix_count; k++)
+				{
+				const InferenceScratch::_partial_activation& suffix = scratch->suffix_arr[k];
+				DOMType activation_level = prefix_level;
+
+				if (inference_min ? (suffix.activation < activation_level) : (suffix.activation > activation_level))
+					activation_level = suffix.activation;
+
+				RuleArrayType out_set = get_rule(prefix_rule + suffix.rule_index);
+
+				// SUB 1 from activation level cuz that's from 0 to MAX_DOM and
+				// we're setting an INDEX
+				if (out_set != NO_RULE)
+					set_output_dom(out_set_dom_arr, out_set, activation_level - 1);
+
+				} // end loop through the vars after the changed one
+
+			} // end loop through the changed var's active sets
+
+		} // end loop through the vars before the changed one
+
+	return defuzzify(out_set_dom_arr);
+
+} // end CompiledModel::calc_output_incremental()
+
+//
+// Function:	calc_partial_activations()
+//
+// Purpose:		Combine the active sets of the input variables before the one
+//				passed in, and those after it, so calc_output_incremental() can
+//				fire the rules for a new value of that variable without walking
+//				the other variables again. The combinations are in rule index
+//				order (the last var changes fastest).
+//
+// Arguments:
+//
+//		InferenceScratch*	scratch		-	holds the active sets of each variable, gets
+//											the partial activations
+//		int					changed_var	-	variable to leave out
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void CompiledModel::calc_partial_activations(InferenceScratch* scratch, int changed_var) const
+{
+	int i, j, k;	// counters
+	bool inference_min = (header->inference_min != 0);
+
+	std::vector<InferenceScratch::_partial_activation>* partial_arr[2] = { &scratch->prefix_arr, &scratch->suffix_arr };
+	int first_var[2] = { 0, changed_var + 1 };
+	int last_var[2] = { changed_var, header->var_count };
+
+	for (int part = 0; part < 2; part++)
+		{
+		std::vector<InferenceScratch::_partial_activation>& combo_arr = *partial_arr[part];
+		std::vector<InferenceScratch::_partial_activation> next_arr;
+
+		// start with one combination that doesn't change the activation level
+		InferenceScratch::_partial_activation start;
+
+		start.activation = inference_min ? INT_MAX : INT_MIN;
+		start.rule_index = 0;
+
+		combo_arr.assign(1, start);
+
+		for (i = first_var[part]; i < last_var[part]; i++)
+			{
+			const _active_set* active = scratch->var_active_arr[i];
+			int count = scratch->active_count_arr[i];
+
+			next_arr.clear();
+			next_arr.reserve(combo_arr.size() * count);
+
+			for (j = 0; j < static_cast<int>(combo_arr.size()); j++)
+				{
+				for (k = 0; k < count; k++)
+					{
+					InferenceScratch::_partial_activation combo = combo_arr[j];
+
+					if (inference_min ? (active[k].dom < combo.activation) : (active[k].dom > combo.activation))
+						combo.activation = active[k].dom;
+
+					combo.rule_index += active[k].rule_index;
+
+					next_arr.push_back(combo);
+					}
+				}
+
+			combo_arr.swap(next_arr);
+
+			} // end loop through vars
+
+		} // end loop through the vars before/after the changed one
+
+	scratch->partial_var = changed_var;
+
+} // end CompiledModel::calc_partial_activations()
+
+//
+// Function:	defuzzify()
+//
+// Purpose:		Calculate the defuzzified output value from the DOMs of the output sets
+//				(see COGDefuzzVarObj::calc_value(), MOMDefuzzVarObj::calc_value() and
+//				WADefuzzVarObj::calc_value()).
+//
+// Arguments:
+//
+//		const DOMType* out_set_dom_arr - DOM value for each set in the output variable
+//
+// Returns:
+//
+//		RealType - the defuzzified output value, FLT_MIN if no output sets are active
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Added weighted average
+//
+//
+RealType CompiledModel::defuzzify(const DOMType* out_set_dom_arr) const
+{
+	int i;	// counter
+	const RealType* defuzz_arr = reinterpret_cast<const RealType*>(block + header->defuzz_offset);
+
+	if (header->defuzz_method == DefuzzVarObj::DEFUZZ_MOM)
+		{
+		DOMType mom_max = 0;	// max DOM of the output sets
+		int		winning_set = -1;	// set with the max DOM
+
+		for (i = 0; i < header->out_set_count; i++)
+			{
+			DOMType dom = out_set_dom_arr[i];
+
+			if (dom == 255)
+				dom = 0;
+
+			if (mom_max < dom)
+				{
+				mom_max = dom;
+				winning_set = i;
+				}
+			}
+
+		if (winning_set < 0)
+			return FLT_MIN;	// no output set is active
+
+		return defuzz_arr[winning_set];
+
+		} // end if MOM
+
+	if (header->defuzz_method == DefuzzVarObj::DEFUZZ_WA)
+		{
+		RealType weight_sum = 0.0;	// sum of the DOMs
+		RealType moment_sum = 0.0;	// sum of the DOMs times the sets' positions
+
+		for (i = 0; i < header->out_set_count; i++)
+			{
+			DOMType dom = out_set_dom_arr[i];
+
+			if (dom == 255)
+				dom = 0;
+
+			weight_sum += dom;
+			moment_sum += dom * defuzz_arr[i];
+			}
+
+		if (weight_sum == 0)
+			return FLT_MIN;	// no output set is active
+
+		return moment_sum / weight_sum;
+
+		} // end if weighted average
+
+	if (header->defuzz_method != DefuzzVarObj::DEFUZZ_COG)
+		return FLT_MIN;
+
+	// sum the areas and moments of the sets, treating each as a point mass
+	RealType area_sum = 0.0;	// sum of the areas
+	RealType moment_sum = 0.0;	// sum of the moments
+	bool	 any_area = false;	// true if any set had an area
+
+	for (i = 0; i < header->out_set_count; i++)
+		{
+		int cog_idx = out_set_dom_arr[i];
+
+		if (cog_idx == 255)
+			cog_idx = 0;
+
+		const RealType* area_moment = defuzz_arr + (i * header->dom_count + cog_idx) * 2;
+
+		if (area_moment[0])
+			{
+			area_sum += area_moment[0];
+			moment_sum += area_moment[1];
+			any_area = true;
+			}
+
+		} // end loop through sets
+
+	if (!any_area)
+		return FLT_MIN;	// return so we don't div by 0 below
+
+	// be sure to account for the left x (start of the var)
+	return (header->out_left_x + (moment_sum / area_sum));
+
+} // end CompiledModel::defuzzify()
+
+//
+// Function:	init_batch_kernel()
+//
+// Purpose:		Fill in the model information the AVX2 kernel needs to calculate
+//				the output (see BatchKernel). This is done once per batch. The kernel
+//				isn't used for models where it would be slower than calc_output()
+//				(see choose_batch_kernel()).
+//
+// Arguments:
+//
+//		BatchKernel* kernel - kernel to initialize
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure (the kernel can't be used for this model, or it's slower)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Fail if the kernel is slower than calc_output() for this model
+//
+//
+int CompiledModel::init_batch_kernel(BatchKernel* kernel) const
+{
+	int i, j;	// counters
+
+	if (!batch_kernel_faster)
+		return -1;
+
+	if (header->defuzz_method < 0 || header->var_count == 0 || header->out_set_count == 0)
+		return -1;
+
+	const _var_info* var_arr = reinterpret_cast<const _var_info*>(block + header->var_offset);
+
+	kernel->var_count = header->var_count;
+	kernel->out_set_count = header->out_set_count;
+	kernel->inference_min = (header->inference_min != 0);
+	kernel->composition_min = (header->composition_min != 0);
+	kernel->left_x = header->out_left_x;
+	kernel->model = this;
+
+	// get the DOM table for every input var...
+	kernel->var_first_set_arr.resize(header->var_count);
+	kernel->var_dom_table_arr.resize(header->var_count);
+	kernel->set_count = 0;
+
+	for (i = 0; i < header->var_count; i++)
+		{
+		if (var_arr[i].set_count == 0)
+			return -1;	// no rules can fire
+
+		kernel->var_first_set_arr[i] = kernel->set_count;
+		kernel->var_dom_table_arr[i] = reinterpret_cast<const PackedDOMType*>(block + var_arr[i].dom_table_offset);
+		kernel->set_count += var_arr[i].set_count;
+
+		} // end loop through input vars
+
+	// break each defined rule into its sets, the last var changes fastest...
+	const RuleArrayType* rule_arr = reinterpret_cast<const RuleArrayType*>(block + header->rule_offset);
+	const int* index_arr = reinterpret_cast<const int*>(block + header->rule_index_offset);
+
+	for (j = 0; j < header->rule_count; j++)
+		{
+		RuleArrayType out_set = rule_arr[j];
+
+		if (out_set == NO_RULE)
+			continue;
+
+		int rule_index = header->dense_rules ? j : index_arr[j];
+		int first = static_cast<int>(kernel->rule_set_arr.size());
+
+		kernel->rule_set_arr.resize(first + header->var_count);
+
+		for (i = header->var_count - 1; i >= 0; i--)
+			{
+			kernel->rule_set_arr[first + i] = kernel->var_first_set_arr[i] + rule_index % var_arr[i].set_count;
+			rule_index /= var_arr[i].set_count;
+			}
+
+		kernel->rule_out_arr.push_back(out_set);
+
+		} // end loop through rules
+
+	kernel->rule_count = static_cast<int>(kernel->rule_out_arr.size());
+
+	// for COG point at the area/moment arrays so they can be summed vector-wide
+	kernel->use_cog = (header->defuzz_method == DefuzzVarObj::DEFUZZ_COG);
+
+	if (kernel->use_cog)
+		{
+		const RealType* defuzz_arr = reinterpret_cast<const RealType*>(block + header->defuzz_offset);
+
+		kernel->cog_arr.resize(header->out_set_count);
+
+		for (i = 0; i < header->out_set_count; i++)
+			kernel->cog_arr[i] = defuzz_arr + i * header->dom_count * 2;
+
+		} // end if COG
+
+	kernel->alloc();
+
+	return 0;
+
+} // end CompiledModel::init_batch_kernel()
+
+//
+// Function:	choose_batch_kernel()
+//
+// Purpose:		Decide if the AVX2 kernel is faster than calc_output() for this model.
+//				The kernel fires every defined rule for each block of LANES samples
+//				while calc_output() only fires the combinations of the active sets of
+//				each sample, so for models with a lot of rules and only a few sets
+//				active at a time the kernel is slower. The number of combinations is
+//				estimated as the product of each variable's average number of active
+//				sets. This is done once, when the block is set.
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void CompiledModel::choose_batch_kernel()
+{
+	int i;	// counter
+
+	const _var_info* var_arr = reinterpret_cast<const _var_info*>(block + header->var_offset);
+
+	// average number of rule combinations calc_output() fires for a sample
+	double combo_count = 1.0;
+
+	for (i = 0; i < header->var_count; i++)
+		{
+		const int* active_start_arr = reinterpret_cast<const int*>(block + var_arr[i].active_start_offset);
+
+		combo_count *= static_cast<double>(active_start_arr[var_arr[i].x_count] - active_start_arr[0]) / var_arr[i].x_count;
+		}
+
+	// number of rules the kernel fires for each block
+	int rule_count = header->rule_count;
+
+	if (header->dense_rules)
+		{
+		const RuleArrayType* rule_arr = reinterpret_cast<const RuleArrayType*>(block + header->rule_offset);
+
+		rule_count = static_cast<int>(header->rule_count - std::count(rule_arr, rule_arr + header->rule_count, NO_RULE));
+		}
+
+	// firing a rule for LANES samples costs about the same as firing one
+	// combination for one sample
+	batch_kernel_faster = (rule_count < BatchKernel::LANES * (combo_count + SCALAR_OVERHEAD_COMBOS));
+
+} // end CompiledModel::choose_batch_kernel()
+
+//
+// Function:	save()
+//
+// Purpose:		Write the compiled model to a file so it can be loaded with load()
+//				without building it again. The file is a _file_header followed by
+//				the block as is.
+//
+// Arguments:
+//
+//		std::ostream& file - file to write to (opened in binary mode)
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int CompiledModel::save(std::ostream& file) const
+{
+	if (block == NULL)
+		return -1;	// not packed
+
+	_file_header file_header;
+
+	memset(&file_header, 0, sizeof(file_header));
+	memcpy(file_header.magic, FILE_MAGIC, sizeof(file_header.magic));
+
+	file_header.version = FILE_VERSION;
+	file_header.byte_order = FILE_BYTE_ORDER;
+	file_header.real_size = sizeof(RealType);
+	file_header.rule_size = sizeof(RuleArrayType);
+	file_header.block_size = header->block_size;
+	file_header.checksum = calc_checksum(block, header->block_size);
+
+	file.write(reinterpret_cast<const char*>(&file_header), sizeof(file_header));
+	file.write(block, header->block_size);
+
+	return file.good() ? 0 : -1;
+
+} // end CompiledModel::save()
+
+//
+// Function:	load()
+//
+// Purpose:		Load a compiled model that was written by save(). The file header
+//				and the checksum are checked, then every count and offset in the
+//				block (see validate()) so a file from another version, or one that's
+//				been damaged, is rejected rather than read past the end of the block.
+//				If it's valid the block is copied, nothing is calculated.
+//
+// Arguments:
+//
+//		const char*	data		-	contents of the file
+//		size_t		length		-	number of bytes in the file
+//		int			dom_count	-	number of DOMs the COG tables must have (FuzzyVariableBase::get_dom_array_count())
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure (the object is unchanged)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Moved the file header checks to check_file()
+//
+//
+int CompiledModel::load(const char* data, size_t length, int dom_count)
+{
+	const char* file_block = check_file(data, length);
+
+	if (file_block == NULL)
+		return -1;
+
+	size_t block_size = length - sizeof(_file_header);
+
+	char* new_block = new char[block_size];
+
+	if (new_block == NULL)
+		return -1;
+
+	// copy before validating so the block we check is aligned like the one we'll use
+	memcpy(new_block, file_block, block_size);
+
+	if (validate(new_block, block_size, dom_count))
+		{
+		delete[] new_block;
+		return -1;
+		}
+
+	free_block();
+	block = new_block;
+	header = reinterpret_cast<const _header*>(block);
+
+	choose_batch_kernel();
+
+	return 0;
+
+} // end CompiledModel::load()
+
+//
+// Function:	load_mapped()
+//
+// Purpose:		Use a compiled model file that's mapped into memory (see MappedFile)
+//				without copying it. The file is checked just like load() does, then
+//				the block is used where it is in the mapping. Nothing is ever written
+//				to the block so its pages stay shared with every other process that
+//				has the file mapped.
+//
+// Arguments:
+//
+//		MappedFile*	file		-	the mapped file, on success this object owns it
+//									and unmaps it when it's done with the block
+//		int			dom_count	-	number of DOMs the COG tables must have (FuzzyVariableBase::get_dom_array_count())
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure (the object is unchanged and the caller still owns the file)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int CompiledModel::load_mapped(MappedFile* file, int dom_count)
+{
+	if (file == NULL || !file->is_open())
+		return -1;
+
+	const char* file_block = check_file(file->get_data(), file->get_length());
+
+	// the mapping starts on a page so the block is aligned, but make sure
+	if (file_block == NULL || (reinterpret_cast<size_t>(file_block) % SECTION_ALIGN) != 0)
+		return -1;
+
+	if (validate(file_block, file->get_length() - sizeof(_file_header), dom_count))
+		return -1;
+
+	free_block();
+	block = file_block;
+	header = reinterpret_cast<const _header*>(block);
+	mapped_file = file;
+
+	choose_batch_kernel();
+
+	return 0;
+
+} // end CompiledModel::load_mapped()
+
+//
+// Function:	check_file()
+//
+// Purpose:		Check the _file_header at the start of a compiled model file: it's
+//				from this version, was written with the same byte order and type
+//				sizes, and the block that follows it is the right size and matches
+//				its checksum.
+//
+// Arguments:
+//
+//		const char*	data	-	contents of the file
+//		size_t		length	-	number of bytes in the file
+//
+// Returns:
+//
+//		const char* - start of the block in the file, NULL if the file isn't valid
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+const char* CompiledModel::check_file(const char* data, size_t length)
+{
+	_file_header file_header;
+
+	if (data == NULL || length < sizeof(file_header))
+		return NULL;
+
+	memcpy(&file_header, data, sizeof(file_header));
+
+	if (memcmp(file_header.magic, FILE_MAGIC, sizeof(file_header.magic)) != 0 ||
+		file_header.version != FILE_VERSION ||
+		file_header.byte_order != FILE_BYTE_ORDER ||
+		file_header.real_size != sizeof(RealType) ||
+		file_header.rule_size != sizeof(RuleArrayType) ||
+		file_header.block_size < static_cast<int>(sizeof(_header)) ||
+		static_cast<size_t>(file_header.block_size) != length - sizeof(file_header))
+		return NULL;
+
+	const char* file_block = data + sizeof(file_header);
+
+	if (calc_checksum(file_block, file_header.block_size) != file_header.checksum)
+		return NULL;
+
+	return file_block;
+
+} // end CompiledModel::check_file()
+
+//
+// Function:	validate()
+//
+// Purpose:		Make sure a block we didn't pack ourselves is safe to calculate from:
+//				every section is inside the block and every index stored in it
+//				(active set, rule, output set) is in range.
+//
+// Arguments:
+//
+//		const char*	data		-	the block
+//		size_t		length		-	number of bytes in the block
+//		int			dom_count	-	number of DOMs the COG tables must have
+//
+// Returns:
+//
+//		0 - the block is valid
+//		non-zero - it isn't
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int CompiledModel::validate(const char* data, size_t length, int dom_count)
+{
+	int i, x;	// counters
+	const _header* h = reinterpret_cast<const _header*>(data);
+
+	if (length < sizeof(_header) || static_cast<size_t>(h->block_size) != length)
+		return -1;
+
+	if (h->var_count < 0 || h->out_set_count < 0 || h->out_set_count > NO_RULE || h->dom_count != dom_count)
+		return -1;
+
+	switch (h->defuzz_method)
+		{
+		case -1:
+		case DefuzzVarObj::DEFUZZ_COG:
+		case DefuzzVarObj::DEFUZZ_MOM:
+		case DefuzzVarObj::DEFUZZ_WA:
+			break;
+
+		default:
+			return -1;
+		}
+
+	if (h->rule_max < 0 || h->rule_count < 0 || (h->dense_rules && h->rule_count != h->rule_max))
+		return -1;
+
+	if (!section_fits(length, h->var_offset, h->var_count, sizeof(_var_info)) ||
+		!section_fits(length, h->rule_offset, h->rule_count, sizeof(RuleArrayType)) ||
+		(!h->dense_rules && !section_fits(length, h->rule_index_offset, h->rule_count, sizeof(int))) ||
+		!section_fits(length, h->defuzz_offset, static_cast<unsigned long long>(h->out_set_count) * 
+				((h->defuzz_method == DefuzzVarObj::DEFUZZ_COG) ? dom_count * 2 : 1), sizeof(RealType)))
+		return -1;
+
+	// the input vars...
+	const _var_info* var_arr = reinterpret_cast<const _var_info*>(data + h->var_offset);
+
+	for (i = 0; i < h->var_count; i++)
+		{
+		const _var_info& info = var_arr[i];
+
+		if (info.x_count < 1 || info.x_count > MAX_X_ARRAY_COUNT || info.set_count < 0 || info.set_count > SHRT_MAX || info.idx_multiplier == 0)
+			return -1;
+
+		if (!section_fits(length, info.dom_table_offset, static_cast<unsigned long long>(info.x_count) * info.set_count + DOM_TABLE_PADDING, sizeof(PackedDOMType)) ||
+			!section_fits(length, info.active_start_offset, info.x_count + 1, sizeof(int)))
+			return -1;
+
+		const int* active_start_arr = reinterpret_cast<const int*>(data + info.active_start_offset);
+
+		if (active_start_arr[0] != 0)
+			return -1;
+
+		for (x = 0; x < info.x_count; x++)
+			{
+			if (active_start_arr[x + 1] < active_start_arr[x])
+				return -1;
+			}
+
+		int active_count = active_start_arr[info.x_count];
+
+		if (!section_fits(length, info.active_offset, active_count, sizeof(_active_set)))
+			return -1;
+
+		const _active_set* active_arr = reinterpret_cast<const _active_set*>(data + info.active_offset);
+
+		for (x = 0; x < active_count; x++)
+			{
+			const _active_set& set = active_arr[x];
+
+			if (set.set_idx < 0 || set.set_idx >= info.set_count || set.rule_index < 0 || set.dom < 1 || set.dom > dom_count)
+				return -1;
+			}
+
+		} // end loop through vars
+
+	// the rules...
+	const RuleArrayType* rule_arr = reinterpret_cast<const RuleArrayType*>(data + h->rule_offset);
+	const int* index_arr = reinterpret_cast<const int*>(data + h->rule_index_offset);
+
+	for (i = 0; i < h->rule_count; i++)
+		{
+		if (rule_arr[i] != NO_RULE && rule_arr[i] >= h->out_set_count)
+			return -1;
+
+		// the sparse rules have to be sorted for get_rule()
+		if (!h->dense_rules && (index_arr[i] < 0 || (i > 0 && index_arr[i] <= index_arr[i - 1])))
+			return -1;
+
+		} // end loop through rules
+
+	return 0;
+
+} // end CompiledModel::validate()
+
+//
+// Function:	calc_checksum()
+//
+// Purpose:		Calculates the CRC-32 (the one zip uses) of the data passed in
+//
+// Arguments:
+//
+//		const char*	data	-	data to check
+//		size_t		length	-	number of bytes
+//
+// Returns:
+//
+//		unsigned int - the CRC
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+unsigned int CompiledModel::calc_checksum(const char* data, size_t length)
+{
+	// the CRC of each byte value, built the first time we're called
+	static unsigned int crc_table[256];
+	static bool table_built = build_crc_table(crc_table);
+
+	(void)table_built;
+
+	unsigned int crc = 0xFFFFFFFF;
+
+	for (size_t i = 0; i < length; i++)
+		crc = crc_table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+
+	return crc ^ 0xFFFFFFFF;
+
+} // end CompiledModel::calc_checksum()
+
+/////////////////////////////////////////////////////////////////////
+////////// Trivial Functions That Don't Require Headers /////////////
+/////////////////////////////////////////////////////////////////////
+
+void CompiledModel::set_inference_method(bool min)
+{
+	build_header.inference_min = min ? 1 : 0;
+};
+
+void CompiledModel::set_output_var(RealType left_x, bool composition_min, int defuzz_method)
+{
+	build_header.out_left_x = left_x;
+	build_header.composition_min = composition_min ? 1 : 0;
+	build_header.defuzz_method = defuzz_method;
+};
+
+void CompiledModel::set_rule_max(int max)
+{
+	build_header.rule_max = max;
+};
+
+void CompiledModel::add_out_set(const RealType* area_moment_arr, RealType mean_value)
+{
+	cog_source_arr.push_back(area_moment_arr);
+	mom_arr.push_back(mean_value);
+};
+
+void CompiledModel::add_rule(int rule_index, RuleArrayType out_set)
+{
+	// the rules must be added in increasing rule index order
+	assert(rule_index_arr.empty() || rule_index > rule_index_arr.back());
+
+	rule_index_arr.push_back(rule_index);
+	rule_out_arr.push_back(out_set);
+};
+
+void CompiledModel::free_block()
+{
+	// a mapped block belongs to the mapping, unmapping the file frees it
+	if (mapped_file)
+		delete mapped_file;
+	else
+		delete[] block;
+
+	mapped_file = NULL;
+	block = NULL;
+	header = NULL;
+	batch_kernel_faster = false;
+};
+
+int CompiledModel::get_input_var_count() const
+{
+	return header->var_count;
+};
+
+int CompiledModel::get_out_set_count() const
+{
+	return header->out_set_count;
+};
+
+int CompiledModel::get_set_count(int var_idx) const
+{
+	const _var_info* var_arr = reinterpret_cast<const _var_info*>(block + header->var_offset);
+
+	return var_arr[var_idx].set_count;
+};
+
+int CompiledModel::get_x_array_count(int var_idx) const
+{
+	const _var_info* var_arr = reinterpret_cast<const _var_info*>(block + header->var_offset);
+
+	return var_arr[var_idx].x_count;
+};
+
+ValuesArrCountType CompiledModel::convert_value_to_idx(int var_idx, RealType value) const
+{
+	const _var_info& info = reinterpret_cast<const _var_info*>(block + header->var_offset)[var_idx];
+
+	// add .5 so any floating point values get rounded correctly when converting to int
+	int idx = ((value - info.left_x) / info.idx_multiplier) + .5;
+
+	// make sure index is within range
+	if (idx < 0)
+		idx = 0;
+	if (idx > info.x_count - 1)
+		idx = info.x_count - 1;
+
+	return idx;
+};
+
+RealType CompiledModel::convert_value_to_pos(int var_idx, RealType value) const
+{
+	const _var_info& info = reinterpret_cast<const _var_info*>(block + header->var_offset)[var_idx];
+
+	RealType pos = (value - info.left_x) / info.idx_multiplier;
+
+	// make sure position is within range
+	if (pos < 0)
+		pos = 0;
+	if (pos > info.x_count - 1)
+		pos = info.x_count - 1;
+
+	return pos;
+};
+
+FFLL_INLINE RuleArrayType CompiledModel::get_rule(int rule_index) const
+{
+	const RuleArrayType* rule_arr = reinterpret_cast<const RuleArrayType*>(block + header->rule_offset);
+
+	if (header->dense_rules)
+		return (rule_index >= 0 && rule_index < header->rule_count) ? rule_arr[rule_index] : NO_RULE;
+
+	// the defined rules are sorted by rule index
+	const int* index_arr = reinterpret_cast<const int*>(block + header->rule_index_offset);
+	const int* found = std::lower_bound(index_arr, index_arr + header->rule_count, rule_index);
+
+	if (found == index_arr + header->rule_count || *found != rule_index)
+		return NO_RULE;
+
+	return rule_arr[found - index_arr];
+};
+
+FFLL_INLINE const CompiledModel::_active_set* CompiledModel::get_active_sets(int var_idx, int x_position, int* count) const
+{
+	const _var_info& info = reinterpret_cast<const _var_info*>(block + header->var_offset)[var_idx];
+	const int* active_start_arr = reinterpret_cast<const int*>(block + info.active_start_offset);
+
+	// make sure index is within range
+	if (x_position < 0)
+		x_position = 0;
+	if (x_position >= info.x_count)
+		x_position = info.x_count - 1;
+
+	*count = active_start_arr[x_position + 1] - active_start_arr[x_position];
+
+	return reinterpret_cast<const _active_set*>(block + info.active_offset) + active_start_arr[x_position];
+};
+
+FFLL_INLINE void CompiledModel::set_output_dom(DOMType* out_set_dom_arr, int set_idx, DOMType new_value) const
+{
+	// set the value dependent on the COMPOSITION method. If the current dom is 0
+	// no rule has fired for the set yet so always set it
+	DOMType current_dom = out_set_dom_arr[set_idx];
+
+	if (current_dom == 0 || (header->composition_min ? (new_value < current_dom) : (new_value > current_dom)))
+		out_set_dom_arr[set_idx] = (new_value < 0) ? 0 : new_value;
+};
@@ -0,0 +1,210 @@
+//
+// File:	CompiledModel.h
+//
+// Purpose:	Interface for the CompiledModel class. This class holds everything
+//			needed to calculate the output of a model in one block of memory.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#ifndef _CompiledModel_H
+#define _CompiledModel_H
+
+#include "FFLLBase.h"
+#include <vector>
+#include <ostream>
+
+class InferenceScratch;
+class BatchKernel;
+class MappedFile;
+
+//
+// Class:	CompiledModel
+//
+// The variables, sets, rules and defuzzification objects of a FuzzyModelBase are
+// built for editing (and saving), calculating the output from them means following
+// pointers from the model to each variable, set and defuzzification object. This class
+// is a read-only "compiled" copy of the parts of the model needed to calculate the
+// output, laid out in one contiguous block:
+//
+//		_header			-	counts, inference/composition/defuzzification methods and
+//							the offset of each of the sections below
+//		_var_info		-	for each input var, its range and where its tables are
+//		DOM tables		-	for each input var, the DOM of every set at every index
+//							(x-major, like FuzzyVariableBase::get_dom_table())
+//		active sets		-	for each input var and index, the sets with a non-zero DOM
+//		rules			-	output set for each rule index (or the defined rules, sorted,
+//							if the model has too many combinations for a dense table)
+//		defuzzification	-	COG: the area/moment pairs of each output set for every DOM
+//							MOM: the mean of the maxima of each output set
+//							WA: the position of each output set
+//
+// Everything in the block is addressed by offset from the start of the block so the
+// block doesn't depend on where it is in memory.
+//
+// FuzzyModelBase fills in the model information (see FuzzyModelBase::compile()) with the
+// add_*() and set_*() functions, then pack() lays it out in the block. After that the
+// object is never changed so any number of threads can calculate outputs from it, each
+// with its own InferenceScratch.
+// NOTE: the compiled model is not updated if the model changes, FuzzyModelBase throws
+// it away whenever the model is edited and compiles it again when it's needed.
+//
+// Since the block has no pointers it can be saved to a file as is (see save()) and
+// loaded back (see load()) without the FCL file, the membership functions or the
+// COG calculations. The file is the block with a _file_header in front of it.
+//
+// load_mapped() doesn't copy the block at all, it calculates straight from a read-only
+// mapping of the file (see MappedFile). Every process that maps the same file shares
+// the same physical pages, only the InferenceScratch of each child is private.
+//
+
+class CompiledModel
+{
+	////////////////////////////////////////
+	////////// Member Functions ////////////
+	////////////////////////////////////////
+
+	public:
+
+		// a set that has a non-zero DOM at an index of an input variable
+		typedef struct _active_set_
+			{
+			DOMType		dom;		// DOM of the set at the index
+			int			rule_index;	// the set's rule_index (see FuzzySetBase.h)
+			short		set_idx;	// index of the set in the variable
+			} _active_set;
+
+		// constructor/destructor funcs
+		CompiledModel();
+		virtual ~CompiledModel();
+
+		// set functions
+		void set_inference_method(bool min);
+		void set_output_var(RealType left_x, bool composition_min, int defuzz_method);
+		void set_rule_max(int max);
+		void add_input_var(RealType left_x, RealType idx_multiplier, int x_count, int set_count, const PackedDOMType* dom_table, const int* rule_index_arr);
+		void add_out_set(const RealType* area_moment_arr, RealType mean_value);
+		void add_rule(int rule_index, RuleArrayType out_set);
+
+		// get functions
+		int get_input_var_count() const;
+		int get_out_set_count() const;
+		int get_set_count(int var_idx) const;
+		int get_x_array_count(int var_idx) const;
+
+		// save/load functions
+		int save(std::ostream& file) const;
+		int load(const char* data, size_t length, int dom_count);
+		int load_mapped(MappedFile* file, int dom_count);
+
+		// misc functions
+		int pack(int dom_count);
+		ValuesArrCountType convert_value_to_idx(int var_idx, RealType value) const;
+		RealType convert_value_to_pos(int var_idx, RealType value) const;
+		RealType calc_output(const short* var_idx_arr, DOMType* out_set_dom_arr, InferenceScratch* scratch) const;
+		RealType calc_output_incremental(const short* var_idx_arr, int changed_var, DOMType* out_set_dom_arr, InferenceScratch* scratch) const;
+		RealType defuzzify(const DOMType* out_set_dom_arr) const;
+		int init_batch_kernel(BatchKernel* kernel) const;
+
+	private:
+
+		// don't allow copies. No function bodies for these.
+		CompiledModel(const CompiledModel& copy_from);
+		CompiledModel& operator=(const CompiledModel& copy_from);
+
+		// get functions
+		FFLL_INLINE RuleArrayType get_rule(int rule_index) const;
+		FFLL_INLINE const _active_set* get_active_sets(int var_idx, int x_position, int* count) const;
+
+		// misc functions
+		static const char* check_file(const char* data, size_t length);
+		static int validate(const char* data, size_t length, int dom_count);
+		void free_block();
+		void choose_batch_kernel();
+		static unsigned int calc_checksum(const char* data, size_t length);
+		void fire_rules(InferenceScratch* scratch, DOMType* out_set_dom_arr) const;
+		void calc_partial_activations(InferenceScratch* scratch, int changed_var) const;
+		FFLL_INLINE void set_output_dom(DOMType* out_set_dom_arr, int set_idx, DOMType new_value) const;
+
+	////////////////////////////////////////
+	////////// Class Variables /////////////
+	////////////////////////////////////////
+
+	private:
+
+		// start of the block
+		typedef struct _header_
+			{
+			int			block_size;		// size of the block in bytes
+			int			var_count;		// number of input variables
+			int			out_set_count;	// number of sets in the output variable
+			int			dom_count;		// number of DOMs in each output set's COG table
+			int			inference_min;	// 1 for MIN inference, 0 for MAX
+			int			composition_min;// 1 for MIN composition, 0 for MAX
+			int			defuzz_method;	// DefuzzVarObj::DEFUZZ_TYPE, -1 if there's no output var
+			int			rule_max;		// number of combinations of input sets
+			int			rule_count;		// number of rules in the rule section
+			int			dense_rules;	// 1 if the rule section has an entry for every combination
+			int			var_offset;		// offset of the _var_info array
+			int			rule_offset;	// offset of the output set of each rule
+			int			rule_index_offset;	// offset of the rule index of each rule (not dense only)
+			int			defuzz_offset;	// offset of the defuzzification tables
+			RealType	out_left_x;		// left x value of the output variable
+			} _header;
+
+		// an input variable
+		typedef struct _var_info_
+			{
+			RealType	left_x;			// left x value
+			RealType	idx_multiplier;	// 'x' value of each index (see FuzzyVariableBase::get_idx_multiplier())
+			int			x_count;		// number of indexes
+			int			set_count;		// number of sets
+			int			dom_table_offset;	// offset of the DOM table (x_count * set_count + DOM_TABLE_PADDING elements)
+			int			active_start_offset;// offset of the index of each index's first active set (x_count + 1 elements)
+			int			active_offset;	// offset of the active sets
+			int			reserved;		// keeps the struct a multiple of 8 bytes
+			} _var_info;
+
+		// start of a compiled model file, the block follows it
+		typedef struct _file_header_
+			{
+			char			magic[4];		// "MFLC"
+			int				version;		// FILE_VERSION of the code that wrote the file
+			int				byte_order;		// 0x01020304 as written, the block is in the writer's byte order
+			int				real_size;		// sizeof(RealType)
+			int				rule_size;		// sizeof(RuleArrayType)
+			int				block_size;		// size of the block in bytes
+			unsigned int	checksum;		// CRC-32 of the block
+			int				reserved;		// keeps the struct a multiple of 8 bytes
+			} _file_header;
+
+		// an input variable before it's packed
+		typedef struct _var_source_
+			{
+			_var_info				info;			// offsets are filled in by pack()
+			const PackedDOMType*	dom_table;		// variable's DOM table
+			std::vector<int>		rule_index_arr;	// rule index of each set
+			int						active_count;	// number of non-zero DOMs in the table
+			} _var_source;
+
+		const char*			block;			// the compiled model, NULL until pack() is called
+		const _header*		header;			// start of the block
+		MappedFile*			mapped_file;	// file the block is in if it was loaded with load_mapped(), NULL if we allocated the block
+		bool				batch_kernel_faster;	// true if the AVX2 kernel is faster than calc_output() for this model (see choose_batch_kernel())
+
+		// model information kept until pack() is called
+		_header					build_header;		// counts and methods
+		std::vector<_var_source> var_source_arr;	// the input variables
+		std::vector<const RealType*> cog_source_arr;// area/moment pairs of each output set (NULL if it has none)
+		std::vector<RealType>	mom_arr;			// mean of the maxima (MOM) or position (WA) of each output set
+		std::vector<int>		rule_index_arr;		// index of each defined rule, in increasing order
+		std::vector<RuleArrayType> rule_out_arr;	// output set of each defined rule
+
+}; // end class CompiledModel
+
+#else
+
+class CompiledModel;
+
+#endif // _CompiledModel_H
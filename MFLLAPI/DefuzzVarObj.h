@@ -51,8 +51,8 @@ class DefuzzVarObj : virtual public FFLLBase
 	////////////////////////////////////////
 
 	public:
-		// types of defuzzification: Center of Gravity, Mean of Maximum 
-		enum DEFUZZ_TYPE { DEFUZZ_COG, DEFUZZ_MOM };
+		// types of defuzzification: Center of Gravity, Mean of Maximum, Weighted Average
+		enum DEFUZZ_TYPE { DEFUZZ_COG, DEFUZZ_MOM, DEFUZZ_WA };
 
 }; // end class DefuzzVarObj
  
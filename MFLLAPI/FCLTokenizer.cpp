@@ -0,0 +1,412 @@
+//
+// File:	FCLTokenizer.cpp
+//
+// Purpose:	Implementation of the FCLTokenizer class. This class splits FCL
+//			(Fuzzy Control Language) text into tokens.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#include "FCLTokenizer.h"
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#ifdef _DEBUG
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+
+#include "debug.h"
+
+#endif
+
+//
+// Function:	FCLTokenizer()
+//
+// Purpose:		Constructor
+//
+// Arguments:
+//
+//		const char*	_text	-	FCL text to read (doesn't need to be NULL terminated)
+//		size_t		_length	-	number of characters in the text
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+FCLTokenizer::FCLTokenizer(const char* _text, size_t _length)
+{
+	text = pos = line_start = _text;
+	end = _text + _length;
+	line = 1;
+
+}; // end FCLTokenizer::FCLTokenizer()
+
+//
+// Function:	~FCLTokenizer()
+//
+// Purpose:		Destructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+FCLTokenizer::~FCLTokenizer()
+{
+	// nothing to do, we don't own the text
+
+}; // end FCLTokenizer::~FCLTokenizer()
+
+//
+// Function:	next()
+//
+// Purpose:		Gets the next token, skipping over any comments.
+//
+// Arguments:
+//
+//		_token* token - filled in with the token
+//
+// Returns:
+//
+//		int - the token's TOKEN_TYPE, TOKEN_END if there are no more tokens
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int FCLTokenizer::next(_token* token)
+{
+	while (read(token) == TOKEN_COMMENT)
+		; // skip comments
+
+	return token->type;
+
+} // end FCLTokenizer::next()
+
+//
+// Function:	peek()
+//
+// Purpose:		Gets the next token (skipping over any comments) without moving
+//				past it, the next call to next() gets the same token.
+//
+// Arguments:
+//
+//		_token* token - filled in with the token
+//
+// Returns:
+//
+//		int - the token's TOKEN_TYPE, TOKEN_END if there are no more tokens
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int FCLTokenizer::peek(_token* token)
+{
+	const char*	save_pos = pos;
+	const char*	save_line_start = line_start;
+	int			save_line = line;
+
+	next(token);
+
+	pos = save_pos;
+	line_start = save_line_start;
+	line = save_line;
+
+	return token->type;
+
+} // end FCLTokenizer::peek()
+
+//
+// Function:	next_comment()
+//
+// Purpose:		Gets the next token if it's a comment that starts on the line
+//				passed in. This is used to get the comment at the end of a line,
+//				such as the range of a variable:
+//
+//					variable_name: REAL; (* RANGE(0 .. 100) *)
+//
+// Arguments:
+//
+//		int		line	-	line the comment has to start on
+//		_token* token	-	filled in with the comment
+//
+// Returns:
+//
+//		true - found a comment on the line, we've moved past it
+//		false - the next token isn't a comment on the line, we haven't moved
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+bool FCLTokenizer::next_comment(int _line, _token* token)
+{
+	const char*	save_pos = pos;
+	const char*	save_line_start = line_start;
+	int			save_line = line;
+
+	if (read(token) == TOKEN_COMMENT && token->line == _line)
+		return true;
+
+	pos = save_pos;
+	line_start = save_line_start;
+	line = save_line;
+
+	return false;
+
+} // end FCLTokenizer::next_comment()
+
+//
+// Function:	skip_to()
+//
+// Purpose:		Skips tokens until we get to the word (or symbol) passed in, or
+//				the end.
+//
+// Arguments:
+//
+//		const char*	word	-	word or symbol to look for (case sensitive)
+//		_token*		token	-	filled in with the word (or the TOKEN_END token)
+//
+// Returns:
+//
+//		true - found the word
+//		false - reached the end of the text
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+bool FCLTokenizer::skip_to(const char* word, _token* token)
+{
+	while (next(token) != TOKEN_END)
+		{
+		if (equals(*token, word))
+			return true;
+		}
+
+	return false;
+
+} // end FCLTokenizer::skip_to()
+
+//
+// Function:	read()
+//
+// Purpose:		Reads the next token, including comments.
+//
+// Arguments:
+//
+//		_token* token - filled in with the token
+//
+// Returns:
+//
+//		int - the token's TOKEN_TYPE, TOKEN_END if there are no more tokens
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int FCLTokenizer::read(_token* token)
+{
+	skip_whitespace();
+
+	token->text = pos;
+	token->line = line;
+	token->column = static_cast<int>(pos - line_start) + 1;
+
+	if (pos >= end)
+		{
+		token->type = TOKEN_END;
+		token->length = 0;
+		return TOKEN_END;
+		}
+
+	char c = *pos;
+
+	if (c == '(' && pos + 1 < end && pos[1] == '*')
+		{
+		// comment, read through the "*)" (or the end if there isn't one)
+		pos += 2;
+
+		while (pos < end && !(pos[0] == '*' && pos + 1 < end && pos[1] == ')'))
+			{
+			if (*pos == '\n')
+				{
+				line++;
+				line_start = pos + 1;
+				}
+
+			pos++;
+			}
+
+		pos = (pos < end) ? pos + 2 : end;
+
+		token->type = TOKEN_COMMENT;
+		}
+	else if (c == ':' && pos + 1 < end && pos[1] == '=')
+		{
+		pos += 2;
+		token->type = TOKEN_SYMBOL;
+		}
+	else if (strchr("(),;=:", c) != NULL)
+		{
+		pos++;
+		token->type = TOKEN_SYMBOL;
+		}
+	else
+		{
+		// word, read up to whitespace or a symbol
+		while (pos < end && !isspace(static_cast<unsigned char>(*pos)) && strchr("(),;=:", *pos) == NULL)
+			pos++;
+
+		token->type = TOKEN_WORD;
+		}
+
+	token->length = static_cast<int>(pos - token->text);
+
+	return token->type;
+
+} // end FCLTokenizer::read()
+
+//
+// Function:	to_real()
+//
+// Purpose:		Converts a token to a number.
+//
+// Arguments:
+//
+//		const _token&	token	-	token to convert
+//		RealType*		value	-	set to the number
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - the token isn't a number
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int FCLTokenizer::to_real(const _token& token, RealType* value)
+{
+	char	buffer[64];		// NULL terminated copy of the token for strtod()
+	char*	stop_scan;		// where strtod() stopped
+
+	if (token.type != TOKEN_WORD || token.length >= static_cast<int>(sizeof(buffer)))
+		return -1;
+
+	memcpy(buffer, token.text, token.length);
+	buffer[token.length] = '\0';
+
+	*value = strtod(buffer, &stop_scan);
+
+	// the whole token has to be the number
+	if (stop_scan != buffer + token.length)
+		return -1;
+
+	return 0;
+
+} // end FCLTokenizer::to_real()
+
+
+/////////////////////////////////////////////////////////////////////
+////////// Trivial Functions That Don't Require Headers /////////////
+/////////////////////////////////////////////////////////////////////
+
+void FCLTokenizer::skip_whitespace()
+{
+	while (pos < end && isspace(static_cast<unsigned char>(*pos)))
+		{
+		if (*pos == '\n')
+			{
+			line++;
+			line_start = pos + 1;
+			}
+
+		pos++;
+		}
+};
+bool FCLTokenizer::equals(const _token& token, const char* str)
+{
+	return (strncmp(token.text, str, token.length) == 0 && str[token.length] == '\0');
+};
+bool FCLTokenizer::equals(const _token& token, const wchar_t* str)
+{
+	// compare against an ID without converting it (FCL identifiers are plain ASCII)
+	for (int i = 0; i < token.length; i++)
+		{
+		if (str[i] == L'\0' || str[i] != static_cast<wchar_t>(static_cast<unsigned char>(token.text[i])))
+			return false;
+		}
+
+	return (str[token.length] == L'\0');
+};
+bool FCLTokenizer::equals_nocase(const _token& token, const char* str)
+{
+	return (strnicmp(token.text, str, token.length) == 0 && str[token.length] == '\0');
+};
+bool FCLTokenizer::starts_with(const _token& token, const char* str)
+{
+	size_t len = strlen(str);
+
+	return (static_cast<size_t>(token.length) >= len && strncmp(token.text, str, len) == 0);
+};
+std::string FCLTokenizer::to_string(const _token& token)
+{
+	return std::string(token.text, token.length);
+};
+std::wstring FCLTokenizer::to_wstring(const _token& token)
+{
+	// widen straight from the text, like convert_to_wide_char() does for ASCII
+	std::wstring wstr(token.length, L'\0');
+
+	for (int i = 0; i < token.length; i++)
+		wstr[i] = static_cast<wchar_t>(static_cast<unsigned char>(token.text[i]));
+
+	return wstr;
+};
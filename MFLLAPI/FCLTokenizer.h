@@ -0,0 +1,102 @@
+//
+// File:	FCLTokenizer.h
+//
+// Purpose:	Interface for the FCLTokenizer class. This class splits FCL
+//			(Fuzzy Control Language) text into tokens.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#ifndef _FCLTokenizer_H
+#define _FCLTokenizer_H
+
+#include "FFLLBase.h"
+
+//
+// Class:	FCLTokenizer
+//
+// Walks FCL text once, from start to end, handing back one token at a time. The text
+// is NOT copied (and doesn't need to end with a NULL), each token points into it so the
+// text must stay around as long as the tokens are used. The tokens are:
+//
+//		TOKEN_WORD		-	a run of characters that aren't whitespace or symbols. This
+//							covers keywords, identifiers and numbers.
+//		TOKEN_SYMBOL	-	one of ( ) , ; = : or :=
+//		TOKEN_COMMENT	-	a comment, "(*" through "*)", which may span lines. next()
+//							skips these, next_comment() gets them when they matter (the
+//							RANGE comment of a variable declaration).
+//		TOKEN_END		-	the end of the text
+//
+// Each token has the line and column (both starting at 1) it starts on so errors can
+// say where they are.
+//
+
+class FCLTokenizer
+{
+	////////////////////////////////////////
+	////////// Member Functions ////////////
+	////////////////////////////////////////
+
+	public:
+
+		enum TOKEN_TYPE { TOKEN_END, TOKEN_WORD, TOKEN_SYMBOL, TOKEN_COMMENT };
+
+		// a token, text is NOT NULL terminated
+		typedef struct _token_
+			{
+			int			type;		// TOKEN_TYPE
+			const char*	text;		// start of the token
+			int			length;		// number of characters in the token
+			int			line;		// line the token starts on
+			int			column;		// column the token starts on
+			} _token;
+
+		// constructor/destructor funcs
+		FCLTokenizer(const char* _text, size_t _length);
+		virtual ~FCLTokenizer();
+
+		// misc functions
+		int next(_token* token);
+		int peek(_token* token);
+		bool next_comment(int line, _token* token);
+		bool skip_to(const char* word, _token* token);
+
+		// token functions
+		static bool equals(const _token& token, const char* str);
+		static bool equals(const _token& token, const wchar_t* str);
+		static bool equals_nocase(const _token& token, const char* str);
+		static bool starts_with(const _token& token, const char* str);
+		static std::string to_string(const _token& token);
+		static std::wstring to_wstring(const _token& token);
+		static int to_real(const _token& token, RealType* value);
+
+	private:
+
+		// don't allow copies. No function bodies for these.
+		FCLTokenizer(const FCLTokenizer& copy_from);
+		FCLTokenizer& operator=(const FCLTokenizer& copy_from);
+
+		// misc functions
+		int read(_token* token);
+		void skip_whitespace();
+
+	////////////////////////////////////////
+	////////// Class Variables /////////////
+	////////////////////////////////////////
+
+	private:
+
+		const char*		text;		// text we're reading
+		const char*		end;		// one past the last character of the text
+		const char*		pos;		// next character to read
+		const char*		line_start;	// first character of the line pos is on
+		int				line;		// line pos is on
+
+}; // end class FCLTokenizer
+
+#else
+
+class FCLTokenizer;
+
+#endif // _FCLTokenizer_H
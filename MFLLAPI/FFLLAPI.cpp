@@ -15,14 +15,24 @@
 #include "FuzzyModelBase.h"
 #include "FuzzyOutVariable.h"
 #include "MemberFuncBase.h"
+#include "InferenceScratch.h"
+#include "BakedSurface.h"
+#include "OutputMemo.h"
 #include <vector>
-#include <list>
+#include <string>
+#include <future>
+#include <chrono>
+#include <atomic>
+#include <mutex>
 #include <windows.h>
 
 class ModelContainer;	// forward declaration
+class ModelChild;		// forward declaration
 
-// local function
-ModelContainer* get_model(int idx);
+// local functions
+ModelContainer* get_model(int handle);
+ModelChild* get_child(const ModelContainer* container, int child_idx);
+int load_model_file(FuzzyModelBase* model, std::string file_name);
 
 #ifdef _DEBUG
 #undef THIS_FILE
@@ -30,16 +40,102 @@ static char THIS_FILE[] = __FILE__;
 #endif
 
 // Declare the classes here, rather than in a .h so everything is in one place
+//
+// THREADS: one loaded model can be used from any number of threads at once as long
+// as each thread uses its own child. ffll_set_value(), ffll_get_output_value(),
+// ffll_eval_batch() and the memo calls take no locks, they only read the handle
+// tables (see ChunkedArray) and the model (which isn't changed once it's loaded
+// and compiled), and write to the child. Creating and closing models, creating
+// children and loading take a lock. Loading, baking, ffll_set_analytic() and
+// ffll_set_resolution() change the model so they must not be called while other
+// threads are using the same model.
+//
+
+//
+// Class:	ChunkedArray
+//
+// An array that grows without ever moving its elements, so one thread can look up
+// an element while another adds one. The elements are kept in chunks of CHUNK_SIZE
+// and a chunk is allocated the first time an element in it is needed. The table of
+// chunks is a fixed size, so looking up an element is a shift, a mask and an atomic
+// load, with no lock. Growing the array (get_or_add()) must be done under the
+// owner's lock.
+//
+
+template <class T, int CHUNK_BITS, int CHUNK_COUNT> class ChunkedArray
+{
+	// everything is public cuz these are only used in this file.
+	public:
+		enum { CHUNK_SIZE = 1 << CHUNK_BITS, MAX_SIZE = CHUNK_SIZE * CHUNK_COUNT };
+
+		ChunkedArray()
+			{
+			for (int i = 0; i < CHUNK_COUNT; i++)
+				chunks[i] = NULL;
+			};
+
+		virtual ~ChunkedArray()
+			{
+			for (int i = 0; i < CHUNK_COUNT; i++)
+				delete[] chunks[i].load();
+			};
+
+		T* get(int idx) const
+			{
+			if (idx < 0 || idx >= MAX_SIZE)
+				return NULL;
+
+			T* chunk = chunks[idx >> CHUNK_BITS].load(std::memory_order_acquire);
+
+			if (chunk == NULL)
+				return NULL;
+
+			return &chunk[idx & (CHUNK_SIZE - 1)];
+			};
+
+		T* get_or_add(int idx)
+			{
+			if (idx < 0 || idx >= MAX_SIZE)
+				return NULL;
+
+			std::atomic<T*>& chunk = chunks[idx >> CHUNK_BITS];
+
+			if (chunk.load(std::memory_order_relaxed) == NULL)
+				chunk.store(new T[CHUNK_SIZE], std::memory_order_release);
+
+			return get(idx);
+			};
+
+		std::atomic<T*>	chunks[CHUNK_COUNT];	// each chunk, NULL until it's needed
+
+	private:
+
+		// don't allow copies. No function bodies for these.
+		ChunkedArray(const ChunkedArray& obj);
+		ChunkedArray& operator=(const ChunkedArray& obj);
+
+}; // end class ChunkedArray
+
 // 
 // Class:	ModelChild
 //
 // This class represents a child of the FFLL model. Each child maintains
-// an array of indexes into the values[] array for each input variable and
-// an array of DOM (Degree of Membership) for the sets in the output variable.
+// an array of indexes into the values[] array for each input variable,
+// an array of DOM (Degree of Membership) for the sets in the output variable
+// and the working memory the inference kernel uses. If the model is baked with
+// interpolation the child also keeps the position of each input value, and
+// for analytic mode (see ffll_set_analytic()) it keeps the value itself.
+// The child remembers the last output and which inputs changed since then
+// ("dirty" inputs) so if nothing changed the output isn't calculated again
+// and if only one input changed just the rules it affects are fired (see
+// FuzzyModelBase::calc_output_incremental()). It can also keep a table of
+// the outputs for the combinations of input indexes it has seen most recently
+// (see ffll_set_memo_size()).
 // This allows each child to be thread-safe and can pass this information to 
 // the FuzzyModelBase object to perform calcuations and get the defuzzified value.
 //
-// NOTE: This class currently is NOT thread-safe.
+// NOTE: a child must only be used by one thread at a time. Give each thread its
+// own child, children of the same model can be used at the same time.
 //
 
 class ModelChild
@@ -55,14 +151,28 @@ class ModelChild
 
 			out_set_dom_arr = new DOMType[num_out_sets];
 		 	var_idx_arr = new short[num_vars];
+			var_pos_arr = new RealType[num_vars];
+			var_value_arr = new RealType[num_vars];
+			dirty_arr = new bool[num_vars];
 
 			int i;	// counter
 
 			for (i = 0; i < num_vars; i++)
+				{
 			  	var_idx_arr[i] = 0;  
+				var_pos_arr[i] = 0;
+				var_value_arr[i] = 0;
+				dirty_arr[i] = false;
+				}
  
 			for (i = 0; i < num_out_sets; i++)
  			  	out_set_dom_arr[i] = 0; 
+
+			var_count = num_vars;
+			dirty_count = 0;
+			dirty_var = -1;
+			output_valid = false;
+			output = FLT_MIN;
  
 			}; // end constructor
 		virtual ~ModelChild()
@@ -71,10 +181,42 @@ class ModelChild
 		 		delete[] var_idx_arr;
 			if (out_set_dom_arr)
 				delete[] out_set_dom_arr;
+			delete[] var_pos_arr;
+			delete[] var_value_arr;
+			delete[] dirty_arr;
+			};
+
+		void set_dirty(int var_idx)
+			{
+			if (dirty_arr[var_idx])
+				return;	// already dirty
+
+			dirty_arr[var_idx] = true;
+			dirty_count++;
+			dirty_var = var_idx;
+			};
+
+		void clear_dirty()
+			{
+			for (int i = 0; i < var_count; i++)
+				dirty_arr[i] = false;
+
+			dirty_count = 0;
+			dirty_var = -1;
 			};
 
 		DOMType	*out_set_dom_arr;	// array of that holds the DOM for each set in the output variable
 		short  *var_idx_arr;		// array that holds the index into the values[] array for each input variable
+		RealType *var_pos_arr;		// array that holds the position in the values[] array for each input variable (only set if interpolating)
+		RealType *var_value_arr;	// array that holds the value of each input variable
+		InferenceScratch scratch;	// working memory for calculating the output
+		bool	*dirty_arr;			// true for each input variable whose index (or value in analytic mode) changed since the output was calculated
+		int		var_count;			// number of input variables
+		int		dirty_count;		// number of dirty input variables
+		int		dirty_var;			// last input variable that was made dirty
+		bool	output_valid;		// true if 'output' is the output for the non-dirty inputs
+		RealType output;			// last output calculated
+		OutputMemo memo;			// outputs for recently used combinations of input indexes
 	
 }; // end class ModelChild
  
@@ -86,72 +228,1034 @@ class ModelChild
 // children because model constains information that is common to all children and does
 // not change. 
 //
+// A model can also be loaded on a worker thread (see ffll_load_fcl_async()). The
+// worker loads a model object of its own, nothing else touches it until the load is
+// done, then finish_load() makes it the container's model. Until then get_model()
+// treats the handle as invalid so no other call can use the container.
+//
+// The children are kept in a ChunkedArray so a thread can look up its child while
+// another thread adds one. add_child() and finish_load() take the container's lock,
+// looking up a child or checking that the model isn't loading doesn't.
+//
+
+
+class ModelContainer
+{
+	// everything is public cuz these are only used in this file.
+	public:
+		typedef ChunkedArray<ModelChild*, 8, 256> ChildArray;	// up to 65536 children
+
+		ModelContainer()
+			{
+			model = NULL;
+			loading_model = NULL;
+			loading = false;
+			load_failed = false;
+			child_count = 0;
+			}	
+		
+		void init()
+			{
+			std::lock_guard<std::mutex> guard(lock);
+
+			// if we're re-loading, free the previous model and its children
+			free_model();
+
+			model = new FuzzyModelBase();
+			model->init();
+			load_failed = false;
+			};
+
+		void load_async(const char* file_name)
+			{
+			std::lock_guard<std::mutex> guard(lock);
+
+			// free the previous model now, the new one replaces it when it's loaded
+			free_model();
+			load_failed = false;
+
+			loading_model = new FuzzyModelBase();
+			loading_model->init();
+
+			// copy the file name, the caller's string may be gone before the worker reads it
+			pending_load = std::async(std::launch::async, load_model_file, loading_model, std::string(file_name));
+
+			loading.store(true, std::memory_order_release);
+			};
+
+		bool finish_load(bool wait)
+			{
+			if (!loading.load(std::memory_order_acquire))
+				return true;	// nothing is loading
+
+			// if another thread is finishing the load (or waiting for it) don't wait for it
+			std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+
+			if (wait)
+				guard.lock();
+			else if (!guard.try_lock())
+				return false;
+
+			if (loading_model == NULL)
+				return true;	// another thread finished it
+
+			if (!wait && pending_load.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+				return false;	// still loading
+
+			// the worker is done with the model, it's ours now. Even if the load failed
+			// we keep it so ffll_get_msg_text() can say why.
+			load_failed = (pending_load.get() != 0);
+			model = loading_model;
+			loading_model = NULL;
+
+			loading.store(false, std::memory_order_release);
+
+			return true;
+			};
+
+		int add_child(ModelChild* child)
+			{
+			std::lock_guard<std::mutex> guard(lock);
+
+			int child_idx = child_count.load(std::memory_order_relaxed);
+
+			ModelChild** entry = children.get_or_add(child_idx);
+
+			if (entry == NULL)
+				return -1;	// too many children
+
+			*entry = child;
+
+			// the child is in the array before the count says it's there
+			child_count.store(child_idx + 1, std::memory_order_release);
+
+			return child_idx;
+			};
+
+		ModelChild* get_child(int child_idx) const
+			{
+			if (child_idx < 0 || child_idx >= child_count.load(std::memory_order_acquire))
+				return NULL;
+
+			return *children.get(child_idx);
+			};
+
+		int get_child_count() const
+			{
+			return child_count.load(std::memory_order_acquire);
+			};
+
+		void free_model()
+			{
+			if (model)
+				{
+				delete model;
+				model = NULL;
+				}
+
+			// free the memory we allocated for the children
+			int count = child_count.load(std::memory_order_relaxed);
+
+			child_count.store(0, std::memory_order_release);
+
+			for (int i = 0; i < count; i++)
+				{
+				ModelChild** entry = children.get(i);
+
+				delete *entry;
+				*entry = NULL;
+				}
+
+			}; // end free_model()
+
+		virtual ~ModelContainer()
+			{
+			// the worker can't be stopped, wait for it to finish with its model
+			finish_load(true);
+			free_model();
+ 
+			}; // end destructor
+
+		ChildArray		children;				// the children for this fuzzy model
+		std::atomic<int> child_count;			// number of children in the array
+		FuzzyModelBase* model;					// model this container holds
+		FuzzyModelBase* loading_model;			// model being loaded on a worker thread, NULL if there isn't one
+		std::future<int> pending_load;			// result of the worker's load_from_fcl_file()
+		std::atomic<bool> loading;				// true from when a load is started on a worker thread until finish_load() takes the model
+		bool			load_failed;			// true if the last load on a worker thread failed
+		std::mutex		lock;					// held while loading, finishing a load or adding a child
+
+	private:
+
+		// containers are only ever referenced through the handle table, don't allow
+		// copies. No function bodies for these.
+		ModelContainer(const ModelContainer& obj);
+		ModelContainer& operator=(const ModelContainer& obj);
+
+}; // end class ModelContainer
+
+// 
+// Class:	ModelTable
+//
+// Handle table for the open models. Each slot holds a pointer to a container
+// and a "generation" that is bumped every time the slot is released. The handle
+// we give to the caller encodes both the slot index (low bits) and the generation
+// (high bits), so looking up a model is a bounds check plus one compare and a
+// handle to a model that has been closed is rejected rather than silently
+// referring to whatever model now lives in that slot.
+//
+// The first generation is 0, so the handles for the first models opened are
+// 0, 1, 2... just like the indexes returned by earlier versions.
+//
+// Released slots are kept on a free list and re-used by the next call to
+// ffll_new_model() so the table doesn't grow when studies open and close models
+// over and over.
+//
+// The slots are in a ChunkedArray so they never move, a model can be looked up
+// (without a lock) while another thread opens or closes a model. Acquiring and
+// releasing a slot take the table's lock. Closing a model frees its container
+// right away, so a handle must not be closed while other calls using it are
+// still running.
+//
+// The destructor frees any containers that are still open so we don't require
+// the user to call ffll_close_model() to free memory when the program ends.
+//
+
+class ModelTable
+{
+	// everything is public cuz these are only used in this file.
+	public:
+		enum { SLOT_BITS = 16, SLOT_MASK = (1 << SLOT_BITS) - 1, GENERATION_MASK = 0x7FFF, CHUNK_BITS = 8, CHUNK_COUNT = (SLOT_MASK + 1) >> CHUNK_BITS };
+
+		class Slot
+		{
+			public:
+				Slot() { container = NULL; generation = 0; };
+
+				std::atomic<ModelContainer*> container;	// container in this slot, NULL if the slot is not in use
+				std::atomic<int>	generation;	// incremented each time the slot is released
+		};
+
+		typedef ChunkedArray<Slot, CHUNK_BITS, CHUNK_COUNT> SlotArray;	// one slot for every slot index
+
+		ModelTable()
+			{
+			slot_count = 0;
+			live_count = 0;
+			};
+
+		virtual ~ModelTable()
+			{
+			for (int i = 0; i < slot_count; i++)
+				delete slots.get(i)->container.load();
+			}; // end destructor
+
+		int make_handle(int slot_idx) const
+			{
+			return (slots.get(slot_idx)->generation.load(std::memory_order_relaxed) << SLOT_BITS) | slot_idx;
+			};
+
+		// 'container' (if it's not NULL) gets the container that was checked. Use it
+		// rather than reading the slot again, the slot may be released at any time
+		Slot* get_slot(int handle, ModelContainer** container = NULL) const
+			{
+			if (handle < 0)
+				return NULL;
+
+			Slot* slot = slots.get(handle & SLOT_MASK);
+
+			if (slot == NULL)
+				return NULL;
+
+			// read the container once. If it's a model opened in this slot since
+			// the handle was closed, acquire() stored it after the generation was
+			// bumped so the generation check rejects the handle
+			ModelContainer* slot_container = slot->container.load(std::memory_order_acquire);
+
+			if (slot_container == NULL || 
+				slot->generation.load(std::memory_order_relaxed) != (handle >> SLOT_BITS))
+				return NULL; // stale handle
+
+			if (container)
+				*container = slot_container;
+
+			return slot;
+			};
+
+		int acquire(ModelContainer* container)
+			{
+			std::lock_guard<std::mutex> guard(lock);
+
+			int slot_idx;
+
+			if (free_slots.size())
+				{
+				slot_idx = free_slots.back();
+				free_slots.pop_back();
+				}
+			else
+				{
+				if (slots.get_or_add(slot_count) == NULL)
+					return -1; // no more slot indexes
+
+				slot_idx = slot_count++;
+				}
+
+			slots.get(slot_idx)->container.store(container, std::memory_order_release);
+			live_count++;
+
+			return make_handle(slot_idx);
+			};
+
+		int release(int handle)
+			{
+			ModelContainer* container;
+
+				{
+				std::lock_guard<std::mutex> guard(lock);
+
+				// check the handle again now that we have the lock, in case
+				// another thread closed it first
+				Slot* slot = get_slot(handle);
+
+				if (slot == NULL)
+					return -1;
+
+				container = slot->container.load(std::memory_order_relaxed);
+
+				slot->container.store(NULL, std::memory_order_release);
+				slot->generation.store((slot->generation.load(std::memory_order_relaxed) + 1) & GENERATION_MASK, std::memory_order_relaxed);
+
+				free_slots.push_back(handle & SLOT_MASK);
+				live_count--;
+				}
+
+			// free the container without the lock, it may have to wait for a load to finish
+			delete container;
+
+			return 0;
+			};
+
+		SlotArray			slots;		// the slots, indexed by the low bits of the handle
+		int					slot_count;	// number of slots that have been used
+		std::vector<int>	free_slots;	// indexes of the slots that have been released
+		std::atomic<int>	live_count;	// number of slots in use
+		std::mutex			lock;		// held while a slot is acquired or released
+
+}; // end class ModelTable
+
+ModelTable model_table; // handle table for the fuzzy models being used
+
+//
+// Function:	ffll_new_child()
+// 
+// Purpose:		Create a new child for the model passed in.
+//
+// Arguments:	
+//
+//		int		model_idx	- index of the model 
+//
+// Returns:
+//
+//		The index of the child for the model
+//		-1 - failure
+//
+// Author:	Michael Zarozinski
+// Date:	9/01
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Add the child under the container's lock so threads can
+//								create their own children at the same time
+//
+//  
+int WIN_FFLL_API ffll_new_child(int model_idx)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	if (container == NULL)
+		return -1; // invalid handle
+
+	if (container->model == NULL)
+		return -1; // make sure you call ffll_load_fcl_file() before this func.
+
+	ModelChild* child = new ModelChild(container->model);
+ 
+	int child_idx = container->add_child(child);
+
+	if (child_idx < 0)
+		delete child;	// too many children
+
+	return child_idx;
+ 
+}; // end ffll_get_child()
+
+//
+// Function:	ffll_set_value()
+// 
+// Purpose:		Set the variable's index for the value passed in.
+//
+// Arguments:	
+//
+//		int			model_idx	- index of the model 
+//		int			child_idx	- index of the child
+//		int			var_idx		- index of the variable
+//		RealType	value		- value to set the variable to
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Michael Zarozinski
+// Date:	9/01
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Save the position if the model is baked with interpolation
+// Ming-Kai Jiau	2026/10/16	Mark the variable dirty if its index changed
+// Ming-Kai Jiau	2026/10/16	Save the value for analytic mode
+//
+//  
+int WIN_FFLL_API ffll_set_value(int model_idx, int child_idx, int var_idx, double value)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	ModelChild* child = get_child(container, child_idx);
+
+	if (child == NULL)
+		return -1; // invalid handle
+
+	if (var_idx < 0 || var_idx >= container->model->get_input_var_count())
+		return -1; // invalid variable
+
+	// convert value to an index into the values[] array
+	ValuesArrCountType idx = container->model->convert_value_to_idx(var_idx, value);
+
+	if (child->var_idx_arr[var_idx] != idx)
+		{
+		child->var_idx_arr[var_idx] = idx;
+		child->set_dirty(var_idx);
+		}
+
+	// in analytic mode the output changes even if the index doesn't
+	if (child->var_value_arr[var_idx] != value)
+		{
+		child->var_value_arr[var_idx] = value;
+
+		if (container->model->is_analytic())
+			child->set_dirty(var_idx);
+		}
+
+	// if we're interpolating we need the position before it's rounded to an index
+	const BakedSurface* surface = container->model->get_baked_surface();
+
+	if (surface && surface->interpolate)
+		child->var_pos_arr[var_idx] = container->model->convert_value_to_pos(var_idx, value);
+
+	return 0;
+ 
+}; // end ffll_set_value()
+
+//
+// Function:	ffll_get_output_value()
+// 
+// Purpose:		Gets the defuzzified output value for
+//				the model/child pair passed in
+//
+// Arguments:	
+//
+//		int	model_idx	- index of the model 
+//		int	child_idx	- index of the child
+//
+// Returns:
+//
+//		Output value for the model (FLT_MIN is returned if no
+//		output sets are active)
+//
+// Author:	Michael Zarozinski
+// Date:	9/01
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Interpolate if the model is baked with interpolation
+// Ming-Kai Jiau	2026/10/16	Only re-calculate for the inputs that changed
+// Ming-Kai Jiau	2026/10/16	Look up the inputs in the child's memo table
+// Ming-Kai Jiau	2026/10/16	Use the input values in analytic mode
+//
+// 
+ 
+double WIN_FFLL_API ffll_get_output_value(int model_idx, int child_idx)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	// get the child
+	ModelChild* child = get_child(container, child_idx);
+
+	if (child == NULL)
+		return FLT_MIN; // invalid handle
+
+	if (container->model->is_analytic())
+		{
+		if (!child->output_valid || child->dirty_count)
+			{
+			child->output = container->model->calc_output_analytic(child->var_value_arr, &child->scratch);
+
+			child->clear_dirty();
+			child->output_valid = true;
+			}
+
+		return child->output;
+
+		} // end if analytic
+
+	const BakedSurface* surface = container->model->get_baked_surface();
+
+	if (surface && surface->interpolate)
+		return surface->get_interpolated_value(child->var_pos_arr);
+
+	// if no input changed, the output hasn't either
+	if (child->output_valid && child->dirty_count == 0)
+		return child->output;
+
+	// see if we've calculated the output for these inputs recently
+	// (a baked model is already a table look-up)
+	RealType memo_value;
+	bool use_memo = (surface == NULL && child->memo.get_capacity() > 0);
+
+	if (use_memo && child->memo.find(child->var_idx_arr, &memo_value))
+		{
+		// the scratch's active sets (and the output DOMs) are still for the
+		// inputs we last calculated, so the next calculation can't be incremental
+		child->scratch.active_valid = false;
+
+		child->output = memo_value;
+		child->clear_dirty();
+		child->output_valid = true;
+
+		return child->output;
+		}
+
+	// if only one input changed, re-use the partial activations of the others
+	int changed_var = (child->output_valid && child->dirty_count == 1) ? child->dirty_var : -1;
+
+	// pass in the input value for each input variable and the array
+	// of DOMs for the output sets
+	child->output = container->model->calc_output_incremental(child->var_idx_arr, changed_var, child->out_set_dom_arr, &child->scratch); 
+
+	child->clear_dirty();
+	child->output_valid = true;
+
+	if (use_memo)
+		child->memo.add(child->var_idx_arr, child->output);
+
+	return child->output;
+ 
+}; // end ffll_get_output_value()
+
+//
+// Function:	ffll_eval_batch()
+// 
+// Purpose:		Gets the defuzzified output value for each row of
+//				a matrix of crisp input values. Each row gives the same output
+//				as calling ffll_set_value() for each input then
+//				ffll_get_output_value(), without the overhead of going through
+//				the API for each value. The batch has its own working memory so
+//				the child's inputs and last output are left as they were.
+//
+// Arguments:	
+//
+//		int				model_idx	- index of the model 
+//		int				child_idx	- index of the child
+//		const double*	inputs		- rows x cols matrix of input values, stored row by row.
+//									  Column N holds the values for input variable N
+//		int				rows		- number of rows
+//		int				cols		- number of columns, must equal the number of input variables
+//		double*			outputs		- array of 'rows' elements that gets the output values
+//									  (FLT_MIN for any row where no output sets are active)
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Invalidate the child's last output
+// Ming-Kai Jiau	2026/10/16	Don't use the child's arrays for scratch space
+//
+// 
+int WIN_FFLL_API ffll_eval_batch(int model_idx, int child_idx, const double* inputs, int rows, int cols, double* outputs)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	// get the child
+	ModelChild* child = get_child(container, child_idx);
+
+	if (child == NULL)
+		return -1; // invalid handle
+
+	// give the batch its own arrays (and calc_output_batch() its own scratch object)
+	// so the child's inputs, output DOMs and active sets aren't touched
+	std::vector<short> var_idx_arr(child->var_count + 1, 0);
+	std::vector<DOMType> out_set_dom_arr(container->model->get_num_of_sets(OUTPUT_IDX) + 1, 0);
+
+	return container->model->calc_output_batch(inputs, rows, cols, &var_idx_arr[0], &out_set_dom_arr[0], outputs); 
+ 
+}; // end ffll_eval_batch()
+
+//
+// Function:	ffll_set_memo_size()
+// 
+// Purpose:		Sets the number of entries in the child's memo table. The table
+//				maps the index of each input (after ffll_set_value() quantizes the
+//				values) to the output, so ffll_get_output_value() doesn't have to
+//				calculate the output for a combination of inputs it has seen
+//				recently. When the table is full the least recently used entry is
+//				replaced. The table is disabled (size 0) when a child is created.
+//				Any entries in the table are thrown away and the hit/miss counts
+//				are reset.
+//
+// Arguments:	
+//
+//		int	model_idx	- index of the model 
+//		int	child_idx	- index of the child
+//		int	size		- max number of entries, 0 to disable the table
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure (the table is disabled)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+// 
+int WIN_FFLL_API ffll_set_memo_size(int model_idx, int child_idx, int size)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	// get the child
+	ModelChild* child = get_child(container, child_idx);
+
+	if (child == NULL)
+		return -1; // invalid handle
+
+	return child->memo.alloc(child->var_count, size);
+
+}; // end ffll_set_memo_size()
+
+//
+// Function:	ffll_get_memo_stats()
+// 
+// Purpose:		Gets the number of times ffll_get_output_value() found the inputs
+//				in the child's memo table (hits) and the number of times it had to
+//				calculate the output (misses) since ffll_set_memo_size() was called.
+//
+// Arguments:	
+//
+//		int			model_idx	- index of the model 
+//		int			child_idx	- index of the child
+//		long long*	hits		- gets the number of hits (may be NULL)
+//		long long*	misses		- gets the number of misses (may be NULL)
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+// 
+int WIN_FFLL_API ffll_get_memo_stats(int model_idx, int child_idx, long long* hits, long long* misses)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	// get the child
+	ModelChild* child = get_child(container, child_idx);
+
+	if (child == NULL)
+		return -1; // invalid handle
+
+	if (hits)
+		*hits = child->memo.get_hits();
+	if (misses)
+		*misses = child->memo.get_misses();
+
+	return 0;
+
+}; // end ffll_get_memo_stats()
+
+//
+// Function:	ffll_bake_model()
+// 
+// Purpose:		Calculates the output of the model for every combination of
+//				input values (each input is quantized to its variable's x_array_count values)
+//				and stores them in a table so ffll_get_output_value() and
+//				ffll_eval_batch() are a table look-up regardless of the number
+//				of rules. Only models with a few inputs can be baked (3 with
+//				the default quantization). Call this after loading the model.
+//
+// Arguments:	
+//
+//		int	model_idx	- index of the model 
+//		int	interpolate	- if non-zero the output is interpolated between the
+//						  quantized input values rather than using the nearest one
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure (the model is left unbaked)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Walk the children in the chunked child array
+//
+// 
+int WIN_FFLL_API ffll_bake_model(int model_idx, int interpolate)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	if (container == NULL || container->model == NULL)
+		return -1; // invalid handle
+
+	if (container->model->bake(interpolate != 0))
+		return -1;
+
+	// existing children need the positions of their inputs if we interpolate
+	// but they only have the indexes so far, fill in the positions from them
+	if (interpolate)
+		{
+		int num_vars = container->model->get_input_var_count();
+
+		for (int i = 0; i < container->get_child_count(); i++)
+			{
+			ModelChild* child = container->get_child(i);
+
+			for (int j = 0; j < num_vars; j++)
+				child->var_pos_arr[j] = child->var_idx_arr[j];
+			}
+		}
+
+	return 0;
+
+}; // end ffll_bake_model()
+
+//
+// Function:	ffll_set_analytic()
+// 
+// Purpose:		Turns analytic mode on or off. In analytic mode the membership
+//				functions are evaluated in double precision from their nodes so
+//				the inputs and DOMs aren't quantized (see AnalyticEngine), the
+//				baked table and memo tables aren't used. Call this after loading
+//				the model.
+//
+// Arguments:	
+//
+//		int	model_idx	- index of the model 
+//		int	analytic	- non-zero to turn analytic mode on, 0 to turn it off
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure (analytic mode is off)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Walk the children in the chunked child array
+//
+// 
+int WIN_FFLL_API ffll_set_analytic(int model_idx, int analytic)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	if (container == NULL || container->model == NULL)
+		return -1; // invalid handle
+
+	// the children's outputs were calculated in the other mode
+	for (int i = 0; i < container->get_child_count(); i++)
+		container->get_child(i)->output_valid = false;
+
+	return container->model->set_analytic(analytic != 0);
+
+}; // end ffll_set_analytic()
+
+//
+// Function:	ffll_set_resolution()
+// 
+// Purpose:		Sets the number of values a variable is quantized to (201 unless
+//				the FCL file has a RESOLUTION for the variable). A variable that 
+//				needs fine control can have more values without making every
+//				variable in the model bigger. The model is unbaked and the
+//				children's inputs are re-quantized from their values. The
+//				model is compiled again right away so calculating an output
+//				never has to (and never changes the model).
+//
+// Arguments:	
+//
+//		int	model_idx	- index of the model 
+//		int	var_idx		- index of the variable, -1 for the output variable
+//		int	count		- number of values (2 to 32767)
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Compile the model before it's used again
+//
+// 
+int WIN_FFLL_API ffll_set_resolution(int model_idx, int var_idx, int count)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	if (container == NULL || container->model == NULL)
+		return -1; // invalid handle
+
+	if (container->model->set_x_array_count(var_idx, count) || container->model->compile())
+		return -1;
+
+	// the children's indexes (and everything calculated from them) are out of date
+	int num_vars = container->model->get_input_var_count();
+
+	for (int i = 0; i < container->get_child_count(); i++)
+		{
+		ModelChild* child = container->get_child(i);
+
+		for (int j = 0; j < num_vars; j++)
+			{
+			child->var_idx_arr[j] = container->model->convert_value_to_idx(j, child->var_value_arr[j]);
+			child->set_dirty(j);
+			}
+
+		child->output_valid = false;
+		child->scratch.active_valid = false;
+		child->scratch.partial_var = -1;
+		child->memo.clear();
+		}
+
+	return 0;
+
+}; // end ffll_set_resolution()
+
+ 
+//
+// Function:	ffll_load_fcl_file()
+// 
+// Purpose:		This function initializes the model and
+//				loads the FCL file passed in
+//
+// Arguments:	
+//
+//		int			model_idx	- index of the model 
+//		const char*	file		- file name and path of the file to load
+//
+// Returns:
+//
+//		The index of the model on success
+//		-1 on error
+//
+// Author:	Michael Zarozinski
+// Date:	9/01
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+// 
+ 
+int WIN_FFLL_API ffll_load_fcl_file(int model_idx, const char* file)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	if (container == NULL)
+		return -1; // invalid handle
+
+	// perform initialization
+	container->init();
+
+	// load the FCL file passed in
+	if (container->model->load_from_fcl_file(file))
+ 		return -1;
+
+	return model_idx;
+
+}; // end ffll_load_fcl_file()
+
+
+//
+// Function:	ffll_load_fcl_string()
+// 
+// Purpose:		This function initializes the model and
+//				loads the FCL file passed in
+//
+// Arguments:	
+//
+//		int			model_idx	- index of the model 
+//		const char*	fcl_str		- string input of fuzzy control language
+//
+// Returns:
+//
+//		The index of the model on success
+//		-1 on error
+//
+// Author:	Ming-Kai Jiau
+// Date:	2019/03/30
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+// 
+
+int WIN_FFLL_API ffll_load_fcl_string(int model_idx, const char* fcl_str)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	if (container == NULL)
+		return -1; // invalid handle
+
+	// perform initialization
+	container->init();
+
+	// load the FCL file passed in
+	if (container->model->load_from_fcl_string(fcl_str))
+		return -1;
+
+	return model_idx;
+
+}; // end ffll_load_fcl_string()
+
+
+//
+// Function:	ffll_load_fcl_buffer()
+// 
+// Purpose:		This function initializes the model and loads FCL text
+//				from a buffer that doesn't need to be NULL terminated.
+//				The text is parsed in place, it isn't copied, and the
+//				buffer can be freed (or reused) as soon as this returns.
+//
+// Arguments:	
+//
+//		int			model_idx	- index of the model 
+//		const char*	data		- fuzzy control language text
+//		size_t		length		- number of characters in the text
+//
+// Returns:
+//
+//		The index of the model on success
+//		-1 on error
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+// 
+
+int WIN_FFLL_API ffll_load_fcl_buffer(int model_idx, const char* data, size_t length)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	if (container == NULL)
+		return -1; // invalid handle
+
+	// perform initialization
+	container->init();
+
+	if (container->model->load_from_fcl_buffer(data, length))
+		return -1;
 
+	return model_idx;
 
-class ModelContainer
-{
-	// everything is public cuz these are only used in this file.
-	public:
-		ModelContainer()
-			{
-			model = NULL;
-			}	
-		
-		void init()
-			{
-			model = new FuzzyModelBase();
-			model->init();
-			};
+}; // end ffll_load_fcl_buffer()
 
-	     // Copy constructor
-        ModelContainer(const ModelContainer& obj) 
-			{
-			*this = obj; 
-			};
 
-        // Assignment operator
-        ModelContainer& operator=(const ModelContainer& obj)
-			{
-			model = obj.model;
+//
+// Function:	ffll_load_fcl_async()
+// 
+// Purpose:		This function starts loading an FCL file on a worker
+//				thread and returns right away. Parsing the file and
+//				building the tables (which can take a while for large
+//				rule bases) is done by the worker. Until the load is
+//				done every other call for the model fails as if the
+//				handle were invalid, use ffll_model_ready() to poll
+//				or ffll_wait_model() to wait for it. Closing the model
+//				waits for the load to finish.
+//
+// Arguments:	
+//
+//		int			model_idx	- index of the model 
+//		const char*	file		- file name and path of the file to load
+//
+// Returns:
+//
+//		The index of the model if the load was started
+//		-1 on error (invalid handle, or a load is already running)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+// 
 
-			return *this;
-			};  
-	
-		virtual ~ModelContainer()
-			{
-			if (model)
-				{
-				delete model;
-				model = NULL;
-				}
+int WIN_FFLL_API ffll_load_fcl_async(int model_idx, const char* file)
+{
+	ModelContainer* container = get_model(model_idx);
 
-			// free the memory we allocated for the children
+	if (container == NULL)
+		return -1; // invalid handle (or already loading)
 
-			std::vector<ModelChild*>::iterator it = child_list.begin();
-			for (int i=0; it < child_list.end(); ++i, it++)
-				{
-				delete child_list[i];
-				}
- 
-			}; // end destructor
+	if (file == NULL)
+		return -1;
 
-	 	std::vector<ModelChild*> child_list;	// list of the children for this fuzzy model
-		FuzzyModelBase* model;					// model this container holds
+	container->load_async(file);
 
-}; // end class ModelContainer
+	return model_idx;
 
- 
-// using a vector array to hold open models. It holds the actual object 
-// (as opposed to a pointer to it) so the destructor is called when the program ends
-// and we don't have to require the user to call a "close_model" type function to free memory.
+}; // end ffll_load_fcl_async()
 
-// 4/03 changed to LIST to avoid destructor calls when inserting models.
-std::list<ModelContainer > model_list; // list of the fuzzy models being used
 
 //
-// Function:	ffll_new_child()
+// Function:	ffll_model_ready()
 // 
-// Purpose:		Create a new child for the model passed in.
+// Purpose:		Checks if a model started with ffll_load_fcl_async()
+//				is done loading, without waiting for it.
 //
 // Arguments:	
 //
@@ -159,117 +1263,131 @@ std::list<ModelContainer > model_list; // list of the fuzzy models being used
 //
 // Returns:
 //
-//		The index of the child for the model
-//		non-zero - failure
+//		1 - the model is loaded and can be used
+//		0 - the model is still loading
+//		-1 - the load failed (ffll_get_msg_text() says why), nothing
+//			 has been loaded or the handle is invalid
 //
-// Author:	Michael Zarozinski
-// Date:	9/01
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Use the container the handle table checked
 //
-//  
-int WIN_FFLL_API ffll_new_child(int model_idx)
+// 
+
+int WIN_FFLL_API ffll_model_ready(int model_idx)
 {
-	ModelContainer* container = get_model(model_idx);
+	ModelContainer* container;
 
-	assert(container->model != NULL); // make sure you call ffll_load_fcl_file() before this func.
+	if (model_table.get_slot(model_idx, &container) == NULL)
+		return -1; // invalid handle
 
-	ModelChild* child = new ModelChild(container->model);
- 
-	container->child_list.push_back(child);
+	if (!container->finish_load(false))
+		return 0;	// still loading
+
+	if (container->model == NULL || container->load_failed)
+		return -1;
+
+	return 1;
+
+}; // end ffll_model_ready()
 
-	return container->child_list.size() - 1;
- 
-}; // end ffll_get_child()
 
 //
-// Function:	ffll_set_value()
+// Function:	ffll_wait_model()
 // 
-// Purpose:		Set the variable's index for the value passed in.
+// Purpose:		Waits for a model started with ffll_load_fcl_async()
+//				to finish loading. If the model isn't loading this
+//				returns right away.
 //
 // Arguments:	
 //
-//		int			model_idx	- index of the model 
-//		int			child_idx	- index of the child
-//		int			var_idx		- index of the variable
-//		RealType	value		- value to set the variable to
+//		int		model_idx	- index of the model 
 //
 // Returns:
 //
-//		0 - success
-//		non-zero - failure
+//		The index of the model if it's loaded
+//		-1 on error (the load failed, nothing has been loaded or the handle is invalid)
 //
-// Author:	Michael Zarozinski
-// Date:	9/01
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Use the container the handle table checked
 //
-//  
-int WIN_FFLL_API ffll_set_value(int model_idx, int child_idx, int var_idx, double value)
+// 
+
+int WIN_FFLL_API ffll_wait_model(int model_idx)
 {
-	ModelContainer* container = get_model(model_idx);
+	ModelContainer* container;
 
-	ModelChild* child = container->child_list[child_idx];
+	if (model_table.get_slot(model_idx, &container) == NULL)
+		return -1; // invalid handle
 
-	// convert value to an index into the values[] array
-	ValuesArrCountType idx = container->model->convert_value_to_idx(var_idx, value);
- 		
-	child->var_idx_arr[var_idx] = idx;
+	container->finish_load(true);
+
+	if (container->model == NULL || container->load_failed)
+		return -1;
+
+	return model_idx;
+
+}; // end ffll_wait_model()
 
-	return 0;
- 
-}; // end ffll_set_value()
 
 //
-// Function:	ffll_get_output_value()
+// Function:	ffll_save_compiled()
 // 
-// Purpose:		Gets the defuzzified output value for
-//				the model/child pair passed in
+// Purpose:		Saves the model in its compiled (binary) form so it can be loaded
+//				with ffll_load_compiled() without parsing the FCL file or calculating
+//				the membership functions again. The file can only be read by
+//				this version of the library on the same kind of machine.
 //
 // Arguments:	
 //
-//		int	model_idx	- index of the model 
-//		int	child_idx	- index of the child
+//		int			model_idx	- index of the model 
+//		const char*	file		- file name and path of the file to save
 //
 // Returns:
 //
-//		Output value for the model (FLT_MIN is returned if no
-//		output sets are active)
+//		0 - success
+//		-1 on error
 //
-// Author:	Michael Zarozinski
-// Date:	9/01
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
 // 
 // Modification History
 // Author	Date		Modification
 // ------	----		------------
 //
 // 
- 
-double WIN_FFLL_API ffll_get_output_value(int model_idx, int child_idx)
+
+int WIN_FFLL_API ffll_save_compiled(int model_idx, const char* file)
 {
 	ModelContainer* container = get_model(model_idx);
 
-	// get the child
-	ModelChild* child = container->child_list[child_idx];
+	if (container == NULL || container->model == NULL)
+		return -1; // invalid handle
 
-	// pass in the input value for each input variable and the array
-	// of DOMs for the output sets
-	RealType out_val = container->model->calc_output(child->var_idx_arr, child->out_set_dom_arr); 
+	if (container->model->save_compiled(file))
+		return -1;
+
+	return 0;
+
+}; // end ffll_save_compiled()
 
-	return out_val;
- 
-}; // end ffll_get_output_value()
 
- 
 //
-// Function:	ffll_load_fcl_file()
+// Function:	ffll_load_compiled()
 // 
-// Purpose:		This function initializes the model and
-//				loads the FCL file passed in
+// Purpose:		This function initializes the model and loads a compiled
+//				model file saved by ffll_save_compiled(). The model calculates
+//				the same outputs as the FCL file it was saved from, and can be
+//				baked, but can't be put in analytic mode or have its resolution changed.
 //
 // Arguments:	
 //
@@ -281,45 +1399,47 @@ double WIN_FFLL_API ffll_get_output_value(int model_idx, int child_idx)
 //		The index of the model on success
 //		-1 on error
 //
-// Author:	Michael Zarozinski
-// Date:	9/01
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
 // 
 // Modification History
 // Author	Date		Modification
 // ------	----		------------
 //
 // 
- 
-int WIN_FFLL_API ffll_load_fcl_file(int model_idx, const char* file)
+
+int WIN_FFLL_API ffll_load_compiled(int model_idx, const char* file)
 {
 	ModelContainer* container = get_model(model_idx);
 
-	// we have a pointer to the container, so any modifications we
-	// make will be in the list. If we used the [] operator here,
-	// we'd get a COPY of the model and any changes wouldn't be permanent.
+	if (container == NULL)
+		return -1; // invalid handle
 
 	// perform initialization
 	container->init();
 
-	// load the FCL file passed in
-	if (container->model->load_from_fcl_file(file))
- 		return -1;
+	if (container->model->load_compiled(file))
+		return -1;
 
 	return model_idx;
 
-}; // end ffll_load_fcl_file()
+}; // end ffll_load_compiled()
 
 
 //
-// Function:	ffll_load_fcl_string()
+// Function:	ffll_map_compiled()
 // 
-// Purpose:		This function initializes the model and
-//				loads the FCL file passed in
+// Purpose:		This function initializes the model and maps a compiled model
+//				file saved by ffll_save_compiled() into memory read-only. Unlike
+//				ffll_load_compiled() the file isn't copied, outputs are calculated
+//				straight from the mapping so every process that maps the same file
+//				shares one copy of the model. The file stays mapped (and on
+//				Windows can't be written to) until the model is closed.
 //
 // Arguments:	
 //
 //		int			model_idx	- index of the model 
-//		const char*	fcl_str		- string input of fuzzy control language
+//		const char*	file		- file name and path of the file to map
 //
 // Returns:
 //
@@ -327,7 +1447,7 @@ int WIN_FFLL_API ffll_load_fcl_file(int model_idx, const char* file)
 //		-1 on error
 //
 // Author:	Ming-Kai Jiau
-// Date:	2019/03/30
+// Date:	2026/10/16
 // 
 // Modification History
 // Author	Date		Modification
@@ -335,24 +1455,22 @@ int WIN_FFLL_API ffll_load_fcl_file(int model_idx, const char* file)
 //
 // 
 
-int WIN_FFLL_API ffll_load_fcl_string(int model_idx, const char* fcl_str)
+int WIN_FFLL_API ffll_map_compiled(int model_idx, const char* file)
 {
 	ModelContainer* container = get_model(model_idx);
 
-	// we have a pointer to the container, so any modifications we
-	// make will be in the list. If we used the [] operator here,
-	// we'd get a COPY of the model and any changes wouldn't be permanent.
+	if (container == NULL)
+		return -1; // invalid handle
 
 	// perform initialization
 	container->init();
 
-	// load the FCL file passed in
-	if (container->model->load_from_fcl_string(fcl_str))
+	if (container->model->map_compiled(file))
 		return -1;
 
 	return model_idx;
 
-}; // end ffll_load_fcl_string()
+}; // end ffll_map_compiled()
 
 
 //
@@ -382,6 +1500,9 @@ const char* WIN_FFLL_API ffll_get_msg_textA(int model_idx)
 {
 	ModelContainer* container = get_model(model_idx);
 
+	if (container == NULL || container->model == NULL)
+		return NULL;
+
 	return container->model->get_msg_textA();
 
 }; // end ffll_get_msg_textA()
@@ -413,6 +1534,9 @@ const wchar_t* WIN_FFLL_API ffll_get_msg_textW(int model_idx)
 {
 	ModelContainer* container = get_model(model_idx);
 
+	if (container == NULL || container->model == NULL)
+		return NULL;
+
 	return container->model->get_msg_text();
  
 }; // end ffll_get_msg_textW()
@@ -421,9 +1545,9 @@ const wchar_t* WIN_FFLL_API ffll_get_msg_textW(int model_idx)
 //
 // Function:	ffll_new_model()
 // 
-// Purpose:		This function creates a new FuzzyModleBase object, inserts
-//				it into the managment list and returns the index of the new
-//				model into the list
+// Purpose:		This function creates a new ModelContainer object, inserts
+//				it into the handle table and returns the handle of the new
+//				model
 //
 // Arguments:	
 //
@@ -431,88 +1555,156 @@ const wchar_t* WIN_FFLL_API ffll_get_msg_textW(int model_idx)
 //
 // Returns:
 //
-//		The index of the model in the list
+//		The handle of the model
+//		-1 if the handle table is full
 //
 // Author:	Michael Zarozinski
 // Date:	9/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Use the handle table rather than the list
+// Ming-Kai Jiau	2026/10/16	Re-use slots freed by ffll_close_model()
 //
 // 
 int WIN_FFLL_API ffll_new_model()
 {
-	// create an empty container and put it at the back
-	// of our list. 
-	ModelContainer container;  
-  
-	// add it to the list of open models
-	model_list.push_back(container); 
- 
-	return model_list.size() - 1;
+	// create an empty container and put it in a free
+	// slot of our table. 
+	ModelContainer* container = new ModelContainer;
+
+	int handle = model_table.acquire(container);
+
+	if (handle < 0)
+		delete container;
+
+	return handle;
 
 }; // end ffll_new_model()
 
 //
 // Function:	get_model()
 // 
-// Purpose:		Returns a pointer to the model container at
-//				the index passed in. This is a LOCAL function
+// Purpose:		Returns a pointer to the model container for
+//				the handle passed in. This is a LOCAL function
 //				and is not exported.
 //
 // Arguments:	
 //
-//		int idx - index of the model to return
+//		int handle - handle of the model to return
 //
 // Returns:
 //
-//		ModelContainer*  - pointer to the model
+//		ModelContainer*  - pointer to the model, NULL if the handle is
+//						   out of range or refers to a model that's been closed
 //
 // Author:	Michael Zarozinski
 // Date:	9/01
 // 
 // Modification History
-// Author		Date		Modification
-// ------		----		------------
-// Michael Z	4/03		Changed to use list iterator
-// Michael Z	4/03		Changed the while loop so it returns the correct model
-//
-ModelContainer* get_model(int idx)
+// Author			Date		Modification
+// ------			----		------------
+// Michael Z		4/03		Changed to use list iterator
+// Michael Z		4/03		Changed the while loop so it returns the correct model
+// Ming-Kai Jiau	2026/10/16	Index into the handle table rather than walking the list
+// Ming-Kai Jiau	2026/10/16	Don't return models that are still loading on a worker thread
+// Ming-Kai Jiau	2026/10/16	Use the container the handle table checked
+//
+ModelContainer* get_model(int handle)
 {
-	// we have to use an interator (as opposed to just 
-	// using model_list[idx]) so we can return a pointer
-	// to the container. If we used the [] operator we'd
-	// get a copy and writing a "deep copy" for that object
-	// would introduce far more places things can go wrong.
-   
-  	std::list<ModelContainer>::iterator it;
- 
-	int tmp_idx = idx;
+	ModelContainer* container;
 
-	it = model_list.begin();
+	if (model_table.get_slot(handle, &container) == NULL)
+		return NULL;
 
-	ModelContainer* ret_val = &(*it);
-
-	while(tmp_idx--)
-		{
-		it++;
-		ret_val = &(*it);
-		}
+	// a model that's loading can't be used until it's done
+	if (!container->finish_load(false))
+		return NULL;
 
-	return ret_val;  
+	return container;  
 				
 } // end get_model()
+
+//
+// Function:	get_child()
+// 
+// Purpose:		Returns a pointer to the child at the index passed in
+//				for the container. This is a LOCAL function
+//				and is not exported.
+//
+// Arguments:	
+//
+//		const ModelContainer*	container	- container the child belongs to (may be NULL)
+//		int						child_idx	- index of the child to return
+//
+// Returns:
+//
+//		ModelChild*  - pointer to the child, NULL if the index is invalid
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Look the child up without a lock (see ModelContainer)
+//
+//
+ModelChild* get_child(const ModelContainer* container, int child_idx)
+{
+	if (container == NULL)
+		return NULL;
+
+	return container->get_child(child_idx);
+
+} // end get_child()
+
+//
+// Function:	load_model_file()
+// 
+// Purpose:		Loads an FCL file into a model on a worker thread (see
+//				ffll_load_fcl_async()). This is a LOCAL function
+//				and is not exported.
+//
+// Arguments:	
+//
+//		FuzzyModelBase*	model		- model to load, nothing else uses it until we return
+//		std::string		file_name	- file name and path of the file to load
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int load_model_file(FuzzyModelBase* model, std::string file_name)
+{
+	return model->load_from_fcl_file(file_name.c_str());
+
+} // end load_model_file()
  
 
 //
 // Function:	ffll_close_model()
 // 
-// Purpose:		Closes the model for the index passed in.
+// Purpose:		Closes the model for the handle passed in. This frees the
+//				model and all its children and releases the slot so the
+//				handle can't be used again. If the model is loading on a
+//				worker thread (see ffll_load_fcl_async()) this waits for
+//				the load to finish first. The model must not be closed while
+//				another thread is still calling a function with its handle.
 //
 // Arguments:	
 //
-//		int		model_idx	- index of the model 
+//		int		model_idx	- handle of the model 
 //
 // Returns:
 //
@@ -523,19 +1715,84 @@ ModelContainer* get_model(int idx)
 // Date:	2/02
 // 
 // Modification History
-//	Author		Date		Modification
-//	------		----		------------
-//	Michael Z	4/15/03		Ignore null model... 
+//	Author			Date		Modification
+//	------			----		------------
+//	Michael Z		4/15/03		Ignore null model... 
+//	Ming-Kai Jiau	2026/10/16	Release the slot in the handle table
+//	Ming-Kai Jiau	2026/10/16	Free loaded models too, not just empty ones
+//	Ming-Kai Jiau	2026/10/16	Wait for a load on a worker thread
+//	Ming-Kai Jiau	2026/10/16	Check the handle under the table's lock
 //  
 int WIN_FFLL_API ffll_close_model(int model_idx)
 {
-	ModelContainer* container = get_model(model_idx);
-
-	if (container->model != NULL)
-		return 0;
-
- 	delete container;
+	if (model_table.release(model_idx))
+		return -1; // invalid handle (or the model's already closed)
 
 	return 0;
  
 }; // end ffll_close_model()
+
+//
+// Function:	ffll_live_model_count()
+// 
+// Purpose:		Returns the number of models that are open (created
+//				with ffll_new_model() and not yet closed). This lets
+//				callers that open and close models repeatedly check
+//				they aren't leaking them.
+//
+// Arguments:	
+//
+//		none
+//
+// Returns:
+//
+//		number of open models
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//  
+int WIN_FFLL_API ffll_live_model_count()
+{
+	return model_table.live_count;
+ 
+}; // end ffll_live_model_count()
+
+//
+// Function:	ffll_get_input_count()
+// 
+// Purpose:		Returns the number of input variables in the model, the
+//				var_idx passed to ffll_set_value() goes from 0 to one
+//				less than this.
+//
+// Arguments:	
+//
+//		int		model_idx	- handle of the model 
+//
+// Returns:
+//
+//		number of input variables
+//		-1 - failure (invalid handle, or the model is still loading)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//  
+int WIN_FFLL_API ffll_get_input_count(int model_idx)
+{
+	ModelContainer* container = get_model(model_idx);
+
+	if (container == NULL || container->model == NULL)
+		return -1; // invalid handle (or nothing loaded)
+
+	return container->model->get_input_var_count();
+ 
+}; // end ffll_get_input_count()
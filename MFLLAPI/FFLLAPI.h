@@ -45,6 +45,18 @@ int WIN_FFLL_API ffll_close_model(int model_idx) ;
 int WIN_FFLL_API ffll_new_child(int model_idx) ;
 int WIN_FFLL_API ffll_load_fcl_file(int model_idx, const char* file); 
 int WIN_FFLL_API ffll_load_fcl_string(int model_idx, const char* fcl_str); 
+int WIN_FFLL_API ffll_load_fcl_buffer(int model_idx, const char* data, size_t length);
+int WIN_FFLL_API ffll_load_fcl_async(int model_idx, const char* file);
+int WIN_FFLL_API ffll_model_ready(int model_idx);
+int WIN_FFLL_API ffll_wait_model(int model_idx);
+int WIN_FFLL_API ffll_live_model_count();
+int WIN_FFLL_API ffll_get_input_count(int model_idx);
+int WIN_FFLL_API ffll_bake_model(int model_idx, int interpolate);
+int WIN_FFLL_API ffll_set_analytic(int model_idx, int analytic);
+int WIN_FFLL_API ffll_set_resolution(int model_idx, int var_idx, int count);
+int WIN_FFLL_API ffll_save_compiled(int model_idx, const char* file);
+int WIN_FFLL_API ffll_load_compiled(int model_idx, const char* file);
+int WIN_FFLL_API ffll_map_compiled(int model_idx, const char* file);
 
 // MFLL APIs
 //double WIN_FFLL_API MFLLFuzzyInference(LPSTR fcl_str, double* crisp_inputs, long input_size);
@@ -57,6 +69,9 @@ const char* WIN_FFLL_API ffll_get_msg_textA(int model_idx);
 
 int WIN_FFLL_API ffll_set_value(int model_idx, int child_idx, int var_idx, double value);
 double WIN_FFLL_API ffll_get_output_value(int model_idx, int child_idx);
+int WIN_FFLL_API ffll_eval_batch(int model_idx, int child_idx, const double* inputs, int rows, int cols, double* outputs);
+int WIN_FFLL_API ffll_set_memo_size(int model_idx, int child_idx, int size);
+int WIN_FFLL_API ffll_get_memo_stats(int model_idx, int child_idx, long long* hits, long long* misses);
 
 } // end extern "C" for FFLL api
   
@@ -48,7 +48,16 @@ wchar_t* errors[] =
 	L"Invalid Inference Method",
 	L"Error Opening File",
 	L"Error Reading Variable Minimum Value",
-	L"Error Reading Variable Maximum Value"
+	L"Error Reading Variable Maximum Value",
+	L"Error Reading FCL String",
+	L"Too Many Rule Combinations",
+	L"Model Has No Output Or Too Many Inputs To Bake",
+	L"Model Has No Output Variable",
+	L"Invalid Variable Resolution",
+	L"Variable Index Out Of Range",
+	L"Error Writing File",
+	L"Invalid Or Damaged Compiled Model File",
+	L"Model Was Loaded Precompiled And Can Not Be Changed"
 	};
 wchar_t* warnings[] = 
 	{ 
@@ -244,6 +253,41 @@ void FFLLBase::set_msg_text(int msg_id) const
 
 }; // end FFLLBase::set_msg_text()
 
+//
+// Function:	set_msg_text()
+// 
+// Purpose:		Set the msg_text string to a message and where in a file the
+//				problem is, for errors found while reading a file.
+//
+// Arguments:
+//
+//		int msg_id	-	identifier of the message. This is converted to text via the
+//						load_string() function.
+//		int line	-	line the problem is on (starting at 1)
+//		int column	-	column the problem is in (starting at 1)
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//	
+void FFLLBase::set_msg_text(int msg_id, int line, int column) const
+{
+	wchar_t position[64];	// where the problem is
+
+	swprintf(position, sizeof(position) / sizeof(wchar_t), L" At Line %d, Column %d", line, column);
+
+	set_msg_text(std::wstring(load_string(msg_id)) + position);
+
+}; // end FFLLBase::set_msg_text()
+
 
 
 //
@@ -435,17 +479,39 @@ int& NodeValue::operator=(const int& _value)
 // within the appropriate bounds.  The validiation is built-in so we don't have to
 // validate the values every time - that would be a pain.
  
+// each variable has its own number of elements in the values[] array, the
+// node doesn't know its variable so the member func sets the max index when
+// it allocates the nodes (see MemberFuncBase::alloc_nodes()).
+
+XNodeValue::XNodeValue()
+{
+	value = 0;
+	max_idx = MAX_X_ARRAY_COUNT - 1;
+};
+
 int& XNodeValue::operator=(const int& _value)
 {
 	return NodeValue::operator =(_value);
 };
+
+XNodeValue& XNodeValue::operator=(const XNodeValue& _value)
+{
+	NodeValue::operator =(_value.value);
+	return *this;
+};
+
+void XNodeValue::set_max_idx(int _max_idx)
+{
+	max_idx = _max_idx;
+	validate();
+};
  
 void XNodeValue::validate()
 {
 	if (value < 0)
 		value = 0;
-	if (value >= FuzzyVariableBase::get_x_array_count())
-		value = FuzzyVariableBase::get_x_array_max_idx();
+	if (value > max_idx)
+		value = max_idx;
 };
 
 
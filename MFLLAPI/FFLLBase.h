@@ -54,6 +54,14 @@
 #define ERR_VAR_MIN_VALUE			ERROR_BASE + 14
 #define ERR_VAR_MAX_VALUE			ERROR_BASE + 15
 #define ERR_READING_STRING			ERROR_BASE + 16
+#define ERR_TOO_MANY_RULES			ERROR_BASE + 17
+#define ERR_CANT_BAKE_MODEL			ERROR_BASE + 18
+#define ERR_NO_OUTPUT_VAR			ERROR_BASE + 19
+#define ERR_INVALID_RESOLUTION		ERROR_BASE + 20
+#define ERR_INVALID_VAR_IDX			ERROR_BASE + 21
+#define ERR_WRITING_FILE			ERROR_BASE + 22
+#define ERR_INVALID_COMPILED_FILE	ERROR_BASE + 23
+#define ERR_MODEL_PRECOMPILED		ERROR_BASE + 24
 
 
 #define WARNING_BASE				4000
@@ -122,6 +130,10 @@ const RuleArrayType NO_RULE = 255;	// 255 is the MAX that an unsigned char can h
 typedef int ValuesArrCountType;
 ///typedef unsigned short ValuesArrCountType;
 
+// most elements a variable's values[] array can have. The indexes are passed around
+// as shorts so this is the largest value a short can hold.
+const ValuesArrCountType MAX_X_ARRAY_COUNT = 32767;
+
 // The DOM (Degree of Membership) is a value between 0 and MAX_DOM.  we could
 // have used a float and represened (as most FL systems do) the value from 0 to 1
 // but that would just be a waste of memory.  Using an unsigned char gives us
@@ -129,6 +141,14 @@ typedef int ValuesArrCountType;
 // 4 bytes!
 //typedef unsigned char DOMType;
 typedef int DOMType;
+
+// The membership tables store the DOMs in 8 bits (that's why dom_array_count can't be
+// larger than UCHAR_MAX). Calculations still use DOMType.
+typedef unsigned char PackedDOMType;
+
+// extra elements at the end of a variable's DOM table so the DOM of the last set can
+// be read as part of a 32 bit value without reading past the end (see BatchKernel)
+const int DOM_TABLE_PADDING = sizeof(int) - sizeof(PackedDOMType);
  	
 // create classes for the 'x' and 'y' node points,
 // this allows us to overload the '=' operator and EASILY
@@ -159,11 +179,16 @@ class  NodeValue
 class  XNodeValue : public NodeValue
 {
 	public:
+		XNodeValue();
  		int& operator=(const int& _value); // can't be inherited
+		XNodeValue& operator=(const XNodeValue& _value); // keeps our max_idx
+		void set_max_idx(int _max_idx);
 
 	private:
 		void validate();
 
+		int max_idx;	// largest index for the variable's values[] array
+
 }; // end class XNodeValue
 
 class  YNodeValue : public NodeValue
@@ -206,6 +231,9 @@ using namespace FFLLDatatypes ;
 // propagate it up the classes.  For example if an error occurs in a set the calling
 // function should detect the error and set the msg_text for the set's variable, then the caller
 // for the variable object should set it for the model object - until it's shown to the user.
+// msg_text and error_read aren't protected by a lock. They're only written while a model
+// is loaded or changed (and read by get_msg_text()), calculating the output of a
+// compiled model never touches them, so children can calculate from any thread.
 //
 
 class  FFLLBase
@@ -219,6 +247,7 @@ class  FFLLBase
  		const wchar_t* get_msg_text() const;
  
 		void set_msg_text(int msg_id) const;
+		void set_msg_text(int msg_id, int line, int column) const;
 		void set_msg_text(const std::wstring _text) const;
 		void set_msg_text(const wchar_t* _text = NULL) const;
 
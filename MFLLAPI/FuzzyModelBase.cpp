@@ -15,11 +15,27 @@
 #include "FuzzyOutVariable.h"
 #include "RuleArray.h"
 #include "DefuzzVarObj.h"
+#include "InferenceScratch.h"
+#include "BakedSurface.h"
+#include "BatchKernel.h"
+#include "AnalyticEngine.h"
+#include "FuzzyOutSet.h"
+#include "COGDefuzzSetObj.h"
+#include "MOMDefuzzSetObj.h"
+#include "WADefuzzSetObj.h"
+#include "MemberFuncBase.h"
+#include "CompiledModel.h"
+#include "MappedFile.h"
+#include "FCLTokenizer.h"
 
 //#include <fstream> // ??? moved to .h
 #include <time.h>
 #include <math.h>
+#include <limits.h>
 #include <sstream>
+#include <thread>
+#include <vector>
+#include <algorithm>
 
 #ifdef _DEBUG  
 #undef THIS_FILE
@@ -46,12 +62,16 @@ static char THIS_FILE[]=__FILE__;
 // Date:	5/00
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Delete the analytic engine
+// Ming-Kai Jiau	2026/10/16	Delete the compiled model
 //
 //
 FuzzyModelBase::~FuzzyModelBase()
 {
+	uncompile();
+
 	// remove variables and perform any clean up
 	delete_vars();
 
@@ -61,6 +81,9 @@ FuzzyModelBase::~FuzzyModelBase()
 		rules = NULL;
 		}
 
+	unbake();
+	set_analytic(false);
+
 }; // end FuzzyModelBase::~FuzzyModelBase()
 
  
@@ -82,8 +105,11 @@ FuzzyModelBase::~FuzzyModelBase()
 // Date:	5/00
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Initialize the analytic engine
+// Ming-Kai Jiau	2026/10/16	Initialize the compiled model
+// Ming-Kai Jiau	2026/10/16	Initialize the precompiled flag
 //
 //
 FuzzyModelBase::FuzzyModelBase() : FFLLBase(NULL)
@@ -98,6 +124,10 @@ FuzzyModelBase::FuzzyModelBase() : FFLLBase(NULL)
   	rules = NULL;  
 	input_var_arr = NULL;
 	output_var = NULL;
+	baked_surface = NULL;
+	analytic_engine = NULL;
+	compiled_model = NULL;
+	precompiled = false;
 
 	model_name = ""; // clear out file name
  
@@ -226,8 +256,9 @@ int FuzzyModelBase::add_input_variable(const wchar_t* _name, RealType start_x, R
 // Date:	5/00
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Throw away the compiled model
 //
 //
 int FuzzyModelBase::add_output_variable(const wchar_t* _name, RealType start_x, RealType end_x, bool create_unique_id /* = true */)
@@ -238,6 +269,8 @@ int FuzzyModelBase::add_output_variable(const wchar_t* _name, RealType start_x,
 		set_msg_text(ERR_OUT_VAR_EXISTS);
 		return -1;
 		}
+
+	uncompile();
   
  	output_var = new_output_variable();
 
@@ -277,8 +310,9 @@ int FuzzyModelBase::add_output_variable(const wchar_t* _name, RealType start_x,
 // Date:	5/00
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Throw away the compiled model
 //
 //	
 int FuzzyModelBase::delete_variable(int _var_idx )
@@ -297,6 +331,8 @@ int FuzzyModelBase::delete_variable(int _var_idx )
 		return -1;
 		}
 
+	uncompile();
+
 	int new_var_count = input_var_count - 1;
  	// need to create shrunken memory
 	FuzzyVariableBase** tmp_var;
@@ -533,17 +569,22 @@ int FuzzyModelBase::calc_rule_index(int var_idx)
 // Date:	5/00
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Only move the rules that are defined (see remap_rules())
 //
 //
 int FuzzyModelBase::add_set(int _var_idx,  const FuzzySetBase* _set) 
 {
- 	RuleArrayType*		new_mem = NULL;		// pointer to the new memory
-	int					new_mem_size;		// size of the new memory we're allocating
-  
 	FuzzyVariableBase* var = get_var(_var_idx); 
 
+	// save the number of sets in each input var so we can find where the
+	// existing rules move to
+	int* old_count_arr = new int[input_var_count + 1]; // +1 so we never alloc 0
+
+	for (int i = 0; i < input_var_count; i++)
+		old_count_arr[i] = input_var_arr[i]->get_num_of_sets();
+
 	// _set is NOT modified in add_set, so we can NOT rely on it's index value or
 	// anything. add_set() adds the set so we must use that for any furthur information
 	// we need.
@@ -551,69 +592,36 @@ int FuzzyModelBase::add_set(int _var_idx,  const FuzzySetBase* _set)
 	int ret_val = var->add_set(_set);  
 	
 	if (ret_val)
+		{
+		delete[] old_count_arr;
 		return ret_val;
+		}
 
-	FuzzySetBase* new_set = var->get_set(var->get_num_of_sets() - 1);
+	// make sure the rule indexes still fit in an int
+	if (!var->is_output() && calc_num_of_rules() < 0)
+		{
+		var->delete_set(var->get_num_of_sets() - 1);
+		delete[] old_count_arr;
+		set_msg_text(ERR_TOO_MANY_RULES);
+		return -1;
+		}
 
 	calc_rule_index_wrapper(); // re-calc rule_index values now that we have a new set
 
 	// if this is an output var we don't need to assign any more memory
 	if (var->is_output())
-		return 0;
-
-	// if we got to this point, we're dealing with an input variable
-
-	// calc the size of the new memory block
-	new_mem_size = calc_num_of_rules();
- 
-	if (new_mem_size == 0)
-		return 0; // nothing more to do...
-
-	// allocate and init the new memory for rules...
-	new_mem = new RuleArrayType[new_mem_size];;
-	memset(new_mem, NO_RULE, new_mem_size * sizeof(RuleArrayType));
-
-	assert(new_mem != NULL);
- 
-	// IF we have rules to copy...
-
-	if (rules->get_max())
 		{
- 		// rather than stick the new memory in the middle of the existing mem we'll just
-		// copy the needed data...
-		int* set_idx_array = new int[get_input_var_count()]; // array of the sets involved in the current rule
-  
-		int	rule_index = 0;	// index for the rule into the OLD memory
-		
- 		for (int new_mem_idx = 0; new_mem_idx < new_mem_size; new_mem_idx++)
-			{
-			// we've added the set so this gets the rule components for the
-			// rule index with the new set added
-			calc_rule_components(new_mem_idx, set_idx_array);
-
-			// if this index involves the NEW set leave it as NO_RULE
-			if (set_idx_array[_var_idx] == new_set->get_index())
- 				continue;
- 
-			// copy the rule from the OLD array to the NEW array
- 				
-			new_mem[new_mem_idx] = rules->get_rule(rule_index);
-
-			// increment the index into the OLD rules...
-			rule_index++;
+		delete[] old_count_arr;
+		return 0;
+		}
 
-			} // end looop through new mem
+	// if we got to this point, we're dealing with an input variable. The new set
+	// is the last one in the var so it's not part of any rule yet
+	ret_val = remap_rules(old_count_arr, -1, -1);
 
-		delete[] set_idx_array;
-		} // end if we have rules
- 
-	// now set the rules to the new rule array with the old rules copied in
-	rules->set(new_mem, new_mem_size);
+	delete[] old_count_arr;
 
-	// free the new rules we allocated
-	delete[] new_mem;
- 
-	return 0;
+	return ret_val;
 
 } // end FuzzyModelBase::add_set()
  
@@ -638,14 +646,13 @@ int FuzzyModelBase::add_set(int _var_idx,  const FuzzySetBase* _set)
 // Date:	5/00
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Only visit the rules that are defined (see remap_rules())
 //
 //
 int FuzzyModelBase::delete_set(int _var_idx, int _set_idx)
 {
- 	RuleArrayType*	new_mem = NULL;		// pointer to the new memory
-	int					new_mem_size;		// size of the new memory we're allocating
   	int ret_val;
 
 	FuzzyVariableBase* var = get_var(_var_idx);  
@@ -661,11 +668,14 @@ int FuzzyModelBase::delete_set(int _var_idx, int _set_idx)
 		// it to adjust for the removed rule
 
 		RuleArrayType out_set;	// output set in rules array
+		std::vector<int> index_arr;	// rules that are defined
 		
-		int num_rules = rules->get_max();
+		int num_rules = rules->get_rule_indexes(index_arr);
 
-		for (int rule_index = 0; rule_index < num_rules; rule_index++)
+		for (int i = 0; i < num_rules; i++)
 			{
+			int rule_index = index_arr[i];
+
 			out_set = rules->get_rule(rule_index);
 			if (out_set == _set_idx)
 				rules->add_rule(rule_index, NO_RULE);
@@ -681,72 +691,126 @@ int FuzzyModelBase::delete_set(int _var_idx, int _set_idx)
 
 	// if we got to this point, we're dealing with an input var
 
-	// calculate the new size of the memory. NOTE we'd normally use calc_num_of_rules() here
-	// but we haven't deleted the set yet so that would give us the wrong value
-	int _num_sets;
-	new_mem_size = 1; // init to 1 so we don't mult by 0
-	for (int i = 0; i < input_var_count; i++) 	// don't include the outupt var
-		{
-		// make sure we don't multply by 0...
-		_num_sets = input_var_arr[i]->get_num_of_sets();
-		if (i == _var_idx)
-			_num_sets--;	// SUBTRACT for the set we're deleting
-//		if (_num_sets) // OK to mult by 0 if ANY of the inputs is 0 there can't be any rules!
-			new_mem_size *= _num_sets;
+	// save the number of sets in each input var so we can find where the
+	// existing rules move to
+	int* old_count_arr = new int[input_var_count];
 
-		} // end loop through input variables
- 
-	// allocate and init the new memory...
- 	new_mem = new RuleArrayType[new_mem_size];
+	for (int i = 0; i < input_var_count; i++)
+		old_count_arr[i] = input_var_arr[i]->get_num_of_sets();
+
+	// now do the actual delete...
+	ret_val = var->delete_set(_set_idx); 
+
+	// re-calc at the variable index factors...
+	calc_rule_index_wrapper();
+
+	// drop the rules that include the set and move the rest
+	if (remap_rules(old_count_arr, _var_idx, _set_idx))
+		ret_val = -1;
+
+	delete[] old_count_arr;
+
+	return ret_val;
+
+} // end FuzzyModelBase::delete_set()
+
+
+//
+// Function:	remap_rules()
+// 
+// Purpose:		Move the rules to their new indexes after a set was added to or
+//				deleted from an input variable. Only the rules that are defined are
+//				visited so this doesn't depend on the number of rule combinations.
+//				The rules array is re-allocated for the current number of sets.
+//
+// Arguments:
+//
+//		const int*	old_count_arr	-	number of sets each input var had before the change
+//		int			var_idx			-	index of the variable a set was deleted from (-1 if a set was added)
+//		int			deleted_set_idx	-	index of the set that was deleted (-1 if a set was added)
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int FuzzyModelBase::remap_rules(const int* old_count_arr, int var_idx, int deleted_set_idx)
+{
+	int i, j;	// counters
+	int new_mem_size = calc_num_of_rules();
 
-	if (!new_mem)
+	if (new_mem_size < 0)
 		{
- 		set_msg_text(ERR_ALLOC_MEM);
- 		assert(new_mem != NULL);
+		set_msg_text(ERR_TOO_MANY_RULES);
 		return -1;
-		} // end if error allocating memory
+		}
 
-	memset(new_mem, NO_RULE, new_mem_size * sizeof(RuleArrayType));
-	
-	// copy all the rules that do NOT include the set being deleted
-	int new_rule_index = 0;
+	// save the rules that are defined before we re-allocate...
+	std::vector<int>			index_arr;	// old index of each rule
+	std::vector<RuleArrayType>	out_arr;	// output set of each rule
 
-	int* set_idx_array = new int[get_input_var_count()]; // array of the sets involved in the current rule
+	int num_rules = rules->get_rule_indexes(index_arr);
 
-	for (int rule_index = 0; rule_index < rules->get_max(); rule_index++)
+	out_arr.resize(num_rules);
+
+	for (i = 0; i < num_rules; i++)
+		out_arr[i] = rules->get_rule(index_arr[i]);
+
+	if (rules->alloc(new_mem_size))
 		{
-		// get the sets that make up this rule
+		set_msg_text(rules->get_msg_text());
+		return -1;
+		}
 
- 	 	calc_rule_components(rule_index, set_idx_array);
+	if (new_mem_size == 0 || num_rules == 0)
+		return 0; // nothing more to do...
 
-		// if the rule does NOT involve the set we're going to delete, copy it
+	int* set_idx_array = new int[input_var_count]; // array of the sets involved in the current rule
 
-		if (set_idx_array[_var_idx] == _set_idx)
-			continue;
+	for (i = 0; i < num_rules; i++)
+		{
+		// get the sets that make up the rule using the OLD number of sets
+		int old_index = index_arr[i];
 
-		// set that new index to the rule that should be there
-		new_mem[new_rule_index] = rules->get_rule(rule_index);
+		for (j = input_var_count - 1; j >= 0; j--)
+			{
+			set_idx_array[j] = old_index % old_count_arr[j];
+			old_index /= old_count_arr[j];
+			}
 
-		new_rule_index++; // increment NEW rule index
+		// if the rule involves the set we deleted, drop it
+		if (var_idx >= 0)
+			{
+			if (set_idx_array[var_idx] == deleted_set_idx)
+				continue;
 
-		} // end loop through rules
+			if (set_idx_array[var_idx] > deleted_set_idx)
+				set_idx_array[var_idx]--;
+			}
 
-	delete[] set_idx_array;
+		// now build the index using the NEW number of sets
+		int new_index = 0;
 
- 	// now copy the new memory into the old rules block...
-	rules->set(new_mem, new_mem_size);
+		for (j = 0; j < input_var_count; j++)
+			new_index = new_index * input_var_arr[j]->get_num_of_sets() + set_idx_array[j];
 
-	delete[] new_mem;	// free the memory we allocated
+		rules->add_rule(new_index, out_arr[i]);
 
-	// now do the actual delete...
-	ret_val = var->delete_set(_set_idx); 
+		} // end loop through rules
 
-	// re-calc at the variable index factors...
-	calc_rule_index_wrapper();
+	delete[] set_idx_array;
 
-	return ret_val;
+	return 0;
 
-} // end FuzzyModelBase::delete_set()
+} // end FuzzyModelBase::remap_rules()
 
  
 //
@@ -868,332 +932,1064 @@ const char* FuzzyModelBase::get_msg_textA()
 //										for each input var
 //		DOMType*	out_set_dom_arr -	Array that holds the DOM value for each
 //										set in the output variable
+//		InferenceScratch* scratch	-	working memory for the inference kernel. Pass
+//										one per thread, if NULL a temporary one is used
 //
 // Returns:
 //
 //		RealType - the output value, FLT_MIN if no ouput set is active
 //
+// NOTE: if the model is baked the output comes from the baked table and
+// out_set_dom_arr is not filled in.
+//
 // Author:	Michael Zarozinski
 // Date:	
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Added scratch argument for the iterative kernel
+// Ming-Kai Jiau	2026/10/16	Use the baked table if there is one
+// Ming-Kai Jiau	2026/10/16	Calculate from the compiled model
 //
 //
-RealType FuzzyModelBase::calc_output(short* var_idx_arr, DOMType* out_set_dom_arr )  
+RealType FuzzyModelBase::calc_output(short* var_idx_arr, DOMType* out_set_dom_arr, InferenceScratch* scratch /* = NULL */)  
 {
-	calc_active_output_level_wrapper(var_idx_arr, out_set_dom_arr);
- 
-	if (!output_var)
-		return FLT_MIN;	// don't have an output var yet!
+	if (baked_surface)
+		return baked_surface->get_value(var_idx_arr);
 
-	return output_var->calc_output_value(out_set_dom_arr);
+	// compile the model if it changed since it was last compiled
+	if (!compiled_model && compile())
+		return FLT_MIN;
 
-} // end FuzzyModelBase::calc_output()
- 
+	if (scratch == NULL)
+		{
+		InferenceScratch tmp_scratch;
+
+		return compiled_model->calc_output(var_idx_arr, out_set_dom_arr, &tmp_scratch);
+		}
+
+	return compiled_model->calc_output(var_idx_arr, out_set_dom_arr, scratch);
 
+} // end FuzzyModelBase::calc_output()
 
 //
-// Function:	validate_fcl_identifier()
+// Function:	calc_output_incremental()
 // 
-// Purpose:		Validate that the identifier is in valid FCL format. The IEC 61131-7 
-//				specifies identifiers as :
-//			
-//					identifier
-//						{alpha}{alphanum}*(\[{alphanum}\])?
-//						(\.{alpha}{alphanum}*(\[{alphanum}\])?)* |
-//						{alpha}{alphanum}*(\[({digits}..{digits})(,({digits}..{digits}))*\])
-// 
-//					where
+// Purpose:		Calculates the defuzzified output value for the model when at most
+//				one input has changed since the last time the output was calculated
+//				with the scratch passed in. The active sets of the other variables
+//				are re-used and their combinations (the partial activations) are
+//				kept in the scratch, so only the rules involving the changed variable's
+//				new active sets are fired. If the changed variable's active sets have
+//				the same DOMs as before the output sets' DOMs can't have changed and
+//				no rules are fired at all (see CompiledModel::calc_output_incremental()).
 //
-//						alpha ::= [a-zA-Z_]
-//						alphanum ::= [a-zA-Z_0-9]
+// Arguments:
 //
-//				You'll note that this does not handle wild characters.
+//		short*		var_idx_arr		-	Array that holds the current index value 
+//										for each input var
+//		int			changed_var		-	index of the only input var whose index changed since
+//										the last call, -1 if more than one changed (or the model did)
+//		DOMType*	out_set_dom_arr -	Array that holds the DOM value for each set in the
+//										output variable, this must be the same array that was
+//										passed for the last call
+//		InferenceScratch* scratch	-	working memory that holds the cached active sets and
+//										partial activations, one per child
 //
-//				This currently only checks for spaces or an identifier that starts with
-//				a number. This could be made much more robust.
+// Returns:
 //
-//				If there's something wrong with the identifier the problem is written out in
-//				a comment.
+//		RealType - the output value, FLT_MIN if no ouput set is active
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Calculate from the compiled model
+//
+//
+RealType FuzzyModelBase::calc_output_incremental(short* var_idx_arr, int changed_var, DOMType* out_set_dom_arr, InferenceScratch* scratch)
+{
+	if (baked_surface)
+		return baked_surface->get_value(var_idx_arr);
+
+	if (!compiled_model && compile())
+		return FLT_MIN;
+
+	return compiled_model->calc_output_incremental(var_idx_arr, changed_var, out_set_dom_arr, scratch);
+
+} // end FuzzyModelBase::calc_output_incremental()
+
+//
+// Function:	calc_output_batch()
+// 
+// Purpose:		Calculates the defuzzified output value for each row of a matrix of
+//				crisp input values. This does the same thing as converting each input
+//				value to an index then calling calc_output() for each row, but the
+//				variable look-ups are done once for the whole batch.
 //
 // Arguments:
 //
-//		std::ofstream&	file_contents	-	file we're writing to
-//		std::string		identifier		-	identifier to check
+//		const RealType*	inputs			-	rows x cols matrix of crisp input values, stored
+//											row by row. Column N is the value for input var N
+//		int				rows			-	number of rows in the matrix
+//		int				cols			-	number of columns in the matrix, this must be the
+//											same as the number of input variables
+//		short*			var_idx_arr		-	Array that holds the current index value 
+//											for each input var (scratch)
+//		DOMType*		out_set_dom_arr -	Array that holds the DOM value for each
+//											set in the output variable (scratch)
+//		RealType*		outputs			-	array of 'rows' elements that gets the output values,
+//											FLT_MIN for any row where no output set is active
+//		InferenceScratch* scratch		-	working memory for the inference kernel (see calc_output())
 //
 // Returns:
 //
-//		void
+//		0 - success
+//		non-zero - failure
 //
-// Author:	Michael Zarozinski
-// Date:	9/01
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Interpolate if the model is baked with interpolation
+// Ming-Kai Jiau	2026/10/16	Use the AVX2 kernel if the CPU supports it
+// Ming-Kai Jiau	2026/10/16	Use the analytic engine in analytic mode
+// Ming-Kai Jiau	2026/10/16	Calculate from the compiled model
+// Ming-Kai Jiau	2026/10/16	Precompiled models have no variables
 //
 //
-void FuzzyModelBase::validate_fcl_identifier(std::ofstream& file_contents, std::string identifier)
+int FuzzyModelBase::calc_output_batch(const RealType* inputs, int rows, int cols, short* var_idx_arr, DOMType* out_set_dom_arr, RealType* outputs, InferenceScratch* scratch /* = NULL */)
 {
- 
- 	bool add_comment = false;
+	if (cols != get_input_var_count() || rows < 0)
+		return -1;
 
-	// if there's a space in the identifier - flag an error
-	if (identifier.find(" ") != -1)
+	if (rows && (inputs == NULL || outputs == NULL))
+		return -1;
+
+	if (scratch == NULL)
 		{
-		file_contents << "\t(* Identifier should not have any spaces, they were replaced with underscores ";
-		add_comment = true;
+		// use one scratch object for the whole batch
+		InferenceScratch tmp_scratch;
+
+		return calc_output_batch(inputs, rows, cols, var_idx_arr, out_set_dom_arr, outputs, &tmp_scratch);
 		}
 
-	if (static_cast<int>(identifier[0]) < 9)
+	if (analytic_engine)
 		{
-		if (add_comment)
-			file_contents << "or start with a digit ";
-		else
-			file_contents << "\t(* Identifier should not start with a digit ";
-		add_comment = true;
+		for (int row = 0; row < rows; row++, inputs += cols)
+			outputs[row] = analytic_engine->calc_output(inputs, scratch);
+
+		return 0;
 		}
 
-	if (add_comment)
-		file_contents << "*)";
+	if (!compiled_model && compile())
+		return -1;
 
+	if (baked_surface && baked_surface->interpolate)
+		{
+		std::vector<RealType> var_pos_arr(cols);
 
-} // end FuzzyModelBase::validate_fcl_identifier()
-  
+		for (int row = 0; row < rows; row++, inputs += cols)
+			{
+			for (int var_idx = 0; var_idx < cols; var_idx++)
+				var_pos_arr[var_idx] = compiled_model->convert_value_to_pos(var_idx, inputs[var_idx]);
+
+			outputs[row] = baked_surface->get_interpolated_value(&var_pos_arr[0]);
+			}
+
+		return 0;
+
+		} // end if interpolating
+
+	int row = 0;	// row we're on
+
+	// if the CPU supports it, calculate BatchKernel::LANES rows at a time (unless
+	// that's slower for this model, see CompiledModel::choose_batch_kernel())
+	if (!baked_surface && rows >= BatchKernel::LANES && BatchKernel::is_supported())
+		{
+		BatchKernel kernel;
+
+		if (compiled_model->init_batch_kernel(&kernel) == 0)
+			{
+			std::vector<int> var_idx_block(cols * BatchKernel::LANES);
 
+			for ( ; row + BatchKernel::LANES <= rows; row += BatchKernel::LANES)
+				{
+				// convert the values to indexes, the indexes for var 0 come first
+				for (int lane = 0; lane < BatchKernel::LANES; lane++, inputs += cols)
+					{
+					for (int var_idx = 0; var_idx < cols; var_idx++)
+						var_idx_block[var_idx * BatchKernel::LANES + lane] = compiled_model->convert_value_to_idx(var_idx, inputs[var_idx]);
+					}
+
+				kernel.calc_block(&var_idx_block[0], outputs + row);
+
+				} // end loop through blocks of rows
+
+			} // end if kernel initialized
+
+		} // end if batch kernel supported
+
+	// do any rows that are left one at a time
+	for ( ; row < rows; row++, inputs += cols)
+		{
+		// convert the values to indexes into the values[] arrays
+		for (int var_idx = 0; var_idx < cols; var_idx++)
+			var_idx_arr[var_idx] = compiled_model->convert_value_to_idx(var_idx, inputs[var_idx]);
+
+		outputs[row] = calc_output(var_idx_arr, out_set_dom_arr, scratch);
+
+		} // end loop through rows
+
+	return 0;
+
+} // end FuzzyModelBase::calc_output_batch()
 
 //
-// Function:	calc_active_output_level_wrapper()
+// Function:	calc_output_analytic()
 // 
-// Purpose:		Wrapper function that calculates the active output level
-//				for each output set.
+// Purpose:		Calculates the defuzzified output value for the crisp input values
+//				passed in without converting them to indexes (see AnalyticEngine).
+//				The model must be in analytic mode (see set_analytic()).
 //
 // Arguments:
 //
-//		short*		var_idx_arr		-	Array that holds the current index value 
-//										for each input var
-//		DOMType*	out_set_dom_arr -	Array that we're writing to. It holds the DOM value for each
-//										set in the output variable
+//		const RealType*		var_value_arr	-	crisp value of each input variable
+//		InferenceScratch*	scratch			-	working memory, if NULL a temporary one is used.
+//												Each thread must use its own.
 //
 // Returns:
 //
-//		void
+//		RealType - the output value, FLT_MIN if no output set is active or the
+//					model isn't in analytic mode
 //
-// Author:	Michael Zarozinski
-// Date:	5/99
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
 // 
 // Modification History
 // Author	Date		Modification
 // ------	----		------------
 //
 //
-void FuzzyModelBase::calc_active_output_level_wrapper(short* var_idx_arr, DOMType* out_set_dom_arr )   
+RealType FuzzyModelBase::calc_output_analytic(const RealType* var_value_arr, InferenceScratch* scratch /* = NULL */) const
 {
-  	if (!output_var)
-		return;	// don't have an output var yet!
+	if (!analytic_engine)
+		return FLT_MIN;
 
-	// zero out the dom arrays...
-	for (int i = 0; i < output_var->get_num_of_sets(); i++)
+	if (scratch == NULL)
 		{
-		out_set_dom_arr[i] = 0;  
+		InferenceScratch tmp_scratch;
+
+		return analytic_engine->calc_output(var_value_arr, &tmp_scratch);
 		}
 
-	// call recursive func to calc each sets DOM...
-  	calc_active_output_level(0, 0, 0, var_idx_arr, out_set_dom_arr);
- 
-} // end FuzzyModelBase::calc_active_output_level_wrapper()
+	return analytic_engine->calc_output(var_value_arr, scratch);
 
+} // end FuzzyModelBase::calc_output_analytic()
 
 //
-// Function:	add_input_var_to_list()
+// Function:	set_analytic()
 // 
-// Purpose:		Add the variable passed in to the list of input variables and
-//				adjust the rules as needed.
-//				Note that this does not COPY the var passed in, it sets the
-//				input variable array to point to the var passed in.
+// Purpose:		Turn analytic mode on or off. In analytic mode the output is calculated
+//				in double precision from the exact node values of the sets rather than
+//				the values[] arrays (see AnalyticEngine).
+//				NOTE: like bake(), the engine is not updated if the model changes, call
+//				set_analytic(true) again after changing the model.
 //
 // Arguments:
 //
-//		FuzzyVariableBase* var - variable to insert
+//		bool analytic - true to turn analytic mode on, false to turn it off
 //
 // Returns:
 //
-//		void
+//		0 - success
+//		non-zero - failure
 //
-// Author:	Michael Zarozinski
-// Date:	8/01
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Precompiled models can't be analytic
 //
 //
-void FuzzyModelBase::add_input_var_to_list(FuzzyVariableBase* var )
+int FuzzyModelBase::set_analytic(bool analytic)
 {
-	// need to create new memory then we'll copy the old to it...
-	FuzzyVariableBase** tmp_var = new FuzzyVariableBase*[input_var_count + 1]; // new mem
+	delete analytic_engine;
+	analytic_engine = NULL;
 
-	// copy the old memory to the new mem..
-	for (int i = 0; i < input_var_count; i++)
-		tmp_var[i] = input_var_arr[i];
+	if (!analytic)
+		return 0;
 
-	// add this variable to the variable array....
+	// the analytic engine needs the membership functions
+	if (precompiled)
+		{
+		set_msg_text(ERR_MODEL_PRECOMPILED);
+		return -1;
+		}
 
- 	var->set_index(input_var_count);
-	tmp_var[input_var_count] = var; 
+	AnalyticEngine* engine = new AnalyticEngine;
 
- 	// set the index in var so we know where we are in the array
+	if (init_analytic_engine(engine))
+		{
+		delete engine;
+		set_msg_text(ERR_NO_OUTPUT_VAR);
+		return -1;
+		}
 
-	input_var_count++;  // increment the number of variables we have
-	
-	// set the old mem to the new mem...
+	analytic_engine = engine;
 
-	delete[] input_var_arr; // free old mem
+	return 0;
 
-	input_var_arr = tmp_var;
+} // end FuzzyModelBase::set_analytic()
+
+//
+// Function:	init_analytic_engine()
+// 
+// Purpose:		Fill in the model information the analytic engine needs to calculate
+//				the output (see AnalyticEngine).
+//
+// Arguments:
+//
+//		AnalyticEngine* engine - engine to initialize
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure (the model has no output variable)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Added weighted average
+//
+//
+int FuzzyModelBase::init_analytic_engine(AnalyticEngine* engine) const
+{
+	int i, j, k;	// counters
+	RealType x[7], y[7];	// node values (an S-Curve has the most nodes)
+
+	if (!output_var)
+		return -1;
+
+	engine->inference_min = (inference_method == INFERENCE_OPERATION_MIN);
+	engine->composition_min = (output_var->get_composition_method() == FuzzyOutVariable::COMPOSITION_OPERATION_MIN);
+	engine->use_mom = (output_var->get_defuzz_method() == DefuzzVarObj::DEFUZZ_MOM);
+	engine->use_wa = (output_var->get_defuzz_method() == DefuzzVarObj::DEFUZZ_WA);
+	engine->rules = rules;
+
+	for (i = 0; i < input_var_count; i++)
+		{
+		engine->add_input_var(input_var_arr[i]->get_left_x(), input_var_arr[i]->get_right_x());
+
+		for (j = 0; j < input_var_arr[i]->get_num_of_sets(); j++)
+			{
+			const FuzzySetBase* set = input_var_arr[i]->get_set(j);
+			int node_count = set->get_node_count();
+
+			for (k = 0; k < node_count && k < 7; k++)
+				set->get_node_value(k, &x[k], &y[k]);
+
+			engine->add_set(i, set->get_func_type(), node_count, x, y, input_var_arr[i]->get_rule_index(j));
+			}
+
+		} // end loop through input vars
+
+	engine->set_output_var(output_var->get_left_x(), output_var->get_right_x());
+
+	for (j = 0; j < output_var->get_num_of_sets(); j++)
+		{
+		const FuzzySetBase* set = output_var->get_set(j);
+		int node_count = set->get_node_count();
+
+		for (k = 0; k < node_count && k < 7; k++)
+			set->get_node_value(k, &x[k], &y[k]);
+
+		engine->add_set(OUTPUT_IDX, set->get_func_type(), node_count, x, y, 0);
+		}
+
+	// the defined rules, for models with sparse rules
+	std::vector<int> rule_index_arr;
+
+	rules->get_rule_indexes(rule_index_arr);
+
+	for (j = 0; j < static_cast<int>(rule_index_arr.size()); j++)
+		{
+		RuleArrayType out_set = rules->get_rule(rule_index_arr[j]);
+
+		if (out_set != NO_RULE && out_set < output_var->get_num_of_sets())
+			engine->add_rule(rule_index_arr[j], out_set);
+		}
+
+	return 0;
+
+} // end FuzzyModelBase::init_analytic_engine()
+
+
+//
+// Function:	bake()
+// 
+// Purpose:		Calculate the output for every combination of input indexes and
+//				store them in a table so calc_output() is a single look-up.
+//				The table is filled in by several threads, each with its own
+//				working memory. This is only worth doing for models with a few
+//				input variables, the table has the product of the input variables'
+//				x_array_count entries and can't be larger than MFLL_BAKE_MAX_ENTRIES.
+//				NOTE: the table is not updated if the model changes, call
+//				bake() again (or unbake()) after changing the model.
+//
+// Arguments:
+//
+//		bool interpolate	-	if true, the output for crisp input values is interpolated
+//								between the indexes either side of the values (see
+//								BakedSurface::get_interpolated_value())
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Each input variable has its own x_array_count
+// Ming-Kai Jiau	2026/10/16	Calculate the table from the compiled model
+// Ming-Kai Jiau	2026/10/16	Bake precompiled models (see load_compiled())
+//
+//
+int FuzzyModelBase::bake(bool interpolate /* = false */)
+{
+	int i;	// counter
+
+	// throw away any old table so the new one is calculated from the rules
+	unbake();
+
+	if ((!output_var && !precompiled) || get_input_var_count() == 0)
+		{
+		set_msg_text(ERR_CANT_BAKE_MODEL);
+		return -1;
+		}
+
+	// make sure the model is compiled before the threads read it
+	if (!compiled_model && compile())
+		return -1;	// error is written to msg_txt in the called func
+
+	int var_count = compiled_model->get_input_var_count();
+
+	std::vector<int> x_count_arr(var_count);
+
+	for (i = 0; i < var_count; i++)
+		x_count_arr[i] = compiled_model->get_x_array_count(i);
+
+	BakedSurface* surface = new BakedSurface;
+
+	if (surface->alloc(var_count, &x_count_arr[0]))
+		{
+		delete surface;
+		set_msg_text(ERR_CANT_BAKE_MODEL);
+		return -1;
+		}
+
+	surface->interpolate = interpolate;
+
+	// split the table between the threads, don't bother with a
+	// thread unless it has a reasonable amount of work to do
+	int thread_count = std::thread::hardware_concurrency();
+	int max_threads = surface->entry_count / 4096 + 1;
+
+	if (thread_count > max_threads)
+		thread_count = max_threads;
+	if (thread_count < 1)
+		thread_count = 1;
+
+	int chunk = (surface->entry_count + thread_count - 1) / thread_count;
+
+	std::vector<std::thread> threads;
+
+	for (i = 1; i < thread_count; i++)
+		{
+		int first_entry = i * chunk;
+		int last_entry = first_entry + chunk;
+
+		if (last_entry > surface->entry_count)
+			last_entry = surface->entry_count;
+
+		if (first_entry < last_entry)
+			threads.push_back(std::thread(&FuzzyModelBase::bake_entries, this, surface, first_entry, last_entry));
+		}
+
+	// this thread does the first chunk
+	bake_entries(surface, 0, (chunk < surface->entry_count) ? chunk : surface->entry_count);
+
+	for (i = 0; i < static_cast<int>(threads.size()); i++)
+		threads[i].join();
+
+	baked_surface = surface;
+
+	return 0;
+
+} // end FuzzyModelBase::bake()
+
+
+//
+// Function:	bake_entries()
+// 
+// Purpose:		Calculate the output for a range of entries in the baked table.
+//				This is run by several threads at once so it only reads the compiled model.
+//
+// Arguments:
+//
+//		BakedSurface*	surface		-	table we're filling in
+//		int				first_entry	-	first entry to calculate
+//		int				last_entry	-	one past the last entry to calculate
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Calculate from the compiled model
+// Ming-Kai Jiau	2026/10/16	Precompiled models have no variables
+//
+//
+void FuzzyModelBase::bake_entries(BakedSurface* surface, int first_entry, int last_entry)
+{
+	int					i;	// counter
+	InferenceScratch	scratch;
+	int					var_count = compiled_model->get_input_var_count();
+	std::vector<short>	var_idx_arr(var_count);
+	std::vector<DOMType> out_set_dom_arr(compiled_model->get_out_set_count() + 1);
+
+	// get the indexes for the first entry, the last variable changes fastest
+	int entry = first_entry;
+
+	for (i = var_count - 1; i >= 0; i--)
+		{
+		var_idx_arr[i] = entry % surface->x_count_arr[i];
+		entry /= surface->x_count_arr[i];
+		}
+
+	for (entry = first_entry; entry < last_entry; entry++)
+		{
+		surface->table[entry] = compiled_model->calc_output(&var_idx_arr[0], &out_set_dom_arr[0], &scratch);
+
+		// move to the next combination of indexes
+		for (i = var_count - 1; i >= 0; i--)
+			{
+			if (++var_idx_arr[i] < surface->x_count_arr[i])
+				break;
+
+			var_idx_arr[i] = 0;
+			}
+
+		} // end loop through entries
+
+} // end FuzzyModelBase::bake_entries()
+
+//
+// Function:	set_x_array_count()
+// 
+// Purpose:		Set the resolution (number of indexes in the values[] array) of
+//				one variable. Variables that need fine control can have more
+//				indexes without making every variable in the model bigger.
+//				The baked table is thrown away since its indexes are out of date.
+//
+// Arguments:
+//
+//		int var_idx	-	index of the variable (OUTPUT_IDX for the output variable)
+//		int count	-	number of indexes (2 to MAX_X_ARRAY_COUNT)
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Precompiled models can't be changed
+//
+//
+int FuzzyModelBase::set_x_array_count(int var_idx, int count)
+{
+	if (precompiled)
+		{
+		set_msg_text(ERR_MODEL_PRECOMPILED);
+		return -1;
+		}
+
+	if (var_idx != OUTPUT_IDX && (var_idx < 0 || var_idx >= input_var_count))
+		{
+		set_msg_text(ERR_INVALID_VAR_IDX);
+		return -1;
+		}
+
+	FuzzyVariableBase* var = get_var(var_idx);
+
+	if (var == NULL)
+		{
+		set_msg_text(ERR_INVALID_VAR_IDX);
+		return -1;
+		}
+
+	unbake();
+
+	if (var->set_x_array_count(count))
+		{
+		set_msg_text(var->get_msg_text());
+		return -1;
+		}
+
+	return 0;
+
+} // end FuzzyModelBase::set_x_array_count()
+
+//
+// Function:	compile()
+// 
+// Purpose:		Build the compiled model (see CompiledModel), the read-only copy of
+//				the model that the output is calculated from. The variables, sets and
+//				rules are only used for editing and saving the model. This is done when
+//				the model is loaded, and again the first time the output is needed after
+//				the model is changed.
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Added weighted average
+//
+//
+int FuzzyModelBase::compile()
+{
+	int i, j;	// counters
+
+	uncompile();
+
+	CompiledModel* model = new CompiledModel;
+
+	model->set_inference_method(inference_method == INFERENCE_OPERATION_MIN);
+
+	for (i = 0; i < input_var_count; i++)
+		{
+		const FuzzyVariableBase* var = input_var_arr[i];
+		int set_count = var->get_num_of_sets();
+		std::vector<int> rule_index_arr(set_count + 1);
+
+		for (j = 0; j < set_count; j++)
+			rule_index_arr[j] = var->get_rule_index(j);
+
+		model->add_input_var(var->get_left_x(), var->get_idx_multiplier(), var->get_x_array_count(), set_count, var->get_dom_table(), &rule_index_arr[0]);
+
+		} // end loop through input vars
+
+	int out_set_count = 0;	// number of output sets
+
+	if (output_var)
+		{
+		out_set_count = output_var->get_num_of_sets();
+
+		model->set_output_var(output_var->get_left_x(), output_var->get_composition_method() == FuzzyOutVariable::COMPOSITION_OPERATION_MIN, output_var->get_defuzz_method());
+
+		// get the pre-calculated values of each set's defuzzification object
+		for (j = 0; j < out_set_count; j++)
+			{
+			const DefuzzSetObj* defuzz = output_var->get_set(j)->get_defuzz_obj();
+			const COGDefuzzSetObj* cog = dynamic_cast<const COGDefuzzSetObj*>(defuzz);
+			const MOMDefuzzSetObj* mom = dynamic_cast<const MOMDefuzzSetObj*>(defuzz);
+			const WADefuzzSetObj* wa = dynamic_cast<const WADefuzzSetObj*>(defuzz);
+			RealType mean_value = mom ? mom->get_mean_value() : (wa ? wa->get_position() : 0);
+
+			model->add_out_set(cog ? cog->get_area_moment_arr() : NULL, mean_value);
+			}
+
+		} // end if output var
+
+	// the defined rules (a rule for a set that doesn't exist can never fire)
+	std::vector<int> rule_index_arr;
+
+	model->set_rule_max(rules->get_max());
+	rules->get_rule_indexes(rule_index_arr);
+
+	for (j = 0; j < static_cast<int>(rule_index_arr.size()); j++)
+		{
+		RuleArrayType out_set = rules->get_rule(rule_index_arr[j]);
+
+		if (out_set != NO_RULE && out_set < out_set_count)
+			model->add_rule(rule_index_arr[j], out_set);
+		}
+
+	if (model->pack(FuzzyVariableBase::get_dom_array_count()))
+		{
+		delete model;
+		set_msg_text(ERR_ALLOC_MEM);
+		return -1;
+		}
+
+	compiled_model = model;
+
+	return 0;
+
+} // end FuzzyModelBase::compile()
+
+//
+// Function:	save_compiled()
+// 
+// Purpose:		Save the compiled model (see CompiledModel::save()) so it can be loaded
+//				with load_compiled() without parsing the FCL file or calculating the
+//				membership functions and COG tables again.
+//
+// Arguments:
+//
+//		const char* file_name - path and file name to save the compiled model to
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int FuzzyModelBase::save_compiled(const char* file_name)
+{
+	if (!compiled_model && compile())
+		return -1;	// error is written to msg_txt in the called func
+
+	std::ofstream file_contents(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!(file_contents.is_open()))
+		{
+		set_msg_text(ERR_OPENING_FILE);
+		return -1;
+		}
+
+	if (compiled_model->save(file_contents))
+		{
+		set_msg_text(ERR_WRITING_FILE);
+		return -1;
+		}
+
+	return 0;
+
+} // end FuzzyModelBase::save_compiled()
+
+//
+// Function:	load_compiled()
+// 
+// Purpose:		Load a compiled model saved by save_compiled() into an empty (just
+//				created) model. The model ONLY has the compiled model, there are no
+//				variables, sets or rules, so it can calculate outputs and be baked
+//				but can't be changed, saved as FCL or put in analytic mode.
+//
+// Arguments:
+//
+//		const char* file_name - file to read
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int FuzzyModelBase::load_compiled(const char* file_name)
+{
+	assert(input_var_count == 0 && output_var == NULL);
+
+ 	std::ifstream file_contents(file_name, std::ios::in | std::ios::binary);
+
+ 	if (!(file_contents.is_open()))
+		{
+		set_msg_text(ERR_OPENING_FILE);
+		return -1;
+		}
+
+	std::ostringstream file_data;
+
+	file_data << file_contents.rdbuf();
+
+	std::string data = file_data.str();
+
+	CompiledModel* model = new CompiledModel;
+
+	if (model->load(data.data(), data.length(), FuzzyVariableBase::get_dom_array_count()))
+		{
+		delete model;
+		set_msg_text(ERR_INVALID_COMPILED_FILE);
+		return -1;
+		}
+
+	uncompile();
+	unbake();
+
+	compiled_model = model;
+	precompiled = true;
+
+	return 0;
+
+} // end FuzzyModelBase::load_compiled()
+
+//
+// Function:	map_compiled()
+// 
+// Purpose:		Same as load_compiled() but rather than reading the file, it's mapped
+//				into memory read-only and the output is calculated straight from the
+//				mapping (see CompiledModel::load_mapped()). Processes that map the same
+//				file share one copy of the model, and loading only touches the pages
+//				that are checked. The file stays mapped until the model is deleted.
+//
+// Arguments:
+//
+//		const char* file_name - file to map
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int FuzzyModelBase::map_compiled(const char* file_name)
+{
+	assert(input_var_count == 0 && output_var == NULL);
+
+	MappedFile* file = new MappedFile;
+
+	if (file->open(file_name))
+		{
+		delete file;
+		set_msg_text(ERR_OPENING_FILE);
+		return -1;
+		}
+
+	CompiledModel* model = new CompiledModel;
+
+	if (model->load_mapped(file, FuzzyVariableBase::get_dom_array_count()))
+		{
+		delete model;
+		delete file;
+		set_msg_text(ERR_INVALID_COMPILED_FILE);
+		return -1;
+		}
+
+	uncompile();
+	unbake();
+
+	compiled_model = model;
+	precompiled = true;
+
+	return 0;
+
+} // end FuzzyModelBase::map_compiled()
+ 
+
+
+//
+// Function:	validate_fcl_identifier()
+// 
+// Purpose:		Validate that the identifier is in valid FCL format. The IEC 61131-7 
+//				specifies identifiers as :
+//			
+//					identifier
+//						{alpha}{alphanum}*(\[{alphanum}\])?
+//						(\.{alpha}{alphanum}*(\[{alphanum}\])?)* |
+//						{alpha}{alphanum}*(\[({digits}..{digits})(,({digits}..{digits}))*\])
+// 
+//					where
+//
+//						alpha ::= [a-zA-Z_]
+//						alphanum ::= [a-zA-Z_0-9]
+//
+//				You'll note that this does not handle wild characters.
+//
+//				This currently only checks for spaces or an identifier that starts with
+//				a number. This could be made much more robust.
+//
+//				If there's something wrong with the identifier the problem is written out in
+//				a comment.
+//
+// Arguments:
+//
+//		std::ofstream&	file_contents	-	file we're writing to
+//		std::string		identifier		-	identifier to check
+//
+// Returns:
+//
+//		void
+//
+// Author:	Michael Zarozinski
+// Date:	9/01
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void FuzzyModelBase::validate_fcl_identifier(std::ofstream& file_contents, std::string identifier)
+{
+ 
+ 	bool add_comment = false;
+
+	// if there's a space in the identifier - flag an error
+	if (identifier.find(" ") != -1)
+		{
+		file_contents << "\t(* Identifier should not have any spaces, they were replaced with underscores ";
+		add_comment = true;
+		}
 
-	// if there are no sets for the new var... no need to expand memory
-	if (var->get_num_of_sets() == 0)
+	if (static_cast<int>(identifier[0]) < 9)
 		{
-		// clear rules before going on...
-		rules->clear();
-		return;
+		if (add_comment)
+			file_contents << "or start with a digit ";
+		else
+			file_contents << "\t(* Identifier should not start with a digit ";
+		add_comment = true;
 		}
 
-	// calc the size of the new memory block
-	// NOTE:  we've already added the set so the num_of_sets has been incremented
- 	int	 new_mem_size = calc_num_of_rules();
+	if (add_comment)
+		file_contents << "*)";
 
-	// if there's any var that has NO sets... new_mem_size will be 0... this is ok,
-	// cuz that means we CAN'T have any rules yet!
-	if (new_mem_size == 0)
-		return; // nothing more to do...
 
-	// anytime we add a new variable (even if we're copying an existing one) we
-	// loose all the rules so we just call alloc
+} // end FuzzyModelBase::validate_fcl_identifier()
+  
 
-	rules->alloc(new_mem_size);
-	
- 	// re-calc at the variable index factors...
- 
-	calc_rule_index_wrapper();
- 
-} // end FuzzyModelBase::add_input_var_to_list()
- 
 
 //
-// Function:	calc_active_output_level()
+// Function:	add_input_var_to_list()
 // 
-// Purpose:		Recursive function that calculates the DOMs for the output sets.
+// Purpose:		Add the variable passed in to the list of input variables and
+//				adjust the rules as needed.
+//				Note that this does not COPY the var passed in, it sets the
+//				input variable array to point to the var passed in.
 //
 // Arguments:
 //
-//		int			var_num				-	variable we're checking the DOMs for
-//		DOMType		activation_level	-	current activation level 
-//		int			rule_index			-	index for the rule we're checking DOMs for
-//		short*		var_idx_arr			-	Array that holds the current index value 
-//											for each input var
-//		DOMType*	out_set_dom_arr		-	Array that holds the DOM value for each
-//											set in the output variable
+//		FuzzyVariableBase* var - variable to insert
 //
 // Returns:
 //
 //		void
 //
 // Author:	Michael Zarozinski
-// Date:	7/99
+// Date:	8/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Throw away the compiled model
 //
 //
-void FuzzyModelBase::calc_active_output_level(int var_num, DOMType activation_level, int rule_index, short* var_idx_arr , DOMType* out_set_dom_arr )   
+void FuzzyModelBase::add_input_var_to_list(FuzzyVariableBase* var )
 {
+	uncompile();
 
-  	DOMType	old_activation_level;	// need to save the old actiavation
-									// level in case we have more than 
-									// one active set in this var
-			
-	DOMType		set_dom;		// var to hold the current set's dom.
-
-	// if the 'var_num' is greater than the number of input variables - set it to the OUTPUT var,
-	// that will end the recursing through this function
+	// need to create new memory then we'll copy the old to it...
+	FuzzyVariableBase** tmp_var = new FuzzyVariableBase*[input_var_count + 1]; // new mem
 
-	if (var_num >= input_var_count)
-		var_num = OUTPUT_IDX;
+	// copy the old memory to the new mem..
+	for (int i = 0; i < input_var_count; i++)
+		tmp_var[i] = input_var_arr[i];
 
-	// get the variable...
-	const FuzzyVariableBase* var = get_var(var_num);
-	assert(var != NULL);
+	// add this variable to the variable array....
 
-	// loop through the sets for this var...
-	int num_of_sets = var->get_num_of_sets();
-  
-	// loop through each set in this variable
-	for (int i = 0; i < num_of_sets; i++)
-		{
- 
-		if (!(var->is_output())) 
-			{
-			// input variable...
+ 	var->set_index(input_var_count);
+	tmp_var[input_var_count] = var; 
 
-  			set_dom = var->get_dom(i, (var_idx_arr[var_num])); 
- 			
-			// if this set is not active - skip it...
+ 	// set the index in var so we know where we are in the array
 
-			if (set_dom == 0) 		
-				continue;
+	input_var_count++;  // increment the number of variables we have
+	
+	// set the old mem to the new mem...
 
- 			// we need to deal with this set, save the activation level...
-	  		old_activation_level = activation_level;
+	delete[] input_var_arr; // free old mem
 
-			// if this is the FIRST time through, set the activation level
-			if (var_num == 0)
-				activation_level = set_dom;
+	input_var_arr = tmp_var;
 
-			// set the activation level to the current set's level dependent on the inference method
- 			if ((inference_method == INFERENCE_OPERATION_MIN) && (set_dom < activation_level) )
-				activation_level = set_dom;
-			else if ((inference_method == INFERENCE_OPERATION_MAX) && (set_dom > activation_level))
-				activation_level = set_dom;
+	// if there are no sets for the new var... no need to expand memory
+	if (var->get_num_of_sets() == 0)
+		{
+		// clear rules before going on...
+		rules->clear();
+		return;
+		}
 
+	// calc the size of the new memory block
+	// NOTE:  we've already added the set so the num_of_sets has been incremented
+ 	int	 new_mem_size = calc_num_of_rules();
 
-			// get the set we're dealing with for the recursive call
-			FuzzySetBase* set = var->get_set(i);
+	// if there's any var that has NO sets... new_mem_size will be 0... this is ok,
+	// cuz that means we CAN'T have any rules yet!
+	if (new_mem_size == 0)
+		return; // nothing more to do...
 
-			// call recursively, incrementing the variable index by one and adding
-			// this set's rule_index to the one passed in.
-			calc_active_output_level(var_num + 1, activation_level, rule_index + set->get_rule_index(), var_idx_arr, out_set_dom_arr);  
+	// rule indexes are ints, if there are too many combinations we can't have any rules
+	if (new_mem_size < 0)
+		{
+		set_msg_text(ERR_TOO_MANY_RULES);
+		rules->alloc(0);
+		return;
+		}
 
-			}
-		else
-			{
-			// we're dealing with the output variable
+	// anytime we add a new variable (even if we're copying an existing one) we
+	// loose all the rules so we just call alloc
 
-			// we need to deal with this set, save the activation level...
-	  		old_activation_level = activation_level;
+	rules->alloc(new_mem_size);
+	
+ 	// re-calc at the variable index factors...
  
-			// if there is a rule for the rule_index passed in, set the output set's DOM
-			if (rule_exists(rule_index))
-				{
-				// SUB 1 from activation level cuz that's from 0 to MAX_DOM and
-				// we're setting an INDEX
+	calc_rule_index_wrapper();
  
-				set_output_dom(out_set_dom_arr, rules->get_rule(rule_index), activation_level - 1);
-				}
-			
-			} // end if output var
-
-		// reset the activation level...  
- 	 	activation_level = old_activation_level;
+} // end FuzzyModelBase::add_input_var_to_list()
  
-		} // end loop through sets
-
-} // end FuzzyModelBase::calc_active_output_level()
-
 
 //
 // Function:	save_to_fcl_file()
@@ -1307,6 +2103,7 @@ int FuzzyModelBase::save_to_fcl_file(const char* file_name)
 // ------		----		------------
 // Michael Z	05/02		Updating so writing out rules adhears to the FCL standard
 //							more closely
+// Ming-Kai Jiau 2026/10/16	Only write the defined rules if the rules are sparse
 //
 // 
  
@@ -1430,9 +2227,18 @@ void FuzzyModelBase::save_rules_to_fcl_file(std::ofstream& file_contents) const
 
 	RuleArrayType rule;	// rule we're dealing with
 	int*	set_idx_array = new int[input_var_count];
-	char	tmp[4];
- 	for (i = 0; i < get_num_of_rules(); i++)
+	char	tmp[16];
+
+	// if the rules are sparse only write the ones that are defined, there
+	// are too many combinations to list them all
+	std::vector<int> index_arr;
+	bool	sparse = rules->is_sparse();
+	int		num_rules = sparse ? rules->get_rule_indexes(index_arr) : get_num_of_rules();
+
+ 	for (int k = 0; k < num_rules; k++)
 		{
+		i = sparse ? index_arr[k] : k;
+
 		rule = rules->get_rule(i);
 
 		file_contents << "\t";
@@ -1504,7 +2310,7 @@ void FuzzyModelBase::save_rules_to_fcl_file(std::ofstream& file_contents) const
 // Function:	load_from_fcl_file()
 // 
 // Purpose:		Main function to read in an FCL file and create a model.
-//				NOTE: It is a BRAIN-DEAD parser. 
+//				The whole file is read in and handed to load_from_fcl_text().
 // Arguments:
 //
 //		const char* file_name - file to read
@@ -1518,8 +2324,11 @@ void FuzzyModelBase::save_rules_to_fcl_file(std::ofstream& file_contents) const
 // Date:	9/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Build the active set lists for the input vars
+// Ming-Kai Jiau	2026/10/16	Compile the model
+// Ming-Kai Jiau	2026/10/16	Read the file once and parse it in a single pass
 //
 // 
 
@@ -1531,7 +2340,7 @@ int FuzzyModelBase::load_from_fcl_file(const char* file_name)
 	// iostream objects are constructed before main() starts and destructed
 	// after mian() exits so the memory leak detection will report a false leak
 
- 	std::ifstream file_contents(file_name);
+ 	std::ifstream file_contents(file_name, std::ios::in | std::ios::binary);
 
  	if (!(file_contents.is_open()))
 		{
@@ -1539,43 +2348,13 @@ int FuzzyModelBase::load_from_fcl_file(const char* file_name)
 		return -1;
 		}
 
-	// load input variables
-	if (load_vars_from_fcl_file(file_contents))
-		return -1;	// error is written to msg_txt in the called func
- 
-	// load the output variable
- 	if (load_vars_from_fcl_file(file_contents, true))  
-		return -1;	// error is written to msg_txt in the called func
-
-	// load sets for each var
-	for (int i = 0; i < input_var_count; i++)
-		{
- 	  	if (input_var_arr[i]->load_sets_from_fcl_file(file_contents))
-			{
-			// get the message text and set it for the model
-			set_msg_text(input_var_arr[i]->get_msg_text());
-			return -1;
-			}
-		} // end loop through input vars
-
-	if (output_var)
-		{
-		if (output_var->load_sets_from_fcl_file(file_contents))
-			{
-			// get the message text and set it for the model
-			set_msg_text(output_var->get_msg_text());
-			return -1;
-			}
-		} // end if output var
+	std::ostringstream fcl_text;
 
-	if (load_rules_from_fcl_file(file_contents))
-		return -1;	// error is written to msg_txt in the called func
+	fcl_text << file_contents.rdbuf();
 
-	if (load_defuzz_block_from_fcl_file(file_contents))
-		return -1;	// error is written to msg_txt in the called func
- 
-	return 0;
+	std::string text = fcl_text.str();
 
+	return load_from_fcl_text(text.c_str(), text.length());
 
 } // end FuzzyModelBase::load_from_fcl_file()
 
@@ -1584,7 +2363,7 @@ int FuzzyModelBase::load_from_fcl_file(const char* file_name)
 // Function:	load_from_fcl_string()
 // 
 // Purpose:		Main function to read an FCL string in and create a model.
-//				NOTE: It is a BRAIN-DEAD parser. 
+//
 // Arguments:
 //
 //		const char* fcl_str - fcl string to read
@@ -1598,70 +2377,219 @@ int FuzzyModelBase::load_from_fcl_file(const char* file_name)
 // Date:	2019/03/30
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Build the active set lists for the input vars
+// Ming-Kai Jiau	2026/10/16	Compile the model
+// Ming-Kai Jiau	2026/10/16	Parse the string in place in a single pass
+// Ming-Kai Jiau	2026/10/16	Load with load_from_fcl_buffer()
 //
 // 
 
 int FuzzyModelBase::load_from_fcl_string(const char* fcl_str)
 {
-	std::istringstream file_contents(fcl_str);
+	return load_from_fcl_buffer(fcl_str, (fcl_str == NULL) ? 0 : strlen(fcl_str));
 
-	if ((fcl_str == NULL) || (fcl_str[0] == '\0'))
+} // end FuzzyModelBase::load_from_fcl_string()
+
+
+//
+// Function:	load_from_fcl_buffer()
+// 
+// Purpose:		Read FCL text that isn't NULL terminated and create a model. The
+//				text is parsed where it is, nothing is copied, so the caller can
+//				pass any part of a larger buffer. The buffer isn't needed once
+//				this returns.
+//
+// Arguments:
+//
+//		const char*	data	-	FCL text to read
+//		size_t		length	-	number of characters in the text
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+// 
+
+int FuzzyModelBase::load_from_fcl_buffer(const char* data, size_t length)
+{
+	if ((data == NULL) || (length == 0))
 	{
 		set_msg_text(ERR_READING_STRING);
 		return -1;
 	}
 
-	// load input variables
-	if (load_vars_from_fcl_file(file_contents))
-		return -1;	// error is written to msg_txt in the called func
+	return load_from_fcl_text(data, length);
 
-					// load the output variable
-	if (load_vars_from_fcl_file(file_contents, true))
-		return -1;	// error is written to msg_txt in the called func
+} // end FuzzyModelBase::load_from_fcl_buffer()
 
-					// load sets for each var
-	for (int i = 0; i < input_var_count; i++)
-	{
-		if (input_var_arr[i]->load_sets_from_fcl_file(file_contents))
+
+//
+// Function:	load_from_fcl_text()
+// 
+// Purpose:		Creates the model from FCL text. This walks the text ONCE, from start
+//				to end, handing each block off to the function that loads it as we
+//				come to it. The blocks must be in the order IEC 61131-7 lists them:
+//				a variable has to be declared (VAR_INPUT/VAR_OUTPUT) before its
+//				FUZZIFY block, and the FUZZIFY blocks have to come before the RULEBLOCK.
+//				The DEFUZZIFY block can be anywhere. Errors say the line and column
+//				they were found at.
+//
+// Arguments:
+//
+//		const char*	text	-	FCL text to read (doesn't need to be NULL terminated)
+//		size_t		length	-	number of characters in the text
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Match FUZZIFY blocks to the variables without converting their IDs
+//
+// 
+
+int FuzzyModelBase::load_from_fcl_text(const char* text, size_t length)
+{
+	FCLTokenizer			tokens(text, length);
+	FCLTokenizer::_token	token;			// token we're dealing with
+	bool					found_input = false;	// found the VAR_INPUT block
+	bool					found_output = false;	// found the VAR_OUTPUT block
+	bool					found_rules = false;	// found the RULEBLOCK
+	int						method = -1;			// defuzzification method, -1 for the default
+
+	std::vector<FuzzyVariableBase*> fuzzified;		// vars we've loaded the sets for
+
+	while (tokens.next(&token) != FCLTokenizer::TOKEN_END)
 		{
-			// get the message text and set it for the model
-			set_msg_text(input_var_arr[i]->get_msg_text());
-			return -1;
+		if (token.type != FCLTokenizer::TOKEN_WORD)
+			continue;	// nothing we care about
+
+		if (FCLTokenizer::equals(token, FuzzyVariableBase::get_fcl_block_start()))
+			{
+			found_input = true;
+
+			if (load_vars_from_fcl_file(tokens))
+				return -1;	// error is written to msg_txt in the called func
+			}
+		else if (FCLTokenizer::equals(token, FuzzyOutVariable::get_fcl_block_start()))
+			{
+			found_output = true;
+
+			if (load_vars_from_fcl_file(tokens, true))
+				return -1;	// error is written to msg_txt in the called func
+			}
+		else if (FCLTokenizer::equals(token, "FUZZIFY"))
+			{
+			// find the variable this block is for...
+			FuzzyVariableBase* var = NULL;
+
+			tokens.next(&token);
+
+			for (int i = OUTPUT_IDX; i < input_var_count && var == NULL; i++)
+				{
+				FuzzyVariableBase* tmp_var = get_var(i);
+
+				if (tmp_var == NULL)
+					continue;
+
+				if (FCLTokenizer::equals(token, tmp_var->get_id()))
+					var = tmp_var;
+
+				} // end loop through vars
+
+			// skip blocks for variables we don't have or already loaded
+			if (var == NULL || std::find(fuzzified.begin(), fuzzified.end(), var) != fuzzified.end())
+				{
+				if (!tokens.skip_to("END_FUZZIFY", &token))
+					{
+					set_msg_text(ERR_EOF_READING_SETS, token.line, token.column);
+					return -1;
+					}
+
+				continue;
+				}
+
+			if (var->load_sets_from_fcl_file(tokens))
+				{
+				// get the message text and set it for the model
+				set_msg_text(var->get_msg_text());
+				return -1;
+				}
+
+			fuzzified.push_back(var);
+
+			}
+		else if (FCLTokenizer::equals(token, "DEFUZZIFY"))
+			{
+			if (load_defuzz_block_from_fcl_file(tokens, &method))
+				return -1;	// error is written to msg_txt in the called func
+			}
+		else if (FCLTokenizer::equals(token, "RULEBLOCK"))
+			{
+			found_rules = true;
+
+			if (load_rules_from_fcl_file(tokens))
+				return -1;	// error is written to msg_txt in the called func
+			}
+
+		} // end while not end of text
+
+	// make sure we got everything...
+	if (!found_input || !found_output)
+		{
+		set_msg_text(ERR_EOF_READING_VARS, token.line, token.column);
+		return -1;
 		}
-	} // end loop through input vars
 
-	if (output_var)
-	{
-		if (output_var->load_sets_from_fcl_file(file_contents))
+	if (fuzzified.size() != static_cast<size_t>(get_total_var_count()))
 		{
-			// get the message text and set it for the model
-			set_msg_text(output_var->get_msg_text());
-			return -1;
+		set_msg_text(ERR_EOF_READING_SETS, token.line, token.column);
+		return -1;
 		}
-	} // end if output var
 
-	if (load_rules_from_fcl_file(file_contents))
-		return -1;	// error is written to msg_txt in the called func
+	if (!found_rules)
+		{
+		set_msg_text(ERR_EOF_READING_RULES, token.line, token.column);
+		return -1;
+		}
 
-	if (load_defuzz_block_from_fcl_file(file_contents))
+	// "CoG" or no method... for singletons that's the weighted average
+	set_defuzz_method((method < 0) ? get_default_defuzz_method() : method);
+
+	// compile the model now so calc_output() never has to
+	if (compile())
 		return -1;	// error is written to msg_txt in the called func
 
 	return 0;
 
-
-} // end FuzzyModelBase::load_from_fcl_string()
+} // end FuzzyModelBase::load_from_fcl_text()
 
 
 //
 // Function:	load_vars_from_fcl_file()
 // 
-// Purpose:		Loads the variables from the FCL file and creates them.
+// Purpose:		Loads the variables from the FCL file and creates them. The tokenizer
+//				is just past "VAR_INPUT" (or "VAR_OUTPUT") and is left just past "END_VAR".
 //
 // Arguments:
 //
-//		std::istream&	file_contnts	- file to read from
+//		FCLTokenizer&	tokens			-	FCL text we're reading
 //		bool			output_ind		-	indicates if we're reading the output variable
 //
 // Returns:
@@ -1673,47 +2601,25 @@ int FuzzyModelBase::load_from_fcl_string(const char* fcl_str)
 // Date:	9/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Read the variable's RESOLUTION from the range comment
+// Ming-Kai Jiau	2026/10/16	Read from the tokenizer rather than line-by-line and
+//								report where errors are
+// Ming-Kai Jiau	2026/10/16	Widen the name straight from the text
 //
 //	
 
-int FuzzyModelBase::load_vars_from_fcl_file(std::istream& file_contents, bool output /* = false */)
+int FuzzyModelBase::load_vars_from_fcl_file(FCLTokenizer& tokens, bool output /* = false */)
 {
-		
-	const char* start_token;// starting token (depends on input or output)
 	const char* end_token;	// ending token (depends on input or output)
 
 	if (output)
-		{
-		start_token = FuzzyOutVariable::get_fcl_block_start();
 		end_token = FuzzyOutVariable::get_fcl_block_end();
-		}
 	else
-		{
-		start_token = FuzzyVariableBase::get_fcl_block_start();
 		end_token = FuzzyVariableBase::get_fcl_block_end();
-		}
 
- 	file_contents.seekg(0);	// go to start of file
-
- 	std::string token;
- 
-	do 
-		{
-		file_contents >> token;
-		// if token is empty we reached EOF
-		if (file_contents.eof())
-			{
-			set_msg_text(ERR_EOF_READING_VARS);
- 			return -1; 
-			}
-		}while (strcmp(token.c_str(), start_token) != 0);
-
-
-  	// parse names...
-	// AGAIN... this is BRAIN-DEAD parsing, we're assuming the 
-	// input vars have the format:
+	// the input vars have the format:
 	//
 	// VAR_INPUT  
 	//		variable_1_name: REAL;
@@ -1730,33 +2636,56 @@ int FuzzyModelBase::load_vars_from_fcl_file(std::istream& file_contents, bool ou
 	// END_VAR
 	//
 	// NOTE: the IEC 61131-7 does not specify a way to set the range of a varaible, so 
-	// we write them out in a range comment
+	// we write them out in a range comment. The comment may also have the number of
+	// values the variable is quantized to if it's not the default:
+	//
+	//		variable_name: REAL; (* RANGE(0 .. 100) RESOLUTION(1001) *)
+	//
+	// The colon is optional, FFLL writes a tab there.
 
- 	char line[300];
-	char var_name[50];
+	FCLTokenizer::_token token;		// token we're dealing with
 	RealType start_val, end_val;	// range for the variable
 
-	// get line-by-line until we reach END_VAR
-	file_contents.getline(line, 300);
-
-	while (strncmp(line, end_token, strlen(end_token)) != 0)
+	// read until we reach END_VAR
+	while (tokens.next(&token) != FCLTokenizer::TOKEN_END)
 		{
+		if (token.type == FCLTokenizer::TOKEN_WORD && FCLTokenizer::equals(token, end_token))
+			return 0;	// we're done
+
+		if (token.type != FCLTokenizer::TOKEN_WORD)
+			{
+			set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
+			return -1;
+			}
+
 		start_val = end_val = FLT_MIN; // init so we know if we have a range for the variable
 
- 		var_name[0] = '\0';
+		std::wstring var_name = FCLTokenizer::to_wstring(token);
+
+		// skip the type, up to the semicolon
+		do
+			{
+			if (tokens.next(&token) == FCLTokenizer::TOKEN_END || 
+				(token.type == FCLTokenizer::TOKEN_WORD && FCLTokenizer::equals(token, end_token)))
+				{
+				set_msg_text(ERR_EOF_READING_VARS, token.line, token.column);
+				return -1;
+				}
+
+			} while (!(token.type == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, ";")));
 
-		// defined a var... find "REAL" in it and anything before that is the variable name
-		sscanf(line, "%s", var_name);
+		int resolution = 0;	// x_array_count for the variable, 0 for the default
 
-		if (strlen(var_name) > 0) // deal with lines that are just spaces
+		// find the range of the variable, it's in a comment on the same line
+		FCLTokenizer::_token comment;
+
+		if (tokens.next_comment(token.line, &comment))
 			{
- 			// find the range of the variable
- 			 
+			std::string line = FCLTokenizer::to_string(comment);
+
 			// find "RANGE"
-			char* pos = strstr(line, "RANGE(");
+			const char* pos = strstr(line.c_str(), "RANGE(");
 
-			char* num_start;
-			char* num_end;
 			char* stop_scan; // used for strtod
 
 			if (pos != NULL)
@@ -1765,92 +2694,102 @@ int FuzzyModelBase::load_vars_from_fcl_file(std::istream& file_contents, bool ou
 
 				pos += strlen("RANGE(");
 
-				// found start of 1st number, save position
-				num_start = pos;
+				// find ".."
+				const char* num_end = strstr(pos, "..");
+
+				if (num_end == NULL)
+					{
+					set_msg_text(ERR_VAR_MIN_VALUE, comment.line, comment.column);
+ 					return -1; 
+					}
 
-				// find ".."
-				pos = num_end = strstr(pos, "..");
-			 
 				// get the substring and convert...
-				char value[50];
-				int num_len = num_end - num_start;
-				
-				memset(value, '\0', 50);
+				std::string value(pos, num_end - pos);
 
-				strncpy(value, num_start, num_len);
-
-				start_val = strtod(value, &stop_scan);
+				start_val = strtod(value.c_str(), &stop_scan);
  
 				if (fabs(start_val) == HUGE_VAL)
 					{
 					// error converting...
-					set_msg_text(ERR_VAR_MIN_VALUE);
+					set_msg_text(ERR_VAR_MIN_VALUE, comment.line, comment.column);
  					return -1; 
 					}
 
-				pos += strlen(".."); // puts us at the start of the next number
+				pos = num_end + strlen(".."); // puts us at the start of the next number
 
 				// find the ending ')'
-				num_start = pos;
-
 				num_end = strstr(pos, ")");
 
-				memset(value, '\0', 50);
-
-				num_len = num_end - num_start;
+				if (num_end == NULL)
+					{
+					set_msg_text(ERR_VAR_MAX_VALUE, comment.line, comment.column);
+ 					return -1; 
+					}
 
-				strncpy(value, num_start, num_len);
+				value.assign(pos, num_end - pos);
 
-				end_val = strtod(value, &stop_scan);
+				end_val = strtod(value.c_str(), &stop_scan);
 
 				if (fabs(end_val) == HUGE_VAL)
 					{
 					// error converting...
-					set_msg_text(ERR_VAR_MAX_VALUE);
+					set_msg_text(ERR_VAR_MAX_VALUE, comment.line, comment.column);
  					return -1; 
 					}
 
 				} // end found token RANGE
 
-			int ret_val;	// holds return value
+			pos = strstr(line.c_str(), "RESOLUTION(");
 
-			// convert var_name to wide chars...
-			wchar_t* wname = convert_to_wide_char(var_name);
+			if (pos != NULL)
+				resolution = strtol(pos + strlen("RESOLUTION("), NULL, 10);
 
-			// create the variable
-			if (output)
-				{
-				ret_val = add_output_variable(wname, start_val, end_val);
-				}
-			else
-				{
-				ret_val = add_input_variable(wname, start_val, end_val);
-				}
+			} // end if found a comment
+
+		int ret_val;	// holds return value
 
-			delete[] wname;
+		// create the variable
+		if (output)
+			{
+			ret_val = add_output_variable(var_name.c_str(), start_val, end_val);
+			}
+		else
+			{
+			ret_val = add_input_variable(var_name.c_str(), start_val, end_val);
+			}
  
-			if (ret_val)
-				return -1; // error is written in called func
+		if (ret_val)
+			return -1; // error is written in called func
 
-			} // end if line is not null
+		if (resolution)
+			{
+			// the variable has no sets yet so this just sets the count
+			FuzzyVariableBase* var = output ? output_var : input_var_arr[input_var_count - 1];
 
-		// get the next line
-		file_contents.getline(line, 300);
+			if (var->set_x_array_count(resolution))
+				{
+				set_msg_text(var->get_msg_text());
+				return -1;
+				}
+			}
 
 		}; // end while not END_VAR
 
-	return 0;
+	set_msg_text(ERR_EOF_READING_VARS, token.line, token.column);
+
+	return -1;
 
 } // end FuzzyModelBase::load_input_vars_from_file()
 
 //
 // Function:	load_rules_from_fcl_file()
 // 
-// Purpose:		Loads the rules from the FCL file and creates them.
+// Purpose:		Loads the rules from the FCL file and creates them. The tokenizer
+//				is just past "RULEBLOCK" and is left just past "END_RULEBLOCK".
 //
 // Arguments:
 //
-//		std::istream&	file_contnts	- file to read from
+//		FCLTokenizer&	tokens	-	FCL text we're reading
 //
 // Returns:
 //
@@ -1861,344 +2800,361 @@ int FuzzyModelBase::load_vars_from_fcl_file(std::istream& file_contents, bool ou
 // Date:	9/01
 // 
 // Modification History
-//	Author		Date		Modification
-//	------		----		------------
-//	Michael Z	6/02		modifying so we read what the FCL standard says we should:
-//								subcondition ::= (�NOT???variable_name �IS?[�NOT'] ) term_name ?? | ( variable_name �IS?[�NOT�] term_name ) 
-//							NOTE: we still don't support the 'NOT' option
-//							as opposed to the way we were doing it which was just:
-//								subcondition ::= term_name
-//							both methods will be supported for backwards compatibility
-
-int FuzzyModelBase::load_rules_from_fcl_file(std::istream& file_contents)
-{
-	// a very brain-dead parser of the RULEBLOCK section, this assumes that we have
-	// a line for every rule (even if one does not exist, there's a comment).  It also
-	// assumes that the rule number corresponds to the index into the rules array.
-	// the safest way is to map the rule conditions to the var/sets and calculate the
-	// rule index from that
-
-	// this assumes that the sets involved in the rules are in the same order as
+//	Author			Date		Modification
+//	------			----		------------
+//	Michael Z		6/02		modifying so we read what the FCL standard says we should:
+//									subcondition ::= (�NOT???variable_name �IS?[�NOT'] ) term_name ?? | ( variable_name �IS?[�NOT�] term_name ) 
+//								NOTE: we still don't support the 'NOT' option
+//								as opposed to the way we were doing it which was just:
+//									subcondition ::= term_name
+//								both methods will be supported for backwards compatibility
+//	Ming-Kai Jiau	2026/10/16	Read from the tokenizer, a condition can now name its
+//								variable (in any order) or just the term (in the order
+//								the variables are declared), and report where errors are
+//	Ming-Kai Jiau	2026/10/16	Hash the set names rather than searching them for each term
+//	Ming-Kai Jiau	2026/10/16	Share one look up key between the rules
+
+int FuzzyModelBase::load_rules_from_fcl_file(FCLTokenizer& tokens)
+{
+	// each rule is mapped to the index into the rules array by looking up the sets 
+	// in its conditions.
+
+	// if a condition doesn't name its variable it's assumed the terms are in the order
 	// the varaibles are declared.  Since there is no restriction that set names
 	// must be unique for the whole system we need to make this assumption, short 
 	// of using some dot notation (var1.set1) which I don't believe is supported
 	// by the IEC standard
-
-	// we have a nice happy little situation here... we don't care about any of the
-	// conditions for the rules!  all we care about is the rule # which is the index in
-	// the rules array, and the result which we need to map to the index of the output set.
 			
-	char line[500];
+	// hash the set IDs for each variable (including output) so each term in the rules
+	// is a single look up no matter how many sets there are. If two sets have the 
+	// same name the first one wins.
+	FCLNameMap* sets = new FCLNameMap[input_var_count + 1]; // add one for output var
 
-	// create array of output sets...
-	FuzzyVariableBase* var = get_var(OUTPUT_IDX);
+	// the variable names, to find the variable a condition names
+	FCLNameMap var_names;
 
-	int num_sets = 0;
+	FuzzyVariableBase* var;	// var we're dealing with
+	int i, j;				// counter 
 
-	if (var)
-		num_sets = var->get_num_of_sets();
-
-	// create an array of arrays that holds the set IDs for each variable (including output)
-	std::string** sets = new std::string*[input_var_count + 1]; // add one for output var
-
-	int i, j;		// counter 
-
-	// loop through the input vars
-	for (i = 0; i < input_var_count; i++)
+	// loop through the vars, the output var is last
+	for (i = 0; i <= input_var_count; i++)
 		{
-		var = get_var(i);
+		var = get_var((i == input_var_count) ? OUTPUT_IDX : i);
 
-		num_sets = get_num_of_sets(i);
+		int num_sets = var->get_num_of_sets();
 
-		// create an array of strings that has 'num_sets' elements
-		sets[i] = new std::string[num_sets];
+		sets[i].reserve(num_sets);
 
 		for (j = 0; j < num_sets; j++)
 			{
 			// convert the set's ID to ascii and replace any spaces with underscores
  			char* aid = convert_to_ascii(var->get_id(j), '_');
  
-			// add it to the array
-			sets[i][j] = aid;			
+			// add it to the map
+			sets[i].insert(FCLNameMap::value_type(aid, j));
 
 			delete[] aid;
 
 			} // end loop through sets
 
-		} // end loop through input vars
+		if (i < input_var_count)
+			{
+			char* var_aid = convert_to_ascii(var->get_id(), '_');
 
-	// add the output variable's sets...
-	num_sets = get_num_of_sets(OUTPUT_IDX);
-	sets[i] = new std::string[num_sets];
+			var_names.insert(FCLNameMap::value_type(var_aid, i));
 
-	var = get_var(OUTPUT_IDX);
+			delete[] var_aid;
+			}
 
-	for (j = 0; j < num_sets; j++)
-		{
- 		char* aid = convert_to_ascii(var->get_id(j), '_');
- 
-		sets[i][j] = aid;			
+		} // end loop through vars
 
-		delete[] aid;
-		} // end loop through output sets
+	FCLTokenizer::_token token;	// token we're dealing with
 
-	std::string tmp; // temp string to hold tokens
-	// read until we get to the start of the rules declaration
+	int ret_val = 0;			// return value
 
-	do
-		{
-		file_contents >> tmp;
-		} while (strcmp(tmp.c_str(), "RULEBLOCK") != 0 );
+	std::string key;			// name being looked up, reused so looking up a term doesn't allocate
 
-	file_contents >> tmp; // "eat" the rule block name which isn't significant
+	tokens.next(&token); // "eat" the rule block name which isn't significant
 
-	// read in the operator definition (brain-dead as we are, assume it's there!)
-	// we read in the whole next line - ASSUMING it's the operator
+	// now read the statements, the rule array was allocated when sets were added.
+	// NOTE that all these comparisons are case SENSITIVE!
+	while (ret_val == 0)
+		{
+		if (tokens.next(&token) == FCLTokenizer::TOKEN_END)
+			{
+			set_msg_text(ERR_EOF_READING_RULES, token.line, token.column);
+			ret_val = -1;
+			break;
+			}
 
-	line[0] = '\0';
-	// skip blank lines
-	while (strlen(line) <= 0)
-		file_contents.getline(line, 50);
+		if (token.type != FCLTokenizer::TOKEN_WORD)
+			continue;	// stray symbol, ignore it
 
-	// parse it...
- 	char seps[]   = " :;\t\n";
+		if (FCLTokenizer::equals(token, "END_RULEBLOCK"))
+			break;	// we're done
 
-	// right now we only care about the first part (before the colon)...
-	char* operation = strtok(line, seps);
+		if (FCLTokenizer::starts_with(token, "AND") || FCLTokenizer::equals(token, "ACT"))
+			{
+			// right now we only support MIN for 'and' (and activation) so skip it
+			if (!tokens.skip_to(";", &token))
+				{
+				set_msg_text(ERR_EOF_READING_RULES, token.line, token.column);
+				ret_val = -1;
+				}
+			}
+		else if (FCLTokenizer::starts_with(token, "OR"))
+			{
+			// we don't support 'or'
+			set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
+			ret_val = -1;
+			}
+		else if (FCLTokenizer::starts_with(token, "ACCU"))
+			{
+			// get the accumm method ("ACCU" or "ACCUM" : method)
+			while (tokens.next(&token) == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, ":"))
+				; // skip the colon
 
-	// right now we only support 'and'
-	if (strncmp(operation, "AND", strlen("AND")) == 0)
-		{
+			if (token.type == FCLTokenizer::TOKEN_WORD && FCLTokenizer::equals(token, "BSUM"))
+				{
+				set_composition_method(FuzzyOutVariable::COMPOSITION_OPERATION_MIN);
+				}
+			else if (token.type == FCLTokenizer::TOKEN_WORD && FCLTokenizer::equals(token, "MAX"))
+				{
+				set_composition_method(FuzzyOutVariable::COMPOSITION_OPERATION_MAX);
+				}
+			else
+				{
+				set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
+				ret_val = -1;
+				}
+			}
+		else if (FCLTokenizer::equals(token, "RULE"))
+			{
+			// found a rule, it's in the form:
+			//
+			//		RULE n: IF condition AND condition ... THEN conclusion [WITH weight];
+			//
+			// where a condition is either "(variable_name IS term_name)" or the FFLL 
+			// shorthand of just "term_name" and the conclusion is one of
+			// "(variable_name IS term_name)" or "term_name". The parens are optional.
 
-		}
-	else
-		{
-		set_msg_text(ERR_INVALID_FILE_FORMAT);
-		return -1;
-		}
+			ret_val = load_rule_from_fcl_file(tokens, sets, var_names, &key);
+
+			} // end if found a rule
 
-	// read in the ACCU method...
+		}; // end while not end ruleblock
 
-	line[0] = '\0';
-	// skip blank lines
-	while (strlen(line) <= 0)
-		file_contents.getline(line, 50);
+	// free the memory we allocated
+	delete[] sets;
+	
+	return ret_val;
 
-	char* accum = strtok(line, seps);
+} // end FuzzyModelBase::load_rules_from_file()
 
-	// sanity check
-	if (strncmp(accum, "ACCU", strlen("ACCU")) != 0)
-		{
-		set_msg_text(ERR_INVALID_FILE_FORMAT);
-		return -1;
-		}
 
-	accum = strtok(NULL, seps); 
+//
+// Function:	load_rule_from_fcl_file()
+// 
+// Purpose:		Loads a single rule from the FCL file and adds it. The tokenizer is
+//				just past the "RULE" keyword and is left just past the rule.
+//
+// Arguments:
+//
+//		FCLTokenizer&		tokens		-	FCL text we're reading
+//		const FCLNameMap*	sets		-	set index by name for each variable (output var last)
+//		const FCLNameMap&	var_names	-	input variable index by name
+//		std::string*		key			-	buffer for the names we look up
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+// 
 
-	// get the accumm method
+int FuzzyModelBase::load_rule_from_fcl_file(FCLTokenizer& tokens, const FCLNameMap* sets, const FCLNameMap& var_names, std::string* key)
+{
+	FCLTokenizer::_token token;	// token we're dealing with
+	FCLTokenizer::_token term;	// term name token
+	FCLNameMap::const_iterator found;	// name we looked up
 
-	if (strncmp(accum, "BSUM", strlen("BSUM")) == 0)
+	// look for the first condition, after the "IF"
+	if (!tokens.skip_to("IF", &token))
 		{
-		set_composition_method(FuzzyOutVariable::COMPOSITION_OPERATION_MIN);
-		}
-	else if (strncmp(accum, "MAX", strlen("MAX")) == 0)
-		{
-		set_composition_method(FuzzyOutVariable::COMPOSITION_OPERATION_MAX);
-		}
-	else
-		{
-		set_msg_text(ERR_INVALID_FILE_FORMAT);
+		set_msg_text(ERR_EOF_READING_RULES, token.line, token.column);
 		return -1;
 		}
 
-	// now create the rules, the rule array was allocated when sets were added
-	// we want to avoid the line-by-line method cuz rules can span more than one line
+	int rule_idx = 0;		// index into the rules array
+	int component_idx = 0;	// which condition we're dealing with
 
-	std::string* rule_components = new std::string[input_var_count + 1]; // +1 for output var
+	// read the conditions until we find THEN
+	do
+		{
+		bool in_parens = (tokens.next(&token) == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, "("));
 
-	file_contents >> tmp;
-			
-	bool strict_parsing = false;
+		if (in_parens)
+			tokens.next(&token);
 
-	while (strcmp(tmp.c_str(), "END_RULEBLOCK") != 0)
-		{
-		if (file_contents.eof())
+		if (token.type != FCLTokenizer::TOKEN_WORD)
 			{
-			set_msg_text(ERR_EOF_READING_RULES);
- 			return -1;
+			set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
+			return -1;
 			}
 
-		// check if comment
+		// if the next token is "IS" this names the variable, otherwise it's just
+		// the term and we assume it's for the variable in this position
+		int var_idx = component_idx;
 
-		if (strncmp(tmp.c_str(), "(*", sizeof("(*")) == 0)
-			{
-			// found a comment
-			// skip the rest of the line. Note, as this is a brain-dead parser
-			// it assumes no multi-line comments!
-			file_contents.getline(line, 500);
-			} // end if found a comment
+		tokens.peek(&term);
 
-		if (strcmp(tmp.c_str(), "RULE") == 0)
+		if (term.type == FCLTokenizer::TOKEN_WORD && FCLTokenizer::equals(term, "IS"))
 			{
+			key->assign(token.text, token.length);
+			found = var_names.find(*key);
 
-			int component_idx = 0;	// which component we're dealing with
-			// found a rule
+			if (found != var_names.end())
+				var_idx = found->second;
 
-			// get the rule components...
-			// look for the first condition, after the "IF"
-			do
+			tokens.next(&term);	// "IS"
+			tokens.next(&term);	// term name
+
+			if (term.type != FCLTokenizer::TOKEN_WORD)
 				{
-				file_contents >> tmp;
-				} while (strcmp(tmp.c_str(), "IF") != 0);
+				set_msg_text(ERR_INVALID_FILE_FORMAT, term.line, term.column);
+				return -1;
+				}
+			}
+		else
+			{
+			term = token;
+			}
 
-			// we need to determine if this FCL file has the FFLL "shorthand" of just the term name
-			// or if it adhears to the FCL standard...
-			// NOTE that whichever method is used, it is ASSUMED that the terms are in the order
-			// that the varaiable are declared (again, lazy parsing!)
+		if (var_idx >= input_var_count)
+			{
+			// more conditions than input variables
+			set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
+			return -1;
+			}
 
-			// if next token is '(' we're gonna assume we have a FCL file that uses the stricter
-			// compliance with the FCL and NOT the FFLL shorthand of just naming the term name.
+		// find match between the term and the sets saved
+		key->assign(term.text, term.length);
+		found = sets[var_idx].find(*key);
 
-			file_contents >> tmp;
+		if (found != sets[var_idx].end())
+			rule_idx += get_rule_index(var_idx, found->second);
 
-			if (tmp[0] == '(')
-				{
-				// use strict FCL parsing
+		component_idx++;
 
-				strict_parsing = true;
+		tokens.next(&token);
 
-				}
-			else
-				{
-				// use FFLL shorthand...
-				strict_parsing = false;
-				rule_components[component_idx++] = tmp;  // next condition
-				file_contents >> tmp;  // next token (could be "AND" or "THEN"
-				} // end if FFLL rule shorthand notation
-
- 	//		file_contents >> rule_components[component_idx++];  // next condition
-
-			// loop through the rest until we find THEN
-			// NOTE that all these comparisons are case SENSITIVE!
-		//	file_contents >> tmp;  // next token (could be "AND" or "THEN"
-			while (strcmp(tmp.c_str(), "THEN") != 0)
+		if (in_parens)
+			{
+			if (!(token.type == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, ")")))
 				{
-				if (strict_parsing)
-					{
-					// look for the token after ' IS '
-					do
-						{
-						file_contents >> tmp;
-						} while (strcmp(tmp.c_str(), "IS") != 0);
-				
-					file_contents >> rule_components[component_idx];  // next condition
+				set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
+				return -1;
+				}
 
-					// remove any trailing ')' that may be there
-					int paren_pos = rule_components[component_idx].find(")");
+			tokens.next(&token);
+			}
 
-					if (paren_pos > 0)	// NOTE: we only check > 0 rather than >= cuz if it's = 0 we have nothing
-						(rule_components[component_idx])[paren_pos] = '\0';
+		// next token has to be "AND" or "THEN"
+		if (token.type != FCLTokenizer::TOKEN_WORD || 
+			!(FCLTokenizer::equals(token, "AND") || FCLTokenizer::equals(token, "THEN")))
+			{
+			if (token.type == FCLTokenizer::TOKEN_END)
+				set_msg_text(ERR_EOF_READING_RULES, token.line, token.column);
+			else
+				set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
 
-					component_idx++;
+			return -1;
+			}
 
-					file_contents >> tmp; // next token (could be "AND" or "THEN"
+		} while (!FCLTokenizer::equals(token, "THEN"));
 
-					}
-			 	else
-					{
-					file_contents >> rule_components[component_idx++];  // next condition
-					file_contents >> tmp; // next token (could be "AND" or "THEN"
-					}
+	// found THEN so next is the result
+	bool in_parens = (tokens.next(&token) == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, "("));
 
- 
-				} ; // end while != THEN
+	if (in_parens)
+		tokens.next(&token);
 
-			// found THEN so next token is the result
-			if (strict_parsing)
-				{
-				// look for the token after ' IS '
-				do
-					{
-					file_contents >> tmp;
-					} while (strcmp(tmp.c_str(), "IS") != 0);
+	term = token;
 
-				} // end if strict parsing
- 
-			file_contents >> rule_components[component_idx];
-			// make sure the ';' isn't included
-			int semi_pos = rule_components[component_idx].find(";");
+	tokens.peek(&token);
 
-			if (semi_pos > 0)	// NOTE: we only check > 0 rather than >= cuz if it's = 0 we have nothing
-				(rule_components[component_idx])[semi_pos] = '\0';
+	if (token.type == FCLTokenizer::TOKEN_WORD && FCLTokenizer::equals(token, "IS"))
+		{
+		tokens.next(&token);	// "IS"
+		tokens.next(&term);		// term name
+		}
 
-			// remove any trailing ')' that may be there
-			int paren_pos = rule_components[component_idx].find(")");
+	if (term.type != FCLTokenizer::TOKEN_WORD)
+		{
+		set_msg_text(ERR_INVALID_FILE_FORMAT, term.line, term.column);
+		return -1;
+		}
 
-			if (paren_pos > 0)	// NOTE: we only check > 0 rather than >= cuz if it's = 0 we have nothing
-				(rule_components[component_idx])[paren_pos] = '\0';
+	if (in_parens)
+		{
+		tokens.next(&token);
 
-			// calc the rule index...
+		if (!(token.type == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, ")")))
+			{
+			set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
+			return -1;
+			}
+		}
 
-			int rule_idx = 0;
+	// skip the weight, we don't support it
+	tokens.peek(&token);
 
-			for (i = 0; i < input_var_count; i++)
-				{
-				// find match between rule_component and set saved
-				num_sets = get_num_of_sets(i);
-				for (j = 0; j < num_sets; j++)
-					{
-					if (strcmp((sets[i][j]).c_str(), rule_components[i].c_str()) == 0)
-						{
-						rule_idx +=  get_rule_index(i, j);
-						break;
-						}
-					} // end loop through sets
-				} // end loop through input vars
-
-			// find the output idx (NOTE: we're using the 'i' counter above)
-			int out_set_idx = NO_RULE;
-			num_sets = get_num_of_sets(OUTPUT_IDX);
-			for (j = 0; j < num_sets; j++)
-				{
-				if (strcmp((sets[i][j]).c_str(), rule_components[i].c_str()) == 0)
-					{
-					out_set_idx = j;
-					break;
-					}
+	if (token.type == FCLTokenizer::TOKEN_WORD && FCLTokenizer::equals(token, "WITH"))
+		{
+		tokens.next(&token);	// "WITH"
+		tokens.next(&token);	// weight
+		tokens.peek(&token);
+		}
 
-				} // end loop through sets
+	// the semicolon ends the rule
+	if (token.type == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, ";"))
+		tokens.next(&token);
 
-			// set the rule index
-			add_rule(rule_idx,  out_set_idx);
-			} // end if found a rule
-	
-		file_contents >> tmp;
+	// find the output idx
+	int out_set_idx = NO_RULE;
 
-		}; // end while not end ruleblock
+	key->assign(term.text, term.length);
+	found = sets[input_var_count].find(*key);
 
-	// free the memory we allocated
+	if (found != sets[input_var_count].end())
+		out_set_idx = found->second;
+
+	// set the rule index
+	add_rule(rule_idx, out_set_idx);
 
-	for (i = 0; i <= input_var_count; i++) // include output var
-		{
-		delete[] sets[i];
-		}
-		
-	delete[] sets;
-	delete[] rule_components;
-	
 	return 0;
 
-} // end FuzzyModelBase::load_rules_from_file()
+} // end FuzzyModelBase::load_rule_from_fcl_file()
 
 
 //
 // Function:	load_defuzz_block_from_fcl_file()
 // 
-// Purpose:		Loads the defuzzification info from the FCL file and creates them.
+// Purpose:		Loads the defuzzification info from the FCL file. The tokenizer
+//				is just past "DEFUZZIFY" and is left just past "END_DEFUZZIFY".
 //
 // Arguments:
 //
-//		std::istream&	file_contnts	- file to read from
+//		FCLTokenizer&	tokens	-	FCL text we're reading
+//		int*			method	-	set to the DefuzzVarObj::DEFUZZ_TYPE asked for,
+//								-1 if none (or "CoG") so the caller uses the default
 //
 // Returns:
 //
@@ -2209,150 +3165,100 @@ int FuzzyModelBase::load_rules_from_fcl_file(std::istream& file_contents)
 // Date:	9/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
-//
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Added "CoGS"/"WA", and use weighted average rather than
+//								COG when all the output sets are singletons
+// Ming-Kai Jiau	2026/10/16	Read from the tokenizer and hand back the method rather
+//								than setting it, the sets may not be loaded yet
 //	
 
-int FuzzyModelBase::load_defuzz_block_from_fcl_file(std::istream& file_contents)
+int FuzzyModelBase::load_defuzz_block_from_fcl_file(FCLTokenizer& tokens, int* method)
 {
-	int method;				// defuzzification method
- 	file_contents.seekg(0);	// go to start of file
-
-  	std::string token;
-
-	// loop until we find the "DEFUZZIFY" keyword
-	do 
-		{
-		file_contents >> token;
-
-		if (file_contents.eof())
-			{
-			// didn't find a defuzzify block... set defaults
- 			set_defuzz_method(DefuzzVarObj::DEFUZZ_COG);
- 			return 0;
-			}
-
-		}while (strcmp(token.c_str(), "DEFUZZIFY") != 0);
+  	FCLTokenizer::_token token;	// token we're dealing with
 
 	// eat the next token which is the name of the ouptut variable
-	file_contents >> token;
+	tokens.next(&token);
 
 	// now search for 'METHOD'...
-	do 
+	while (tokens.next(&token) != FCLTokenizer::TOKEN_END)
 		{
-		file_contents >> token;
-
-		// if token is empty we reached EOF
-		if (file_contents.eof())
-			{
-			// didn't find the "METHOD" keyword... set defaults
- 			set_defuzz_method(DefuzzVarObj::DEFUZZ_COG);
-			return 0;
-			}
-
-		}while ( strcmp(token.c_str(), "METHOD:") != 0) ;
+		if (token.type != FCLTokenizer::TOKEN_WORD)
+			continue;
 
-	// now get the method...
+		if (FCLTokenizer::equals(token, "END_DEFUZZIFY"))
+			return 0;	// we're done
 
-	file_contents >> token;
+		if (!FCLTokenizer::equals(token, "METHOD"))
+			continue;
 
-	// strip off the semicolon (if it's there)
-	int semi_pos = token.find(";");
+		// now get the method, skipping the colon...
+		while (tokens.next(&token) == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, ":"))
+			; // nothing to do
 
-	if (semi_pos > 0)	// NOTE: we only check > 0 rather than >= cuz if it's = 0 we have nothing
-		token[semi_pos] = '\0';
+		// find the defuzz method
+		// defuzzification_method ::= 'METHOD' ':' 'CoG' | 'CoGS' | 'CoA' | 'LM' | 'RM' | 'MoM' ';'
+		// *** NOTE: 'MoM' (Mean of Maximum) is not part of the standard, we added it, as is 'WA'
+		// (Weighted Average) which is the same as 'CoGS' ***
+		// AND we only currently support "CoG", "CoGS"/"WA" and "MoM"
 
-	// find the defuzz method
-	// defuzzification_method ::= 'METHOD' ':' 'CoG' | 'CoGS' | 'CoA' | 'LM' | 'RM' | 'MoM' ';'
-	// *** NOTE: 'MoM' (Mean of Maximum) is not part of the standard, we added it ***
-	// AND we only currently support "CoG" and "MoM"
+		if (FCLTokenizer::equals(token, "MoM"))
+			*method = DefuzzVarObj::DEFUZZ_MOM;
+		else if (FCLTokenizer::equals_nocase(token, "CoGS") || FCLTokenizer::equals_nocase(token, "WA"))
+			*method = DefuzzVarObj::DEFUZZ_WA;
+		else
+			{
+			// "CoG" or default to Center of Gravity... for singletons
+			// that's the weighted average
+			*method = -1;
+			}
 
-	if (strcmp(token.c_str(), "CoG") == 0)
-		method = DefuzzVarObj::DEFUZZ_COG;
-	else if (strcmp(token.c_str(), "MoM") == 0)
-		method = DefuzzVarObj::DEFUZZ_MOM;
-	else
-		{
-		// default to Center of Gravity
-		method = DefuzzVarObj::DEFUZZ_COG;
-		}
-	 
-	set_defuzz_method(method);
+		} // end while not end of text
 
+	// didn't find the end of the block, use what we found
 	return 0;
 
 } // end FuzzyModelBase::load_defuzz_block_from_file()
 
 
 //
-// Function:	set_output_dom()
+// Function:	get_default_defuzz_method()
 // 
-// Purpose:		Set the output set dom according to the composition method
+// Purpose:		Gets the defuzzification method to use if the FCL file doesn't ask
+//				for one (or asks for "CoG"). That's Center of Gravity unless every
+//				output set is a singleton, then it's the weighted average which gives
+//				the same output without COG's look up tables (see WADefuzzVarObj).
 //
 // Arguments:
 //
-//		DOMType*	out_set_dom_arr -	Array that holds the DOM value for each
-//										set in the output variable
-//		int			set_idx			-	index of the set we're setting the DOM for
-//		DOMType		new_value		-	DOM value
+//		none
 //
 // Returns:
 //
-//		0 - success
-//		non-zero - failure
+//		int - DefuzzVarObj::DEFUZZ_TYPE enum value
 //
-// Author:	Michael Zarozinski
-// Date:	9/01
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
 // 
 // Modification History
 // Author	Date		Modification
 // ------	----		------------
 //
 //
-// 
- 
-int FuzzyModelBase::set_output_dom(DOMType* out_set_dom_arr, int set_idx, DOMType new_value)  
+int FuzzyModelBase::get_default_defuzz_method() const
 {
-	bool set_value = false;	// indicates if we need to set value
-	int composition_method = output_var->get_composition_method();
-
-	if (set_idx >= output_var->get_num_of_sets())
-		{
-		assert(set_idx < output_var->get_num_of_sets());
-		return -1;
-		}
+	if (!output_var || output_var->get_num_of_sets() == 0)
+		return DefuzzVarObj::DEFUZZ_COG;
 
-	// set the value dependent on the COMPOSITION method...
-	DOMType current_dom = out_set_dom_arr[set_idx];
-
-	// if dom passed in is 0 or current dom is 0 update.  This is needed so we can zero it out, besides if
-	// we're passing in a zero the set is NOT active so we WANT it to be zero
- 	if (current_dom == 0)
-		set_value = true;
-	else
+	for (int i = 0; i < output_var->get_num_of_sets(); i++)
 		{
-		if ((composition_method == FuzzyOutVariable::COMPOSITION_OPERATION_MIN) && ( new_value < current_dom) )
-			set_value = true;
-		else if ((composition_method == FuzzyOutVariable::COMPOSITION_OPERATION_MAX) && ( new_value > current_dom))
-			set_value = true;
+		if (output_var->get_set(i)->get_func_type() != MemberFuncBase::SINGLETON)
+			return DefuzzVarObj::DEFUZZ_COG;
 		}
 
-	if (set_value)
-		{
-		if (new_value != 255 && new_value > FuzzyVariableBase::get_dom_array_max_idx())
-			assert(0);
-
-		if (new_value < 0)
-			new_value = 0;
-
-		out_set_dom_arr[set_idx] = new_value; 
+	return DefuzzVarObj::DEFUZZ_WA;
 
-		} // end if we need to set the DOM
- 				
-	return 0;
-
-} // end FuzzyModelBase::set_output_dom()
+} // end FuzzyModelBase::get_default_defuzz_method()
 
 
 /////////////////////////////////////////////////////////////////////
@@ -2361,6 +3267,9 @@ int FuzzyModelBase::set_output_dom(DOMType* out_set_dom_arr, int set_idx, DOMTyp
  
 FFLL_INLINE int FuzzyModelBase::get_input_var_count(void) const
 {
+	if (precompiled)
+		return compiled_model->get_input_var_count();
+
 	return input_var_count;
 
 }  // end FuzzyModelBase::get_input_var_count()
@@ -2408,12 +3317,24 @@ int FuzzyModelBase::get_rule_index(int _var_idx, int _set_idx /* = -1 */) const
 int FuzzyModelBase::calc_num_of_rules() const 
 {
 	int num_of_rules = 1; // init to 1 so we don't mult by 0
+	int i;	// counter
 
-	for (int i = 0; i < input_var_count; i++)
+	// if one variable has no sets we can't have any rules.
+	for (i = 0; i < input_var_count; i++)
+		{
+		if (input_var_arr[i]->get_num_of_sets() == 0)
+			return 0;
+		}
+
+	for (i = 0; i < input_var_count; i++)
 		{
-		// multiply by 0 is ok, cuz if one variable has no
-		// sets we can't have any rules.
- 		num_of_rules *= input_var_arr[i]->get_num_of_sets();
+		int num_of_sets = input_var_arr[i]->get_num_of_sets();
+
+		// rule indexes are ints, return -1 if there are too many combinations
+		if (num_of_rules > INT_MAX / num_of_sets)
+			return -1;
+
+ 		num_of_rules *= num_of_sets;
 		} // end loop through sets
  
 	return num_of_rules;
@@ -2422,6 +3343,8 @@ int FuzzyModelBase::calc_num_of_rules() const
 
 FFLL_INLINE int FuzzyModelBase::get_num_of_sets(int var_idx) const
 {
+	if (precompiled)
+		return (var_idx == OUTPUT_IDX) ? compiled_model->get_out_set_count() : compiled_model->get_set_count(var_idx);
  
 	const FuzzyVariableBase* var =  get_var(var_idx);
  
@@ -2434,11 +3357,13 @@ FFLL_INLINE int FuzzyModelBase::get_num_of_sets(int var_idx) const
  
 void FuzzyModelBase::add_rule(int index, RuleArrayType output_set)
 {
+	uncompile();
 	rules->add_rule(index, output_set); 
 };
 
 void FuzzyModelBase::remove_rule(int index)
 {	
+	uncompile();
 	rules->remove_rule(index); 
 };
 
@@ -2473,6 +3398,7 @@ FFLL_INLINE bool FuzzyModelBase::no_rules() const
 
 FFLL_INLINE void FuzzyModelBase::clear_rules() 
 { 
+	uncompile();
 	rules->clear();
 };
 
@@ -2512,12 +3438,55 @@ FuzzyOutVariable* FuzzyModelBase::new_output_variable()
 
 ValuesArrCountType FuzzyModelBase::convert_value_to_idx(int var_idx, RealType value) const
 {
+	if (compiled_model && var_idx != OUTPUT_IDX)
+		return compiled_model->convert_value_to_idx(var_idx, value);
 
 	FuzzyVariableBase* var =  get_var(var_idx);
 	return var->convert_value_to_idx(value);
 
 }  
 
+RealType FuzzyModelBase::convert_value_to_pos(int var_idx, RealType value) const
+{
+	if (compiled_model && var_idx != OUTPUT_IDX)
+		return compiled_model->convert_value_to_pos(var_idx, value);
+
+	FuzzyVariableBase* var =  get_var(var_idx);
+	return var->convert_value_to_pos(value);
+}  
+
+void FuzzyModelBase::uncompile()
+{
+	delete compiled_model;
+	compiled_model = NULL;
+}  
+
+const CompiledModel* FuzzyModelBase::get_compiled_model() const
+{
+	return compiled_model;
+}  
+
+bool FuzzyModelBase::is_precompiled() const
+{
+	return precompiled;
+}  
+
+void FuzzyModelBase::unbake()
+{
+	delete baked_surface;
+	baked_surface = NULL;
+}  
+
+const BakedSurface* FuzzyModelBase::get_baked_surface() const
+{
+	return baked_surface;
+}  
+
+bool FuzzyModelBase::is_analytic() const
+{
+	return (analytic_engine != NULL);
+}  
+
 int FuzzyModelBase::get_defuzz_method() const
 {
 	if (output_var)
@@ -2541,6 +3510,8 @@ int FuzzyModelBase::set_composition_method(int method)
 	if (!output_var)
 		return -1;
 
+	uncompile();
+
 	return output_var->set_composition_method(method);
 
 } 
@@ -2550,6 +3521,9 @@ int FuzzyModelBase::set_defuzz_method(int method)
 {
 	if (!output_var)
 		return -1;
+
+	uncompile();
+
 	return output_var->set_defuzz_method(method);
 };
 
@@ -2567,6 +3541,7 @@ int FuzzyModelBase::set_inference_method(int method)
 		case INFERENCE_OPERATION_MIN:
 		case INFERENCE_OPERATION_MAX:
 
+			uncompile();
 			inference_method = method;
 			break;
 
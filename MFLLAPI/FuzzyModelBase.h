@@ -16,12 +16,22 @@
  
 #include "FFLLBase.h"  
 
+#include <unordered_map>
+
 
 
 class FuzzyVariableBase;
 class FuzzyOutVariable;
 class FuzzySetBase;
 class RuleArray;
+class InferenceScratch;
+class BakedSurface;
+class AnalyticEngine;
+class CompiledModel;
+class FCLTokenizer;
+
+// maps a name in an FCL file to the index of the variable or set it names
+typedef std::unordered_map<std::string, int> FCLNameMap;
  
 // Class:	FuzzyModelBase
 //
@@ -63,6 +73,7 @@ class  FuzzyModelBase : virtual public FFLLBase
 		// load fcl file/string functions
  	 	virtual int load_from_fcl_file(const char* file_name);
 		virtual int load_from_fcl_string(const char * fcl_str);
+		virtual int load_from_fcl_buffer(const char* data, size_t length);
 		int load(const char* file, short mode, bool from_loder = false);
 
 		// save model functions
@@ -87,8 +98,25 @@ class  FuzzyModelBase : virtual public FFLLBase
 		// misc functions
  		void calc_rule_components(int rule_index, int* set_idx_array) const; 
 		void calc_rule_index_wrapper(void);
-		RealType calc_output(short*  var_idx_arr, DOMType* out_set_dom_arr)  ;
+		RealType calc_output(short*  var_idx_arr, DOMType* out_set_dom_arr, InferenceScratch* scratch = NULL)  ;
+		RealType calc_output_incremental(short* var_idx_arr, int changed_var, DOMType* out_set_dom_arr, InferenceScratch* scratch);
+		int calc_output_batch(const RealType* inputs, int rows, int cols, short* var_idx_arr, DOMType* out_set_dom_arr, RealType* outputs, InferenceScratch* scratch = NULL);
+		RealType calc_output_analytic(const RealType* var_value_arr, InferenceScratch* scratch = NULL) const;
 		ValuesArrCountType convert_value_to_idx(int var_idx, RealType value) const; 
+		RealType convert_value_to_pos(int var_idx, RealType value) const;
+		int bake(bool interpolate = false);
+		void unbake();
+		const BakedSurface* get_baked_surface() const;
+		int set_analytic(bool analytic);
+		int set_x_array_count(int var_idx, int count);
+		bool is_analytic() const;
+		int compile();
+		void uncompile();
+		const CompiledModel* get_compiled_model() const;
+		int save_compiled(const char* file_name);
+		int load_compiled(const char* file_name);
+		int map_compiled(const char* file_name);
+		bool is_precompiled() const;
  		static void validate_fcl_identifier(std::ofstream& file_contents, std::string identifier);
 
 	protected:
@@ -96,15 +124,17 @@ class  FuzzyModelBase : virtual public FFLLBase
 		// get functions
 		FuzzyVariableBase* get_var(int idx) const;
 		FFLL_INLINE int get_total_var_count() const;
+		int get_default_defuzz_method() const;
 
 		// set functions
 		void set_model_name(const char* _name);
-		virtual int set_output_dom(DOMType* out_set_dom_arr, int set_idx, DOMType new_value) ;
 
 		// load file (fcl_contents) functions
- 		int load_vars_from_fcl_file(std::istream& file_contents, bool output = false);
-		int load_defuzz_block_from_fcl_file(std::istream& file_contents);
-		int load_rules_from_fcl_file(std::istream& file_contents);
+		int load_from_fcl_text(const char* text, size_t length);
+ 		int load_vars_from_fcl_file(FCLTokenizer& tokens, bool output = false);
+		int load_defuzz_block_from_fcl_file(FCLTokenizer& tokens, int* method);
+		int load_rules_from_fcl_file(FCLTokenizer& tokens);
+		int load_rule_from_fcl_file(FCLTokenizer& tokens, const FCLNameMap* sets, const FCLNameMap& var_names, std::string* key);
   
 		// save model functions
  		void save_rules_to_fcl_file(std::ofstream& file_contents) const;
@@ -116,7 +146,6 @@ class  FuzzyModelBase : virtual public FFLLBase
 		void add_input_var_to_list(FuzzyVariableBase* var );
 
 		// misc functions
-		void calc_active_output_level_wrapper(short* var_idx_arr, DOMType* out_set_dom_arr);
 		int calc_rule_index(int var_idx);
 
 	private:
@@ -129,8 +158,10 @@ class  FuzzyModelBase : virtual public FFLLBase
 		virtual RuleArray* new_rule_array();
 
  		// misc functions
-		void calc_active_output_level(int var_num, DOMType activation_level, int rule_index, short* var_idx_arr, DOMType* out_set_dom_arr )   ;
+		void bake_entries(BakedSurface* surface, int first_entry, int last_entry);
+		int init_analytic_engine(AnalyticEngine* engine) const;
 		int calc_num_of_rules() const;
+		int remap_rules(const int* old_count_arr, int var_idx, int deleted_set_idx);
 
 	////////////////////////////////////////
 	////////// Class Variables /////////////
@@ -157,6 +188,10 @@ class  FuzzyModelBase : virtual public FFLLBase
   		int				input_var_count;	// number of input variables that make up this rule
  		std::string		ascii_err_msg;		// string to enable conversion from wide chars to ascii chars	 
  		std::string		model_name;			// name of the flile we've opened
+		BakedSurface*	baked_surface;		// output for every combination of input indexes, NULL if the model isn't baked (see bake())
+		AnalyticEngine*	analytic_engine;	// calculates the output from the exact node values, NULL if not in analytic mode (see set_analytic())
+		CompiledModel*	compiled_model;		// read-only copy of the model the output is calculated from, NULL if the model changed since it was compiled (see compile())
+		bool			precompiled;		// true if the model was loaded with load_compiled(), it has no variables, sets or rules, only compiled_model
 
 }; // end class FuzzyModelBase
 
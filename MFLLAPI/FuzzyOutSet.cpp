@@ -13,6 +13,7 @@
 #include "FuzzyOutSet.h"
 #include "COGDefuzzSetObj.h"
 #include "MOMDefuzzSetObj.h"
+#include "WADefuzzSetObj.h"
 #include "FuzzyOutVariable.h"
  
 
@@ -103,8 +104,9 @@ FuzzyOutSet::~FuzzyOutSet()
 // Date:	8/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Added weighted average
 //
 //		
 int FuzzyOutSet::set_defuzz_method(int type)
@@ -134,6 +136,12 @@ int FuzzyOutSet::set_defuzz_method(int type)
 
 			break;
 
+		case DefuzzVarObj::DEFUZZ_WA:
+
+			defuzz_obj = new WADefuzzSetObj(this);
+
+			break;
+
 		default:
 			set_msg_text(ERR_INVALID_DEFUZZ_MTHD);
 			return -1;
@@ -215,8 +223,9 @@ void FuzzyOutSet::calc()
 // Date:	12/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Added weighted average
 //
 //		
 RealType FuzzyOutSet::get_defuzz_x(int dom /* = -1 */)
@@ -249,6 +258,14 @@ RealType FuzzyOutSet::get_defuzz_x(int dom /* = -1 */)
 
 		} // end if MoM
 
+	if (defuzz_type == DefuzzVarObj::DEFUZZ_WA)
+		{
+		WADefuzzSetObj* wa_defuzz = dynamic_cast<WADefuzzSetObj*>(defuzz_base);
+
+		return wa_defuzz->get_position();
+
+		} // end if weighted average
+
 	// should never get her, but just in case...
 	return FLT_MIN;  
 
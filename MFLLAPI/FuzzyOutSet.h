@@ -36,7 +36,7 @@ class  FuzzyOutSet : virtual public FuzzySetBase
 		virtual ~FuzzyOutSet();
  
 		// get functions
-		DefuzzSetObj* get_defuzz_obj() const;
+		virtual DefuzzSetObj* get_defuzz_obj() const;
 		RealType get_defuzz_x(int dom = -1);
  		FuzzyOutVariable* get_parent() const;
 
@@ -15,6 +15,7 @@
 #include "FuzzyOutVariable.h"
 #include "COGDefuzzVarObj.h"
 #include "MOMDefuzzVarObj.h"
+#include "WADefuzzVarObj.h"
 #include "FuzzyOutSet.h"
 
  
@@ -108,8 +109,9 @@ FuzzyOutVariable::~FuzzyOutVariable()
 // Date:	08/01
 // 
 // Modification History
-// Author		Date		Modification
-// ------		----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Added weighted average
 //
 //
 int FuzzyOutVariable::set_defuzz_method(int type)
@@ -141,6 +143,11 @@ int FuzzyOutVariable::set_defuzz_method(int type)
 			defuzz_obj = new MOMDefuzzVarObj(this);
 			break;
 
+		case DefuzzVarObj::DEFUZZ_WA:
+
+			defuzz_obj = new WADefuzzVarObj(this);
+			break;
+
 		default:
 			set_msg_text(ERR_INVALID_DEFUZZ_MTHD);
 			return -1;
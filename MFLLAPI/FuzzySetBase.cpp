@@ -123,7 +123,7 @@ int FuzzySetBase::init(const wchar_t* n, int mid_pt_x, short idx, int set_width,
 
 	// perform some sanity checks on the mid point and width
 
-	int var_width = FuzzyVariableBase::get_x_array_max_idx();
+	int var_width = get_parent()->get_x_array_max_idx();
 
 	if (set_width > var_width)
 		{
@@ -213,8 +213,9 @@ int FuzzySetBase::new_member_func(int type, int mid_x, int width)
 // Date:	6/00
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Put the values[] array in the variable's DOM table
 //
 //
 int FuzzySetBase::new_member_func(int type)
@@ -266,6 +267,14 @@ int FuzzySetBase::new_member_func(int type)
 	member_func->init();	// perform any initialization
 	calc();
 
+	// the member func has its own values[] array, if this set is in
+	// the variable move it to the variable's DOM table
+	if (get_parent() && get_parent()->pack_sets())
+		{
+		set_msg_text(ERR_ALLOC_MEM);
+		return -1;
+		}
+
 	return 0;
 
 } // end FuzzySetBase::new_member_func()
@@ -337,8 +346,9 @@ int FuzzySetBase::set_id(const wchar_t* _id, bool allow_dup /* = false*/)
 // Date:	5/00
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Copy the exact values of the nodes
 //
 //
 
@@ -371,6 +381,22 @@ int FuzzySetBase::copy(const FuzzySetBase& copy_from)
  		member_func->set_node (i, node.x,  node.y);
 		} // end loop through nodes
 
+	// copy the exact values of the nodes after they're all in place. If set_node()
+	// moved a node the exact value no longer applies, it's calculated from the node
+	for (int j = 0; j < copy_from.get_node_count(); j++)
+		{
+		NodePoint from_node = copy_from.member_func->get_node(j);
+		NodePoint node = member_func->get_node(j);
+
+		if (node.x != from_node.x || node.y != from_node.y)
+			continue;
+
+		RealType x, y;
+
+		copy_from.member_func->get_node_value(j, &x, &y);
+		member_func->set_node_value(j, x, y);
+		}
+
 	return 0;
 
 } // end  FuzzySetBase::copy()
@@ -455,6 +481,12 @@ bool FuzzySetBase::is_output() const
 {
 	return get_parent()->is_output();
 }
+
+DefuzzSetObj* FuzzySetBase::get_defuzz_obj() const
+{
+	// only output sets have a defuzzification object (see FuzzyOutSet)
+	return NULL;
+}
   
 RealType  FuzzySetBase::get_left_x() const
 {
@@ -464,6 +496,14 @@ RealType FuzzySetBase::get_idx_multiplier() const
 {
 	return get_parent()->get_idx_multiplier();
 };
+ValuesArrCountType FuzzySetBase::get_x_array_count() const
+{
+	return get_parent()->get_x_array_count();
+};
+ValuesArrCountType FuzzySetBase::get_x_array_max_idx() const
+{
+	return get_parent()->get_x_array_max_idx();
+};
 
 const char* FuzzySetBase::get_model_name() const
 {
@@ -494,6 +534,11 @@ DOMType FuzzySetBase::get_value(int idx) const
 {
 	return(member_func->get_value(idx));
 };
+void FuzzySetBase::set_values_table(PackedDOMType* table, int stride)
+{
+	if (member_func)
+		member_func->set_values_table(table, stride);
+};
 void FuzzySetBase::calc()
 {
 	if (member_func)
@@ -558,7 +603,7 @@ FuzzySetBase& FuzzySetBase::operator=(const FuzzySetBase& copy_from)
 RealType FuzzySetBase::convert_idx_to_value(int idx) const
 {
 	assert(idx >= 0);
-	assert(idx <= FuzzyVariableBase::get_x_array_count());
+	assert(idx <= get_parent()->get_x_array_count());
 
 	return get_parent()->convert_idx_to_value(idx);
 
@@ -577,10 +622,22 @@ void FuzzySetBase::shrink(int x_delta  )
 void FuzzySetBase::set_member_func(void* new_func)
 {
 	 delete member_func; member_func = static_cast<MemberFuncBase*>(new_func);
+
+	// the new member func has its own values[] array
+	if (get_parent())
+		get_parent()->pack_sets();
 }; 
 void FuzzySetBase::set_rule_index(int idx)
 {
 	rule_index = idx;
+
+	// the variable's active set lists hold the rule index
+	invalidate_active_sets();
+};
+void FuzzySetBase::invalidate_active_sets()
+{
+	if (get_parent())
+		get_parent()->invalidate_active_sets();
 };  
 int FuzzySetBase::get_rule_index() const 
 { 
@@ -600,3 +657,15 @@ void FuzzySetBase::set_node(int idx, int x, int y, bool validate /* = true */)
 { 
 	member_func->set_node(idx, x, y, validate);
 };
+void FuzzySetBase::set_node_value(int idx, RealType x, RealType y)
+{ 
+	member_func->set_node_value(idx, x, y);
+};
+void FuzzySetBase::get_node_value(int idx, RealType* x, RealType* y) const
+{ 
+	member_func->get_node_value(idx, x, y);
+};
+int FuzzySetBase::realloc_values()
+{ 
+	return member_func->realloc_values();
+};
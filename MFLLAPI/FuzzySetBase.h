@@ -17,6 +17,7 @@
 class MemberFuncBase;
 class FuzzyVariableBase;
 class FuzzyModelBase;
+class DefuzzSetObj;
 
 #include "FFLLBase.h"
 
@@ -49,6 +50,7 @@ class   FuzzySetBase : virtual  public FFLLBase
 		const char* get_model_name() const;
 		const wchar_t* get_id(void) const;
 		NodePoint get_node(int idx);
+		void get_node_value(int idx, RealType* x, RealType* y) const;
 		int get_node_count() const ;
 		int get_var_index() const;
 		int get_end_x(void) const;
@@ -58,17 +60,21 @@ class   FuzzySetBase : virtual  public FFLLBase
 		int get_node_x(int node_idx) const;
 		int get_rule_index() const;
 		RealType get_idx_multiplier() const;
+		ValuesArrCountType get_x_array_count() const;
+		ValuesArrCountType get_x_array_max_idx() const;
 		RealType  get_left_x() const; 
 		void set_index(int _idx);
 		DOMType get_value(int idx) const;
 		DOMType get_index() const;
 		virtual DOMType get_dom(int idx) const;
+		virtual DefuzzSetObj* get_defuzz_obj() const;
 
 		// Set Functions
  
 		int set_id(const wchar_t* _id, bool allow_dup = false);
 		void set_ramp(int hi_lo_ind, int left_right_ind);
 		void set_node(int idx, int x, int y, bool validate = false);
+		void set_node_value(int idx, RealType x, RealType y);
 		void set_member_func(void* new_func);
 		void set_rule_index(int idx);
 
@@ -84,6 +90,9 @@ class   FuzzySetBase : virtual  public FFLLBase
  		virtual void calc();
  		virtual void expand(int x_delta);
 		virtual void shrink(int x_delta);
+		void invalidate_active_sets();
+		int realloc_values();
+		void set_values_table(PackedDOMType* table, int stride);
    
 		// save/load functions
  
@@ -13,8 +13,10 @@
 #include "FuzzySetBase.h"
 #include "FuzzyModelBase.h"
 #include "MemberFuncBase.h"
+#include "FCLTokenizer.h"
 
 #include <fstream>
+#include <vector>
 #include <limits.h>
 
 #ifdef _DEBUG
@@ -40,8 +42,7 @@ static char THIS_FILE[] = __FILE__;
 // if each "step" was 1. So we need to add 1 element to the array to get the results we want.
 
 
-ValuesArrCountType FuzzyVariableBase::x_array_count = 201;
-ValuesArrCountType FuzzyVariableBase::x_array_max_idx = FuzzyVariableBase::x_array_count - 1;
+ValuesArrCountType FuzzyVariableBase::default_x_array_count = 201;
 DOMType FuzzyVariableBase::dom_array_count = 101;
 DOMType FuzzyVariableBase::dom_array_max_idx = FuzzyVariableBase::dom_array_count - 1;
  
@@ -75,10 +76,14 @@ FuzzyVariableBase::FuzzyVariableBase(FuzzyModelBase* _parent) :  FFLLBase(_paren
  	index = -1;
 
 	sets = NULL; 
+	dom_table = NULL;
  
+	x_array_count = default_x_array_count;
+	x_array_max_idx = x_array_count - 1;
+
 	// set left/right shoulder
 	left_x = 0;
-	right_x = FuzzyVariableBase::x_array_max_idx;
+	right_x = x_array_max_idx;
 
 	set_id(L""); // init identifier
  
@@ -103,8 +108,10 @@ FuzzyVariableBase::FuzzyVariableBase(FuzzyModelBase* _parent) :  FFLLBase(_paren
 // Date:	6/10/99
 // 
 // Modification History
-// Author		Date		Modification
-// ------		----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Free the active set lists and the DOM table
+// Ming-Kai Jiau	2026/10/16	The active set lists moved to CompiledModel
 //
 //
 FuzzyVariableBase::~FuzzyVariableBase()
@@ -112,6 +119,8 @@ FuzzyVariableBase::~FuzzyVariableBase()
  
 	delete_all_sets();
 
+	delete[] dom_table;
+
 } // end FuzzyVariableBase::~FuzzyVariableBase()
 
 
@@ -323,7 +332,7 @@ int FuzzyVariableBase::set_right_x(RealType value)
 // 
 void FuzzyVariableBase::calc_idx_multiplier()
 { 
- 	idx_multiplier =(right_x - left_x) /((RealType)( FuzzyVariableBase::x_array_max_idx));
+ 	idx_multiplier =(right_x - left_x) /((RealType)( x_array_max_idx));
 	
 }; // end FuzzyVariableBase::calc_idx_multiplier()
  
@@ -348,8 +357,10 @@ void FuzzyVariableBase::calc_idx_multiplier()
 // Date:	8/99
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Invalidate the active set lists
+// Ming-Kai Jiau	2026/10/16	Re-pack the DOM table
 //
 //
 int FuzzyVariableBase::delete_set(int _set_idx)
@@ -395,8 +406,9 @@ int FuzzyVariableBase::delete_set(int _set_idx)
 
 	// assign the new array of sets to the sets[] member variable
  	sets = tmp_sets;
-	
-	return 0; 
+
+	// remove the set's column from the DOM table
+	return pack_sets(); 
 
 } // end FuzzyVariableBase::delete_set()
 
@@ -418,8 +430,10 @@ int FuzzyVariableBase::delete_set(int _set_idx)
 // Date:	6/10/99
 // 
 // Modification History
-// Author		Date		Modification
-// ------		----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Invalidate the active set lists
+// Ming-Kai Jiau	2026/10/16	Free the DOM table
 //
 //
  
@@ -442,6 +456,8 @@ void FuzzyVariableBase::delete_all_sets()
 	delete[] sets;
  	sets = NULL;
 
+	pack_sets();	// with no sets this just frees the table
+
 } // end FuzzyVariableBase::delete_all_sets()
  
 
@@ -571,8 +587,10 @@ int FuzzyVariableBase::set_id(const wchar_t* _id, int set_idx /* = -1 */)
 // Date:	5/00
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Invalidate the active set lists
+// Ming-Kai Jiau	2026/10/16	Re-pack the DOM table
 //
 //
 int FuzzyVariableBase::add_set(const FuzzySetBase* _new_set)
@@ -628,34 +646,78 @@ int FuzzyVariableBase::add_set(const FuzzySetBase* _new_set)
  
 	// copy new mem to old
 	sets = tmp_sets;
-  
-	return 0;
+
+	// add the set's column to the DOM table
+	return pack_sets();
 
 } // end FuzzyVariableBase::add_set()
  
  
 //
-// Function:	set_x_array_count()
+// Function:	set_default_x_array_count()
 // 
-// Purpose:		Set the value for x_array_count. This also sets the
-//				x_array_max_idx value appropriately. Note: this is a static
-//				function so it can't call non-static member funcs which
-//				means the caller needs to make sure the idx_multiplier
-//				variables are re-calculated.
+// Purpose:		Set the x_array_count that new variables are created with.
+//				Variables that already exist keep their count, use 
+//				set_x_array_count() to change those.
 //
 // Arguments:
 //
-//		int _count - value to set x_array_count to.
+//		int _count - value to set default_x_array_count to.
 //
 // Returns:
 //
 //		0 - success
-//		-1 - invalid value passed in, set x_array_count to max allowed by datatype
+//		-1 - invalid value passed in, set default_x_array_count to max allowed
 //
 // Author:	Michael Zarozinski
 // Date:	5/01
 // 
 // Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Renamed from set_x_array_count(), each variable has its own count now
+//
+//
+
+int FuzzyVariableBase::set_default_x_array_count(int _count)
+{
+	// if they're trying to set over max, set to max and return -1
+	if (_count > MAX_X_ARRAY_COUNT)
+		{
+		default_x_array_count = MAX_X_ARRAY_COUNT;
+		return -1;
+		}
+
+	if (_count < 2)
+		return -1;
+	
+	default_x_array_count = _count;
+ 
+	return 0;
+
+}; // end FuzzyVariableBase::set_default_x_array_count()
+
+//
+// Function:	set_x_array_count()
+// 
+// Purpose:		Set the number of elements in the values[] array of the sets
+//				in this variable (the resolution the variable is quantized to). This 
+//				also sets x_array_max_idx and the idx_multiplier. Any sets the variable
+//				already has are re-calculated, their nodes keep their exact values.
+//
+// Arguments:
+//
+//		int _count - value to set x_array_count to (2 to MAX_X_ARRAY_COUNT)
+//
+// Returns:
+//
+//		0 - success
+//		-1 - invalid value passed in, nothing is changed
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
 // Author	Date		Modification
 // ------	----		------------
 //
@@ -663,18 +725,60 @@ int FuzzyVariableBase::add_set(const FuzzySetBase* _new_set)
 
 int FuzzyVariableBase::set_x_array_count(int _count)
 {
-	// if they're trying to set over max, set to max and return -1
-	if (_count > USHRT_MAX)
+	if (_count < 2 || _count > MAX_X_ARRAY_COUNT)
 		{
-		x_array_count = USHRT_MAX;
-		x_array_max_idx = x_array_count - 1;
+		set_msg_text(ERR_INVALID_RESOLUTION);
 		return -1;
 		}
-	
+
+	if (_count == x_array_count)
+		return 0;
+
+	int i, j;	// counters
+
+	// get the exact values of the nodes BEFORE we change the count, they're
+	// converted to indexes using the old idx_multiplier
+	std::vector<RealType> node_x_arr, node_y_arr;
+
+	for (i = 0; i < num_of_sets; i++)
+		{
+		for (j = 0; j < sets[i]->get_node_count(); j++)
+			{
+			RealType x, y;
+
+			sets[i]->get_node_value(j, &x, &y);
+			node_x_arr.push_back(x);
+			node_y_arr.push_back(y);
+			}
+		}
+
 	x_array_count = _count;
 	x_array_max_idx = x_array_count - 1;
- 
-	return 0;
+
+	calc_idx_multiplier();
+
+	// move the nodes to the new indexes and re-calculate the sets
+	int node = 0;	// index into node_x_arr/node_y_arr
+
+	for (i = 0; i < num_of_sets; i++)
+		{
+		if (sets[i]->realloc_values())
+			{
+			set_msg_text(ERR_ALLOC_MEM);
+			return -1;
+			}
+
+		for (j = 0; j < sets[i]->get_node_count(); j++, node++)
+			{
+			sets[i]->set_node(j, convert_value_to_idx(node_x_arr[node]), sets[i]->get_node(j).y, false);
+			sets[i]->set_node_value(j, node_x_arr[node], node_y_arr[node]);
+			}
+
+		sets[i]->calc();
+		}
+
+	// the sets have their own arrays now, put them back in the DOM table
+	return pack_sets();
 
 }; // end FuzzyVariableBase::set_x_array_count()
 
@@ -709,7 +813,7 @@ int FuzzyVariableBase::set_dom_array_count(int _count)
 	if (_count > UCHAR_MAX)
 		{
 		dom_array_count = UCHAR_MAX;
-		dom_array_max_idx = x_array_count - 1;
+		dom_array_max_idx = dom_array_count - 1;
 		return -1;
 		}
 	
@@ -735,7 +839,8 @@ int FuzzyVariableBase::set_dom_array_count(int _count)
 //
 //				NOTE: we augment the standard by writing out the variable's range in a comment
 //				after the semi-colon. Without this we won't know the left/right values for the
-//				varaible when a FCL file is read in.
+//				varaible when a FCL file is read in. If the variable's x_array_count is not the
+//				default it's written in the same comment as RESOLUTION(count).
 //
 // Arguments:
 //
@@ -749,8 +854,9 @@ int FuzzyVariableBase::set_dom_array_count(int _count)
 // Date:	9/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Write the RESOLUTION if it's not the default
 //
 //
 void FuzzyVariableBase::save_var_to_fcl_file(std::ofstream& file_contents)
@@ -769,7 +875,13 @@ void FuzzyVariableBase::save_var_to_fcl_file(std::ofstream& file_contents)
 	// NOTE: the IEC 61131-7 does not specify a way to set the range of a varaible, so 
 	// we write them out in a range comment
 
-	file_contents << "\t" << aid <<  "\tREAL; (* RANGE(" << get_left_x() << " .. " << get_right_x() << ") *) ";
+	file_contents << "\t" << aid <<  "\tREAL; (* RANGE(" << get_left_x() << " .. " << get_right_x() << ")";
+
+	// only write the resolution if it's not the default so files stay readable by FFLL
+	if (get_x_array_count() != get_default_x_array_count())
+		file_contents << " RESOLUTION(" << get_x_array_count() << ")";
+
+	file_contents << " *) ";
 
 	delete[] aid;
 
@@ -843,13 +955,13 @@ void FuzzyVariableBase::save_sets_to_fcl_file(std::ofstream& file_contents)
 //
 // Function:	load_sets_from_fcl_file()
 // 
-// Purpose:		Read in an FCL file and create the sets that are associated
-//				with this variable. 
-//				NOTE: This is a brain-dead parser, it can be made much more robust.
+// Purpose:		Read the sets that are associated with this variable from the
+//				FUZZIFY block of an FCL file and create them. The tokenizer is just 
+//				past "FUZZIFY <var name>" and is left just past "END_FUZZIFY".
 //
 // Arguments:
 //
-//		std::istream& file_contents - FCL file in stream form
+//		FCLTokenizer& tokens - FCL text we're reading
 //
 // Returns:
 //
@@ -860,51 +972,21 @@ void FuzzyVariableBase::save_sets_to_fcl_file(std::ofstream& file_contents)
 // Date:	9/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Keep the exact values of the nodes
+// Ming-Kai Jiau	2026/10/16	Read from the tokenizer where the model's parser found the
+//								block rather than searching the file for it, and report
+//								where errors are
+// Ming-Kai Jiau	2026/10/16	Widen the set name straight from the text
 //
 // 
-int FuzzyVariableBase::load_sets_from_fcl_file(std::istream& file_contents)
+int FuzzyVariableBase::load_sets_from_fcl_file(FCLTokenizer& tokens)
 {
-  	file_contents.seekg(0);	// go to start of file
- 
-	// get the ascii version of this variable's id...
-	char* aid = convert_to_ascii(get_id());
- 
-	// search for keyword FUZZIFY followed by id of this var...
-	std::string stoken, var_name;
-	bool found = false;
-
-	while (!found)
-		{
-
-		// read until we get to the start of the variable declaration
-		do
-			{
-			file_contents >> stoken;
+	FCLTokenizer::_token token;			// token we're dealing with
+	FCLTokenizer::_token term_token;	// the "TERM" token (for errors)
 
-			// check for EOF
-			if (file_contents.eof())
-				{
-				set_msg_text(ERR_EOF_READING_SETS);
-				delete[] aid;
- 				return -1; 
-				}
-
-			} while (strcmp(stoken.c_str(), "FUZZIFY") != 0 );
-		
-		// if we got here we have a FUZZIFY block... check if it's the right var...
-		file_contents >> var_name;
-
-	 	if (strcmp(var_name.c_str(), aid) == 0)
- 			found = true;
- 
-		}; // end while !found
-
-	delete[] aid;
-
-	// we found "FUZZIFY <var name>", now loop until we find "END_FUZZIFY" reading
-	// the sets which are in the format:
+	// read until we find "END_FUZZIFY" reading the sets which are in the format:
 	// 
 	//			TERM term_name:= membership_function;
 	//
@@ -912,116 +994,96 @@ int FuzzyVariableBase::load_sets_from_fcl_file(std::istream& file_contents)
 	// and point is either a single value (if singleton) or a list of x/y values (x, y)
 	// and the values MAY have a decimal point.
 
-	// read line-by-line to get the sets...
-
-	char line[300];
  	RealType x_point[7], y_point[7];	// x/y points for the set - NOTE: we assume a max of 7 points
 
-	char* set_name;
-	char* token;
-			
-	// inlude ":=" in tokens so we skip the assignment operator
-	char seps[]   = " ,()\t\n:=";
- 
-	while(1)
+	while (1)
 		{
-		// read in the next line
-		file_contents.getline(line, 300);
-
-		// check for EOF
-		if (file_contents.eof())
+		if (tokens.next(&term_token) == FCLTokenizer::TOKEN_END)
 			{
-			set_msg_text(ERR_EOF_READING_SETS);
+			set_msg_text(ERR_EOF_READING_SETS, term_token.line, term_token.column);
  			return -1; 
 			}
 
-		token = strtok(line, seps);
-
-		// if token is null... blank line
-		if (token == NULL)
-			continue;
-
-		if (strcmp(token, "END_FUZZIFY") == 0)
+		if (term_token.type == FCLTokenizer::TOKEN_WORD && FCLTokenizer::equals(term_token, "END_FUZZIFY"))
 			break;	// we're done
 
 		// validate this is the "term" keyword
-		if (stricmp(token, "term") != 0)
+		if (term_token.type != FCLTokenizer::TOKEN_WORD || !FCLTokenizer::equals_nocase(term_token, "term"))
 			{
-			set_msg_text(ERR_INVALID_FILE_FORMAT); // could be a bit more "robuts" in our error reporting!
+			set_msg_text(ERR_INVALID_FILE_FORMAT, term_token.line, term_token.column);
 			return -1;
 			}
 		
 		// get the set name
-		set_name = strtok(NULL, seps);
-
-		token = strtok(NULL, seps);
- 
-		if (token == NULL)
+		if (tokens.next(&token) != FCLTokenizer::TOKEN_WORD)
 			{
-			// ERROR - invalid format
-			set_msg_text(ERR_INVALID_FILE_FORMAT); // could be a bit more "robuts" in our error reporting!
+			set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
 			return -1;
 			}
 
-		int num_of_points = 0;
+		std::wstring set_name = FCLTokenizer::to_wstring(token);
 
-		// handle special case of singletons.  They'll be of the form "<value>;"
-		// read points until we reach the semicolon
+		// skip the assignment operator (":=", or ": =")
+		while (tokens.next(&token) == FCLTokenizer::TOKEN_SYMBOL && (FCLTokenizer::equals(token, ":=") || FCLTokenizer::equals(token, ":") || FCLTokenizer::equals(token, "=")))
+			; // nothing to do
 
-		if (token[strlen(token) - 1] == ';')
-			{
-
-			// replace semi with null so we can convert
-			token[strlen(token) - 1] = '\0';
-			x_point[num_of_points] = atof(token);
-			// set 'y' value to max
- 			y_point[num_of_points]  = FuzzyVariableBase::get_dom_array_max_idx();
+		int num_of_points = 0;
 
-			num_of_points = 1;
-			}
-		else
+		// the points are either a singleton of the form "<value> ;" or of the form 
+		// "(<value> , <value>) ..." - read points until we reach the semicolon
+		while (!(token.type == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, ";")))
 			{
-			// not a singleton, points are of the form "(<value> , <value>)"
+			bool in_parens = (token.type == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, "("));
+
+			if (in_parens)
+				tokens.next(&token);
 
-			while (token[0] != ';')  
+			if (num_of_points >= 7 || FCLTokenizer::to_real(token, &x_point[num_of_points]))
 				{
+				// ERROR - invalid format
+				set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
+				return -1;
+				}
 
-				x_point[num_of_points] = atof(token);
+			y_point[num_of_points] = 0;	// singletons don't have a 'y' value
 
-				token = strtok(NULL, seps);
- 
-				if (token[0] == ';') 
+			tokens.next(&token);
+
+			if (in_parens)
+				{
+				// "(<value> , <value>)", or "(<value>)" for a singleton
+				if (token.type == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, ","))
 					{
-					if (num_of_points != 0)
+					tokens.next(&token);
+
+					if (FCLTokenizer::to_real(token, &y_point[num_of_points]))
 						{
-						// ERROR - invalid format
-						set_msg_text(ERR_INVALID_FILE_FORMAT); // could be a bit more "robuts" in our error reporting!
+						set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
 						return -1;
 						}
 
-					// else singleton which is OK
-
- 					y_point[num_of_points]  = 0; 
-					num_of_points++;
-					continue;
-					} // end if ';' found
-
- 				y_point[num_of_points]  = atof(token);
-
-				num_of_points++;
-
-				token = strtok(NULL, seps);
+					tokens.next(&token);
+					}
 
-				if (token == NULL)
+				if (!(token.type == FCLTokenizer::TOKEN_SYMBOL && FCLTokenizer::equals(token, ")")))
 					{
-					// ERROR - invalid format
-					set_msg_text(ERR_INVALID_FILE_FORMAT); // could be a bit more "robuts" in our error reporting!
+					set_msg_text(ERR_INVALID_FILE_FORMAT, token.line, token.column);
 					return -1;
 					}
 
-				} // end while still reading values
+				tokens.next(&token);
+
+				} // end if point in parens
+
+			num_of_points++;
+
+			if (token.type == FCLTokenizer::TOKEN_END)
+				{
+				set_msg_text(ERR_EOF_READING_SETS, token.line, token.column);
+				return -1;
+				}
 
-			} // end if not singleton
+			} // end while still reading values
 
 		// set the membership func dependent on the number of datapoints....
 		int type;	// type of new member func
@@ -1040,6 +1102,7 @@ int FuzzyVariableBase::load_sets_from_fcl_file(std::istream& file_contents)
 				type = MemberFuncBase::S_CURVE;
 				break;
 			default:
+				set_msg_text(ERR_INVALID_FILE_FORMAT, term_token.line, term_token.column);
 				return -1; // error
 
 			} // end switch on num_of_points
@@ -1047,11 +1110,7 @@ int FuzzyVariableBase::load_sets_from_fcl_file(std::istream& file_contents)
 		// create the set, note we put fake values for width and stuff cuz that'll get
 		// set when we set the points
 
-		wchar_t* wset_name = convert_to_wide_char(set_name);
-
-	 	FuzzySetBase* set = new_set(wset_name, 0, this, num_of_sets, 0, type);
-
-		delete[] wset_name;
+	 	FuzzySetBase* set = new_set(set_name.c_str(), 0, this, num_of_sets, 0, type);
 
 		if (set == NULL)
 			return -1; // error is in msg_text
@@ -1069,6 +1128,10 @@ int FuzzyVariableBase::load_sets_from_fcl_file(std::istream& file_contents)
 
 			} // end loop through points
 
+		// keep the exact values too, singletons are always at the max 'y'
+		for (int j = 0; j < num_of_points; j++)
+			set->set_node_value(j, x_point[j], (num_of_points == 1) ? 1.0 : y_point[j]);
+
 		// need to call ModelBase version to set up the the rule array
 		(get_parent())->add_set(index, set);
 		
@@ -1118,6 +1181,81 @@ void FuzzyVariableBase::calc(int set_idx /* = -1 */)
 		}
  
 } // end FuzzyVariableBase::calc(void)
+
+
+//
+// Function:	pack_sets()
+// 
+// Purpose:		Build the DOM table from the values[] arrays of the sets and
+//				move each set's values[] array into its column of the table.
+//				The table is x-major so the DOMs of all the sets for an index
+//				are next to each other (usually in one cache line) and each DOM
+//				is 8 bits rather than a DOMType. This must be called whenever a
+//				set is added/removed or gets a new member func.
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int FuzzyVariableBase::pack_sets()
+{
+	PackedDOMType* table = NULL;	// new DOM table
+
+	if (num_of_sets)
+		{
+		int size = get_x_array_count() * num_of_sets;
+
+		table = new PackedDOMType[size + DOM_TABLE_PADDING];
+
+		if (table == NULL)
+			{
+			set_msg_text(ERR_ALLOC_MEM);
+			return -1;
+			}
+
+		memset(table, 0, (size + DOM_TABLE_PADDING) * sizeof(PackedDOMType));
+
+		// the sets copy their values from wherever they are now (their own
+		// array or the old table) so the old table can't be freed until they're done
+		for (int i = 0; i < num_of_sets; i++)
+			sets[i]->set_values_table(table + i, num_of_sets);
+
+		} // end if we have sets
+
+	delete[] dom_table;
+	dom_table = table;
+
+	invalidate_active_sets();
+
+	return 0;
+
+} // end FuzzyVariableBase::pack_sets()
+
+void FuzzyVariableBase::invalidate_active_sets()
+{
+	// the model's compiled copy holds the active sets
+	if (get_parent())
+		get_parent()->uncompile();
+};
+
+const PackedDOMType* FuzzyVariableBase::get_dom_table() const
+{
+	return dom_table;
+};
+
  
 
 
@@ -1198,6 +1336,45 @@ ValuesArrCountType FuzzyVariableBase::convert_value_to_idx(RealType value) const
 };
 
 
+//
+// Function: convert_value_to_pos()
+// 
+// Purpose:	This function converts the 'x' value passed in to
+//			a position in the values[] array. This is the same as
+//			convert_value_to_idx() without rounding to an index, it's used
+//			to interpolate between the indexes either side of the value.
+// 
+// Arguments:
+//
+//		RealType - x value to convert
+//
+// Returns:
+//
+//		RealType - position for the value (0 to x_array_max_idx)
+// 
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+
+RealType FuzzyVariableBase::convert_value_to_pos(RealType value) const
+{
+	RealType pos = (value -  get_left_x()) / get_idx_multiplier();
+
+	// make sure position is within range
+	if (pos < 0)
+		pos = 0;
+	if (pos > FuzzyVariableBase::get_x_array_max_idx())
+		pos = FuzzyVariableBase::get_x_array_max_idx();
+
+	return pos;
+};
+
+
 //
 // Function: init()
 // 
@@ -1447,11 +1624,15 @@ RealType FuzzyVariableBase::get_right_x() const
 	return right_x;
 } 
 
-ValuesArrCountType FuzzyVariableBase::get_x_array_count() 
+ValuesArrCountType FuzzyVariableBase::get_default_x_array_count() 
+{	
+	return default_x_array_count;
+};
+ValuesArrCountType FuzzyVariableBase::get_x_array_count() const
 {	
 	return x_array_count;
 };
-ValuesArrCountType FuzzyVariableBase::get_x_array_max_idx()
+ValuesArrCountType FuzzyVariableBase::get_x_array_max_idx() const
 {	
 	return x_array_max_idx;
 };
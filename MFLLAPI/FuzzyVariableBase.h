@@ -18,6 +18,7 @@
 class FuzzySetBase;
 class FuzzyModelBase;
 class FuzzyModelIPC;
+class FCLTokenizer;
  
 
 // 
@@ -43,8 +44,9 @@ class  FuzzyVariableBase :  virtual public FFLLBase
 		virtual int init(const wchar_t* _id, bool create_unique_id = true);
 
 		// set functions
-		static int set_x_array_count(int _count);
+		static int set_default_x_array_count(int _count);
 		static int set_dom_array_count(int _count);
+		int set_x_array_count(int _count);
 		void set_rule_index(int _rule_index, int set_idx = -1);
 		virtual int set_left_x(RealType value);
 		virtual int set_right_x(RealType value);
@@ -54,8 +56,9 @@ class  FuzzyVariableBase :  virtual public FFLLBase
 		FFLL_INLINE void set_index(int idx);
   		
 		// get functions
-		static ValuesArrCountType get_x_array_count();
-		static ValuesArrCountType get_x_array_max_idx();
+		static ValuesArrCountType get_default_x_array_count();
+		ValuesArrCountType get_x_array_count() const;
+		ValuesArrCountType get_x_array_max_idx() const;
 		static DOMType get_dom_array_count();
 		static DOMType get_dom_array_max_idx();
  		RealType get_left_x() const ;
@@ -79,11 +82,12 @@ class  FuzzyVariableBase :  virtual public FFLLBase
 		// save/load functions
 		void save_var_to_fcl_file(std::ofstream& file_contents);
 		void save_sets_to_fcl_file(std::ofstream& file_contents);
-		int load_sets_from_fcl_file(std::istream& file_contents);
+		int load_sets_from_fcl_file(FCLTokenizer& tokens);
 
 		// misc functions
 		virtual RealType convert_idx_to_value(int idx) const;
 		ValuesArrCountType convert_value_to_idx(RealType value) const;
+		RealType convert_value_to_pos(RealType value) const;
 		void calc_idx_multiplier(); // NOTE: there is not 'set' for the multiplier - it's always calculated
  		virtual bool is_output(void) const;
   		bool is_set_id_unique(const wchar_t* set_id, int set_idx) const;
@@ -93,6 +97,9 @@ class  FuzzyVariableBase :  virtual public FFLLBase
 		void calc(int set_idx = -1);
  		virtual int delete_set(int _set_idx);
  		virtual int add_set(const FuzzySetBase* _new_set);
+		void invalidate_active_sets();
+		int pack_sets();
+		const PackedDOMType* get_dom_table() const;
  
 	protected:
 
@@ -100,8 +107,7 @@ class  FuzzyVariableBase :  virtual public FFLLBase
   
 	private:
 
- 		static ValuesArrCountType x_array_count;	// how many elements are in the values[] array for the terms
- 		static ValuesArrCountType x_array_max_idx;  // max index for values[] array (seperate var so we don't have to remember to subtract one each time we want that value)
+ 		static ValuesArrCountType default_x_array_count;	// x_array_count for new variables (see set_default_x_array_count())
 		static DOMType dom_array_count;			// how many 'gradations' are in the 'y' direction for the degree						// of membership.  NOTE:  This can NOT be larger than a the largest
 												// of membership.  NOTE:  This can NOT be larger than a the largest
 												// value that can be stored in a datatype of type DOMType!!!
@@ -109,6 +115,8 @@ class  FuzzyVariableBase :  virtual public FFLLBase
  		FuzzySetBase**	sets;					// Array of the sets (dynamically allocated).  There are "num_of_sets" minus one elements in the array
 												// This is a simple array rather than incurring the overhead of a list or some other STL container
 		int				num_of_sets;			// How many sets in this variable
+ 		ValuesArrCountType x_array_count;		// how many elements are in the values[] array for the terms of this variable
+ 		ValuesArrCountType x_array_max_idx;		// max index for values[] array (seperate var so we don't have to remember to subtract one each time we want that value)
 		short			index;					// index for this variable in the model
  
 		std::wstring	id ;					// idendifier for the set wich is unique for the variable its part of.  
@@ -120,6 +128,9 @@ class  FuzzyVariableBase :  virtual public FFLLBase
 		int				rule_index;				// this is the starting offset into memory for this variable.
 												// It's used to speed access to the rules.
 												// *** For an in-depth explaination, see the rule_index var in FuzzySetBase ***
+		PackedDOMType*	dom_table;				// the values[] arrays of all the sets packed together x-major, the DOM of set 'i' at
+												// index 'x' is dom_table[x * num_of_sets + i] so fuzzifying an input reads one row.
+												// There are DOM_TABLE_PADDING extra elements at the end (see pack_sets())
 
 }; // end class FuzzyVariableBase  
 
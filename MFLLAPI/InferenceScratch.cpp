@@ -0,0 +1,145 @@
+//
+// File:	InferenceScratch.cpp
+//
+// Purpose:	Implementation of the InferenceScratch class. This class holds the
+//			working memory the inference kernel uses to calculate the output
+//			of a model.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#include "InferenceScratch.h"
+
+#ifdef _DEBUG
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+
+#include "debug.h"
+
+#endif
+
+//
+// Function:	InferenceScratch()
+//
+// Purpose:		Constructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+InferenceScratch::InferenceScratch()
+{
+	var_active_arr = NULL;
+	active_count_arr = NULL;
+	position_arr = NULL;
+	activation_arr = NULL;
+	rule_index_arr = NULL;
+
+	var_capacity = 0;
+
+	active_valid = false;
+	partial_var = -1;
+
+}; // end InferenceScratch::InferenceScratch()
+
+//
+// Function:	~InferenceScratch()
+//
+// Purpose:		Destructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+InferenceScratch::~InferenceScratch()
+{
+	delete[] var_active_arr;
+	delete[] active_count_arr;
+	delete[] position_arr;
+	delete[] activation_arr;
+	delete[] rule_index_arr;
+
+}; // end InferenceScratch::~InferenceScratch()
+
+//
+// Function:	alloc()
+//
+// Purpose:		Make sure the arrays are large enough for a model with the number
+//				of input variables passed in. The arrays are only re-allocated
+//				if they're too small.
+//
+// Arguments:
+//
+//		int var_count - number of input variables in the model
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int InferenceScratch::alloc(int var_count)
+{
+	if (var_count > var_capacity)
+		{
+		delete[] var_active_arr;
+		delete[] active_count_arr;
+		delete[] position_arr;
+		delete[] activation_arr;
+		delete[] rule_index_arr;
+
+		var_active_arr = new const CompiledModel::_active_set*[var_count];
+		active_count_arr = new int[var_count];
+		position_arr = new int[var_count];
+		activation_arr = new DOMType[var_count];
+		rule_index_arr = new int[var_count];
+
+		if (!var_active_arr || !active_count_arr || !position_arr || !activation_arr || !rule_index_arr)
+			{
+			var_capacity = 0;
+			return -1;
+			}
+
+		var_capacity = var_count;
+
+		// the old active sets are gone
+		active_valid = false;
+		partial_var = -1;
+
+		} // end if need more vars
+
+	return 0;
+
+} // end InferenceScratch::alloc()
@@ -0,0 +1,100 @@
+//
+// File:	InferenceScratch.h
+//
+// Purpose:	Interface for the InferenceScratch class. This class holds the
+//			working memory the inference kernel uses to calculate the output
+//			of a model.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#ifndef _InferenceScratch_H
+#define _InferenceScratch_H
+
+#include "FFLLBase.h"
+#include "CompiledModel.h"
+#include <vector>
+
+//
+// Class:	InferenceScratch
+//
+// Working memory for CompiledModel::calc_output(). Rather than recursing through every
+// set of every input variable, the inference kernel first looks up the active (non-zero DOM)
+// sets for each input variable (see CompiledModel), then walks the
+// cross product of those active sets. Each child of a model has its own InferenceScratch so calculating output
+// never writes to the model itself.
+//
+// The arrays only ever grow, alloc() is a no-op once they're large enough for the model.
+//
+// The active sets are kept after the output is calculated so that when only one input
+// changes CompiledModel::calc_output_incremental() can re-use them. It also keeps the
+// partial activations (the combinations of the active sets of the variables before and
+// after the one that changed) so the unchanged variables aren't walked again.
+//
+
+class InferenceScratch
+{
+	////////////////////////////////////////
+	////////// Member Functions ////////////
+	////////////////////////////////////////
+
+	public:
+
+		// activation level and rule index for a combination of the active
+		// sets of several input variables
+		typedef struct _partial_activation_
+			{
+			DOMType		activation;	// activation level combining the sets' DOMs
+			int			rule_index;	// sum of the sets' rule indexes
+			} _partial_activation;
+
+		// constructor/destructor funcs
+		InferenceScratch();
+		virtual ~InferenceScratch();
+
+		// misc functions
+		int alloc(int var_count);
+
+	private:
+
+		// don't allow copies. No function bodies for these.
+		InferenceScratch(const InferenceScratch& copy_from);
+		InferenceScratch& operator=(const InferenceScratch& copy_from);
+
+	////////////////////////////////////////
+	////////// Class Variables /////////////
+	////////////////////////////////////////
+
+	public:
+
+		const CompiledModel::_active_set**	var_active_arr;	// for each input var, points to its first active set
+		int*				active_count_arr;		// for each input var, the number of active sets
+		int*				position_arr;			// for each input var, the active set we're currently on
+		DOMType*			activation_arr;			// for each input var, activation level combining vars 0 through N
+		int*				rule_index_arr;			// for each input var, rule index combining vars 0 through N
+
+		// incremental calculation (see CompiledModel::calc_output_incremental())
+		bool				active_valid;			// true if var_active_arr holds the active sets for the last output calculated
+		int					partial_var;			// variable the partial activations leave out, -1 if they aren't valid
+		std::vector<_partial_activation> prefix_arr;	// combinations of the active sets of the vars before partial_var
+		std::vector<_partial_activation> suffix_arr;	// combinations of the active sets of the vars after partial_var
+
+		// analytic calculation (see AnalyticEngine::calc_output())
+		std::vector<RealType>	real_dom_arr;		// DOM of each input set, the sets of var 0 then var 1...
+		std::vector<int>		real_active_arr;	// input sets with a non-zero DOM, the sets of var 0 then var 1...
+		std::vector<int>		real_active_start_arr;	// for each input var, index of its first active set in real_active_arr
+		std::vector<RealType>	real_activation_arr;	// for each input var, activation level combining vars 0 through N
+		std::vector<RealType>	real_level_arr;		// activation level of each output set (0 if no rule fired for it)
+
+	private:
+
+		int					var_capacity;			// number of input vars the arrays can hold
+
+}; // end class InferenceScratch
+
+#else
+
+class InferenceScratch;
+
+#endif // _InferenceScratch_H
@@ -1,51 +1,406 @@
 #include "MFLLAPI.h"
 #include "FFLLAPI.h"
+#include <float.h>
+#include <string.h>
+#include <string>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sys/types.h>
+#include <sys/stat.h>
 
+// maximum number of loaded models the one-stop APIs keep around
+#define MFLL_CACHE_SIZE	16
+
+// 
+// Class:	CachedModel
 //
-// Function:	MFLL_FuzzyInference()
+// An entry in the one-stop API's model cache. Most studies call MFLL_FuzzyInference()
+// with the same FCL on every bar so rather than parsing the FCL and building all the
+// membership function and defuzzification tables each time, we keep the loaded model
+// (and a child for it) around and look it up by the FCL text (or the file name and
+// the time the file was last modified).
+//
+// Entries are shared (std::shared_ptr) between the cache and the calls using them
+// so a model that's evicted while another thread is evaluating it isn't closed
+// until that thread is done with it. The entry's lock is held while its child is
+// in use since a child must only be used by one thread at a time.
+//
+
+class CachedModel
+{
+	// everything is public cuz these are only used in this file.
+	public:
+		CachedModel()
+			{
+			is_file = false;
+			hash = 0;
+			mtime = 0;
+			size = 0;
+			model = child = -1;
+			input_count = 0;
+			};
+		virtual ~CachedModel()
+			{
+			if (model >= 0)
+				ffll_close_model(model);
+			};
+
+		bool			is_file;	// true if 'key' is a file name, false if it's the FCL text
+		unsigned int	hash;		// hash of 'key' so we only compare strings when it's likely a match
+		std::string		key;		// FCL text or file name
+		time_t			mtime;		// time the file was last modified (0 for FCL text)
+		off_t			size;		// size of the file (0 for FCL text)
+		int				model;		// handle of the loaded model
+		int				child;		// child we use to evaluate the model
+		int				input_count;	// number of input variables in the model
+		std::mutex		lock;		// held while 'child' is in use
+
+	private:
+
+		// don't allow copies. No function bodies for these.
+		CachedModel(const CachedModel& copy_from);
+		CachedModel& operator=(const CachedModel& copy_from);
+
+}; // end class CachedModel
+
+typedef std::shared_ptr<CachedModel> CachedModelPtr;
+
 // 
-// Purpose:		This function simplifies usage to offer one-stop fuzzy inference output
-//				in which it consists of the required APIs from native FFLL library.
+// Class:	ModelCache
+//
+// The one-stop API's cache of loaded models. See get_model_cache() for why
+// there's only ever one and it's never freed.
+//
+
+class ModelCache
+{
+	// everything is public cuz these are only used in this file.
+	public:
+		std::list<CachedModelPtr>	models;	// the loaded models, the most recently used is at the front
+		std::mutex					lock;	// guards 'models' (but not the entries in it, see CachedModel::lock)
+
+}; // end class ModelCache
+
+//
+// Function:	get_model_cache()
+// 
+// Purpose:		Returns the model cache, creating it the first time. The cache is
+//				deliberately never freed: freeing it closes the models it holds and
+//				if that happened in a static destructor the handle table in
+//				FFLLAPI.cpp may already be destroyed (the order globals in different
+//				files are destroyed in isn't defined). This is a LOCAL function and
+//				is not exported.
 //
 // Arguments:	
 //
-//		LPSTR fcl_str - string of core fuzzy engine in Fuzzy Control Language
-//		double* crisp_inputs - array of ordered crisp inputs to fuzzy engine
-//		long input_size - size of crisp inputs
+//		none
 //
 // Returns:
 //
-//		double output value inferred by the fuzzy engine
+//		ModelCache& - the model cache
 //
 // Author:	Ming-Kai Jiau
-// Date:	2019/03/31
+// Date:	2026/10/16
 // 
 // Modification History
 // Author	Date		Modification
 // ------	----		------------
 //
 // 
-double WIN_FFLL_API MFLL_FuzzyInference(LPSTR fcl_str, double* crisp_inputs, long input_size)
+static ModelCache& get_model_cache()
+{
+	static ModelCache* cache = new ModelCache;
+
+	return *cache;
+
+} // end get_model_cache()
+
+//
+// Function:	hash_key()
+// 
+// Purpose:		Calculate the FNV-1a hash of the string passed in. This is a LOCAL
+//				function and is not exported.
+//
+// Arguments:	
+//
+//		const char*	str - string to hash
+//		size_t		len - length of the string
+//
+// Returns:
+//
+//		unsigned int - hash value
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+// 
+static unsigned int hash_key(const char* str, size_t len)
+{
+	unsigned int hash = 2166136261U;
+
+	for (size_t i = 0; i < len; i++)
+		{
+		hash ^= static_cast<unsigned char>(str[i]);
+		hash *= 16777619U;
+		}
+
+	return hash;
+
+} // end hash_key()
+
+//
+// Function:	find_cached_model()
+// 
+// Purpose:		Find the model for the FCL text (or file) passed in in the cache.
+//				If the file changed since the model was loaded the stale model is
+//				removed from the cache. The caller must hold the cache's lock.
+//				This is a LOCAL function and is not exported.
+//
+// Arguments:	
+//
+//		ModelCache&		cache	- the model cache
+//		const char*		fcl		- FCL text, or the name of the FCL file
+//		size_t			len		- length of 'fcl'
+//		bool			is_file	- true if 'fcl' is a file name
+//		unsigned int	hash	- hash of 'fcl'
+//		time_t			mtime	- time the file was last modified (0 for FCL text)
+//		off_t			size	- size of the file (0 for FCL text)
+//
+// Returns:
+//
+//		CachedModelPtr - the cache entry for the model, empty if it's not in the cache
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+// 
+static CachedModelPtr find_cached_model(ModelCache& cache, const char* fcl, size_t len, bool is_file, unsigned int hash, time_t mtime, off_t size)
+{
+	std::list<CachedModelPtr>& model_cache = cache.models;
+	std::list<CachedModelPtr>::iterator it;
+
+	for (it = model_cache.begin(); it != model_cache.end(); it++)
+		{
+		const CachedModel* entry = it->get();
+
+		if (entry->hash != hash || entry->is_file != is_file || entry->key.length() != len)
+			continue;
+
+		if (memcmp(entry->key.data(), fcl, len))
+			continue; // hash collision
+
+		if (entry->mtime != mtime || entry->size != size)
+			{
+			// the file changed, get rid of the stale model (it's closed
+			// once nobody is using it)
+			model_cache.erase(it);
+			break;
+			}
+
+		// move it to the front so it's the last to be evicted
+		if (it != model_cache.begin())
+			model_cache.splice(model_cache.begin(), model_cache, it);
+
+		return model_cache.front();
+
+		} // end loop through cache
+
+	return CachedModelPtr();
+
+} // end find_cached_model()
+
+//
+// Function:	get_cached_model()
+// 
+// Purpose:		Find the model for the FCL text (or file) passed in, loading
+//				it if it's not already in the cache. If the cache is full the
+//				least recently used model is removed from it. This is a LOCAL
+//				function and is not exported.
+//
+// Arguments:	
+//
+//		const char*	fcl		- FCL text, or the name of the FCL file
+//		bool		is_file	- true if 'fcl' is a file name
+//
+// Returns:
+//
+//		CachedModelPtr - the cache entry for the model, empty if the model could not be loaded.
+//						 The model isn't closed while the caller holds on to this.
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Lock the cache, share entries so evicting doesn't close a model in use
+// Ming-Kai Jiau	2026/10/16	Get the number of inputs from the model
+//
+// 
+static CachedModelPtr get_cached_model(const char* fcl, bool is_file)
+{
+	if (fcl == NULL)
+		return CachedModelPtr();
+
+	size_t len = strlen(fcl);
+	unsigned int hash = hash_key(fcl, len);
+	time_t mtime = 0;
+	off_t size = 0;
+
+	if (is_file)
+		{
+		// if the file changed since we loaded it we want to re-load it
+		struct stat file_stat;
+
+		if (stat(fcl, &file_stat) != 0)
+			return CachedModelPtr(); // can't read the file
+
+		mtime = file_stat.st_mtime;
+		size = file_stat.st_size;
+		}
+
+	ModelCache& cache = get_model_cache();
+
+	{
+	std::lock_guard<std::mutex> guard(cache.lock);
+
+	CachedModelPtr found = find_cached_model(cache, fcl, len, is_file, hash, mtime, size);
+
+	if (found)
+		return found;
+	}
+
+	// not in the cache, load it (without holding the lock so other
+	// models can be looked up while this one loads)...
+	CachedModelPtr entry(new CachedModel);
+
+	entry->model = ffll_new_model();
+
+	if (entry->model < 0)
+		return CachedModelPtr();
+
+	int ret_val = (is_file) ? ffll_load_fcl_file(entry->model, fcl) : ffll_load_fcl_string(entry->model, fcl);
+
+	// don't cache models that fail to load (the entry closes the model)
+	if (ret_val < 0 || (entry->child = ffll_new_child(entry->model)) < 0 ||
+		(entry->input_count = ffll_get_input_count(entry->model)) < 0)
+		return CachedModelPtr();
+
+	entry->is_file = is_file;
+	entry->hash = hash;
+	entry->key.assign(fcl, len);
+	entry->mtime = mtime;
+	entry->size = size;
+
+	std::lock_guard<std::mutex> guard(cache.lock);
+
+	// another thread may have loaded it while we were, use theirs
+	CachedModelPtr found = find_cached_model(cache, fcl, len, is_file, hash, mtime, size);
+
+	if (found)
+		return found;
+
+	cache.models.push_front(entry);
+
+	// evict the least recently used model(s), they're closed once nobody is using them
+	while (cache.models.size() > MFLL_CACHE_SIZE)
+		cache.models.pop_back();
+
+	return entry;
+
+} // end get_cached_model()
+
+//
+// Function:	cached_inference()
+// 
+// Purpose:		Common code for the one-stop APIs. Gets the model from the
+//				cache, sets the inputs and returns the output value. This is
+//				a LOCAL function and is not exported.
+//
+// Arguments:	
+//
+//		const char*	fcl				- FCL text, or the name of the FCL file
+//		bool		is_file			- true if 'fcl' is a file name
+//		double*		crisp_inputs	- array of ordered crisp inputs to fuzzy engine
+//		long		input_size		- size of crisp inputs, must be at least the number
+//									  of input variables in the model
+//
+// Returns:
+//
+//		double output value inferred by the fuzzy engine, FLT_MIN if the
+//		model could not be loaded or there aren't enough inputs
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Lock the entry while using its child, reject too few inputs
+//
+// 
+static double cached_inference(const char* fcl, bool is_file, double* crisp_inputs, long input_size)
 {
-	// create and load the model
-	int model = ffll_new_model();
+	CachedModelPtr entry = get_cached_model(fcl, is_file);
+
+	if (!entry)
+		return FLT_MIN;
 
-	int ret_val = (int)ffll_load_fcl_string(model, fcl_str);
-	//int ret_val = (int)ffll_load_fcl_file(model, "D:\\Playground\\mc-dlls-dev\\MultiCharts_Dll\\x64\\aiwisdom.fcl");
+	// the child is re-used for every call so any input that isn't
+	// passed in would keep the value from an earlier call
+	if (crisp_inputs == NULL || input_size < entry->input_count)
+		return FLT_MIN;
 
-	// create a child for the model...
-	int child = ffll_new_child(model);
+	std::lock_guard<std::mutex> guard(entry->lock);
 
 	// set input variables...
-	for (int i = 0; i < input_size; i++)
-		ffll_set_value(model, child, i, crisp_inputs[i]);
+	for (int i = 0; i < entry->input_count; i++)
+		ffll_set_value(entry->model, entry->child, i, crisp_inputs[i]);
 
-	// get and display the output value
-	double output = ffll_get_output_value(model, child);
+	// get the output value
+	return ffll_get_output_value(entry->model, entry->child);
 
-	ffll_close_model(model);
+} // end cached_inference()
 
-	return output;
+//
+// Function:	MFLL_FuzzyInference()
+// 
+// Purpose:		This function simplifies usage to offer one-stop fuzzy inference output
+//				in which it consists of the required APIs from native FFLL library.
+//
+// Arguments:	
+//
+//		LPSTR fcl_str - string of core fuzzy engine in Fuzzy Control Language
+//		double* crisp_inputs - array of ordered crisp inputs to fuzzy engine
+//		long input_size - size of crisp inputs
+//
+// Returns:
+//
+//		double output value inferred by the fuzzy engine, FLT_MIN if the
+//		FCL can't be loaded or input_size is less than the number of inputs
+//
+// Author:	Ming-Kai Jiau
+// Date:	2019/03/31
+// 
+// Modification History
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Keep loaded models in a cache rather than re-parsing each call
+// Ming-Kai Jiau	2026/10/16	Return FLT_MIN if there are fewer inputs than input variables
+//
+// 
+double WIN_FFLL_API MFLL_FuzzyInference(LPSTR fcl_str, double* crisp_inputs, long input_size)
+{
+	return cached_inference(fcl_str, false, crisp_inputs, input_size);
 }
 
 
@@ -64,35 +419,20 @@ double WIN_FFLL_API MFLL_FuzzyInference(LPSTR fcl_str, double* crisp_inputs, lon
 //
 // Returns:
 //
-//		double output value inferred by the fuzzy engine
+//		double output value inferred by the fuzzy engine, FLT_MIN if the
+//		FCL can't be loaded or input_size is less than the number of inputs
 //
 // Author:	Ming-Kai Jiau
 // Date:	2019/03/31
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Keep loaded models in a cache, re-load if the file changes
+// Ming-Kai Jiau	2026/10/16	Return FLT_MIN if there are fewer inputs than input variables
 //
 // 
 double WIN_FFLL_API MFLL_FuzzyInferenceByFile(LPSTR fcl_file, double* crisp_inputs, long input_size)
 {
-	// create and load the model
-	int model = ffll_new_model();
-
-	//int ret_val = (int)ffll_load_fcl_string(model, fcl_str);
-	int ret_val = (int)ffll_load_fcl_file(model, fcl_file);
-
-	// create a child for the model...
-	int child = ffll_new_child(model);
-
-	// set input variables...
-	for (int i = 0; i < input_size; i++)
-		ffll_set_value(model, child, i, crisp_inputs[i]);
-
-	// get and display the output value
-	double output = ffll_get_output_value(model, child);
-
-	ffll_close_model(model);
-
-	return output;
+	return cached_inference(fcl_file, true, crisp_inputs, input_size);
 }
\ No newline at end of file
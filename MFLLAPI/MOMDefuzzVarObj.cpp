@@ -95,8 +95,9 @@ MOMDefuzzVarObj::~MOMDefuzzVarObj()
 // Date:	8/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Only look up the winning set's defuzzification object
 //
 //
 RealType MOMDefuzzVarObj::calc_value(DOMType* out_set_dom_arr  )
@@ -104,9 +105,7 @@ RealType MOMDefuzzVarObj::calc_value(DOMType* out_set_dom_arr  )
 	FuzzyOutVariable*	parent;		// pointer to parent
 	int					num_of_sets;// number of sets
  	int					i;			// counter
- 	MOMDefuzzSetObj*	defuzz;		// defuzzification object for the set
 	MOMDefuzzSetObj*	winning_defuzz = NULL;		//defuzzification object for the WINNING set
-	FuzzyOutSet*		set;		// set to deal with
  	DOMType				mom_max;	// max MOM from sets
 	DOMType				mom_idx;	// MOM index for the DOM
 	int					set_idx = -1;// winning set idx
@@ -121,10 +120,6 @@ RealType MOMDefuzzVarObj::calc_value(DOMType* out_set_dom_arr  )
 	// find the highest DOM for the output sets
 	for (i = 0; i < num_of_sets; ++i)
 		{
-		set = parent->get_set(i);
-
-		defuzz = dynamic_cast<MOMDefuzzSetObj*>(set->get_defuzz_obj());  
-
   		mom_idx = out_set_dom_arr[i];  
 		if (mom_idx == 255)
 			mom_idx = 0;
@@ -133,11 +128,15 @@ RealType MOMDefuzzVarObj::calc_value(DOMType* out_set_dom_arr  )
 		if (mom_max < mom_idx)
 			{
 			mom_max = mom_idx;
-			winning_defuzz = defuzz;
+			set_idx = i;
 			}
 
 		} // end loop through sets
 
+	// only the winning set's defuzzification object is needed
+	if (set_idx >= 0)
+		winning_defuzz = get_set_defuzz_obj(set_idx);
+
 	if (!winning_defuzz)
 		{
 		// no output set value to FLT_MIN - the special value that
@@ -167,18 +166,21 @@ RealType MOMDefuzzVarObj::calc_value(DOMType* out_set_dom_arr  )
 // Date:	8/01
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
-//
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Don't dynamic_cast the set or its defuzzification object
 //
 MOMDefuzzSetObj* MOMDefuzzVarObj::get_set_defuzz_obj(int set_idx) const
 {
-	FuzzyOutVariable* parent = get_parent();
-	FuzzyOutSet* set = parent->get_set(set_idx);
+	// FuzzyOutVariable::get_set() does a dynamic_cast, the base class's get_set()
+	// and the set's virtual get_defuzz_obj() don't need one
+	DefuzzSetObj* tmp_obj = get_parent()->FuzzyVariableBase::get_set(set_idx)->get_defuzz_obj();
+
+	// the sets always use the variable's defuzzification method (see
+	// FuzzyOutVariable::set_defuzz_method()) so this is the right type
+	assert(tmp_obj == NULL || tmp_obj->get_defuzz_type() == DefuzzVarObj::DEFUZZ_MOM);
 
-	MOMDefuzzSetObj* tmp_obj = dynamic_cast<MOMDefuzzSetObj*>(set->get_defuzz_obj()); 
-	
-	return tmp_obj;
+	return static_cast<MOMDefuzzSetObj*>(tmp_obj);
 
 } // end MOMDefuzzVarObj::get_set_defuzz_obj()
 
@@ -0,0 +1,249 @@
+//
+// File:	MappedFile.cpp
+//
+// Purpose:	Implementation of the MappedFile class. This class maps a file into
+//			memory read-only.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _DEBUG
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+
+#include "debug.h"
+
+#endif
+
+//
+// Function:	MappedFile()
+//
+// Purpose:		Constructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+MappedFile::MappedFile()
+{
+	data = NULL;
+	length = 0;
+	file_handle = NULL;
+	map_handle = NULL;
+
+}; // end MappedFile::MappedFile()
+
+//
+// Function:	~MappedFile()
+//
+// Purpose:		Destructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+MappedFile::~MappedFile()
+{
+	close();
+
+}; // end MappedFile::~MappedFile()
+
+//
+// Function:	open()
+//
+// Purpose:		Map a file into memory read-only. Anything that was mapped before
+//				is unmapped first.
+//
+// Arguments:
+//
+//		const char* file_name - path and file name of the file to map
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure (the file couldn't be opened or mapped, or it's empty)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int MappedFile::open(const char* file_name)
+{
+	close();
+
+#ifdef _WIN32
+
+	// FILE_SHARE_READ only so nobody can write to the file while we have it mapped
+	HANDLE file = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (file == INVALID_HANDLE_VALUE)
+		return -1;
+
+	LARGE_INTEGER file_size;
+
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0 ||
+		static_cast<unsigned long long>(file_size.QuadPart) > static_cast<size_t>(-1))
+		{
+		CloseHandle(file);
+		return -1;
+		}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if (mapping == NULL)
+		{
+		CloseHandle(file);
+		return -1;
+		}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (view == NULL)
+		{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return -1;
+		}
+
+	// keep the file open, that's what stops it from being written to
+	file_handle = file;
+	map_handle = mapping;
+	length = static_cast<size_t>(file_size.QuadPart);
+
+#else
+
+	int file = ::open(file_name, O_RDONLY);
+
+	if (file < 0)
+		return -1;
+
+	struct stat file_info;
+
+	if (fstat(file, &file_info) != 0 || file_info.st_size <= 0 ||
+		static_cast<unsigned long long>(file_info.st_size) > static_cast<size_t>(-1))
+		{
+		::close(file);
+		return -1;
+		}
+
+	// MAP_SHARED so the pages are the file cache's pages, shared by every process
+	void* view = mmap(NULL, static_cast<size_t>(file_info.st_size), PROT_READ, MAP_SHARED, file, 0);
+
+	// the mapping holds its own reference to the file
+	::close(file);
+
+	if (view == MAP_FAILED)
+		return -1;
+
+	length = static_cast<size_t>(file_info.st_size);
+
+#endif
+
+	data = static_cast<const char*>(view);
+
+	return 0;
+
+} // end MappedFile::open()
+
+//
+// Function:	close()
+//
+// Purpose:		Unmap the file (if one is mapped).
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void MappedFile::close()
+{
+	if (data == NULL)
+		return;
+
+#ifdef _WIN32
+
+	UnmapViewOfFile(data);
+	CloseHandle(static_cast<HANDLE>(map_handle));
+	CloseHandle(static_cast<HANDLE>(file_handle));
+
+#else
+
+	munmap(const_cast<char*>(data), length);
+
+#endif
+
+	data = NULL;
+	length = 0;
+	file_handle = NULL;
+	map_handle = NULL;
+
+} // end MappedFile::close()
+
+
+/////////////////////////////////////////////////////////////////////
+////////// Trivial Functions That Don't Require Headers /////////////
+/////////////////////////////////////////////////////////////////////
+
+bool MappedFile::is_open() const
+{
+	return (data != NULL);
+};
+const char* MappedFile::get_data() const
+{
+	return data;
+};
+size_t MappedFile::get_length() const
+{
+	return length;
+};
@@ -0,0 +1,73 @@
+//
+// File:	MappedFile.h
+//
+// Purpose:	Interface for the MappedFile class. This class maps a file into
+//			memory read-only.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#ifndef _MappedFile_H
+#define _MappedFile_H
+
+#include <stddef.h>
+
+//
+// Class:	MappedFile
+//
+// Maps a whole file into memory read-only (CreateFileMapping()/MapViewOfFile() on Windows,
+// mmap() everywhere else). The pages come from the operating system's file cache so every
+// process that maps the same file shares one copy of it, and nothing is read until it's
+// touched.
+//
+// On Windows the file is opened without write sharing, so it can't be changed while it's
+// mapped. Other systems don't have a way to stop that, the file must not be rewritten in
+// place while it's mapped (replacing it with a new file is fine).
+//
+
+class MappedFile
+{
+	////////////////////////////////////////
+	////////// Member Functions ////////////
+	////////////////////////////////////////
+
+	public:
+
+		// constructor/destructor funcs
+		MappedFile();
+		virtual ~MappedFile();
+
+		// misc functions
+		int open(const char* file_name);
+		void close();
+
+		// get functions
+		bool is_open() const;
+		const char* get_data() const;
+		size_t get_length() const;
+
+	private:
+
+		// don't allow copies. No function bodies for these.
+		MappedFile(const MappedFile& copy_from);
+		MappedFile& operator=(const MappedFile& copy_from);
+
+	////////////////////////////////////////
+	////////// Class Variables /////////////
+	////////////////////////////////////////
+
+	private:
+
+		const char*	data;			// start of the mapped view, NULL if nothing is mapped
+		size_t		length;			// number of bytes in the view
+		void*		file_handle;	// handle of the open file (Windows only)
+		void*		map_handle;		// handle of the file mapping object (Windows only)
+
+}; // end class MappedFile
+
+#else
+
+class MappedFile;
+
+#endif // _MappedFile_H
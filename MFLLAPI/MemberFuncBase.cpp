@@ -51,8 +51,11 @@ MemberFuncBase::MemberFuncBase(FuzzySetBase* _parent) : FFLLBase(_parent)
 	// aren't called the way we want from the constructor
 
 	nodes = NULL;
+	node_values = NULL;
   
 	values = NULL; 
+	values_stride = 1;
+	own_values = false;
 
 	ramp = MemberFuncBase::RAMP_NONE; // not a ramp (at this point)
 
@@ -85,6 +88,8 @@ MemberFuncBase::~MemberFuncBase(void)
 	if (nodes != NULL)
 		delete[] nodes;
 
+	delete[] node_values;
+
  	dealloc_values_array();
 
 	nodes = NULL;
@@ -237,8 +242,8 @@ void MemberFuncBase::move(int x_delta)
 		start = node_count - 1;
 		end = -1;
 		increment = -1;
-		if (nodes[node_count - 1].x + x_delta > FuzzyVariableBase::get_x_array_max_idx())
-			x_delta = ( FuzzyVariableBase::get_x_array_max_idx()) - nodes[node_count - 1].x;
+		if (nodes[node_count - 1].x + x_delta > get_parent()->get_x_array_max_idx())
+			x_delta = ( get_parent()->get_x_array_max_idx()) - nodes[node_count - 1].x;
 
 		} // end if offset positive
 
@@ -329,13 +334,135 @@ void MemberFuncBase::save_to_fcl_file(std::ofstream& file_contents)
 
 } // end MemberFuncBase::save_to_file()
 
+//
+// Function:	set_node_value()
+// 
+// Purpose:		Save the exact value of a node. The node itself is an index into the
+//				values[] array so it loses precision, the exact value is used when
+//				the model is calculated analytically (see AnalyticEngine). Call this
+//				AFTER set_node(), the value is only used while the node stays where
+//				it was when the value was set.
+//
+// Arguments:
+//
+//		int			idx	-	index of the node
+//		RealType	x	-	'x' value of the node
+//		RealType	y	-	'y' value of the node from 0 to 1
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void MemberFuncBase::set_node_value(int idx, RealType x, RealType y)
+{
+	node_values[idx].x = x;
+	node_values[idx].y = y;
+	node_values[idx].node_x = nodes[idx].x;
+	node_values[idx].node_y = nodes[idx].y;
+	node_values[idx].valid = true;
+
+} // end MemberFuncBase::set_node_value()
+
+//
+// Function:	get_node_value()
+// 
+// Purpose:		Get the exact value of a node. If set_node_value() wasn't called for
+//				the node, or the node has moved since, the value is calculated from
+//				the node's index.
+//
+// Arguments:
+//
+//		int			idx	-	index of the node
+//		RealType*	x	-	gets the 'x' value of the node
+//		RealType*	y	-	gets the 'y' value of the node from 0 to 1
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void MemberFuncBase::get_node_value(int idx, RealType* x, RealType* y) const
+{
+	const _node_value& value = node_values[idx];
+
+	if (value.valid && value.node_x == nodes[idx].x && value.node_y == nodes[idx].y)
+		{
+		*x = value.x;
+		*y = value.y;
+		return;
+		}
+
+	*x = get_parent()->convert_idx_to_value(nodes[idx].x);
+	*y = static_cast<RealType>(nodes[idx].y) / FuzzyVariableBase::get_dom_array_max_idx();
+
+} // end MemberFuncBase::get_node_value()
+
+//
+// Function:	set_values_table()
+// 
+// Purpose:		Move the values[] array into a column of the variable's DOM table.
+//				The table is x-major, the DOM at index 'x' is at table[x * stride].
+//				The current values are copied to the table, if the member func had 
+//				its own array it's freed.
+//
+// Arguments:
+//
+//		PackedDOMType*	table	-	first element of this set's column in the table
+//		int				stride	-	number of elements between the DOMs of two 
+//									consecutive indexes (the number of sets)
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void MemberFuncBase::set_values_table(PackedDOMType* table, int stride)
+{
+	int x_count = get_parent()->get_x_array_count();
+
+	for (int i = 0; i < x_count; i++)
+		table[i * stride] = values[i * values_stride];
+
+	dealloc_values_array();
+
+	values = table;
+	values_stride = stride;
+
+} // end MemberFuncBase::set_values_table()
+
 /////////////////////////////////////////////////////////////////////
 ////////// Trivial Functions That Don't Require Headers /////////////
 /////////////////////////////////////////////////////////////////////
 
 int MemberFuncBase::alloc_values_array()
 {
-	values = new DOMType[ FuzzyVariableBase::get_x_array_count()];
+	// the set has its own array until the variable puts it in its
+	// DOM table (see FuzzyVariableBase::pack_sets())
+	values = new PackedDOMType[ get_parent()->get_x_array_count()];
+	values_stride = 1;
+	own_values = true;
 
 	if (values == NULL)
 		{
@@ -349,13 +476,30 @@ int MemberFuncBase::alloc_values_array()
 
 void MemberFuncBase::dealloc_values_array()
 {
- 	if (values != NULL)
+	// if the values are in the variable's DOM table the variable frees them
+ 	if (values != NULL && own_values)
 		delete[] values;
 
 	values = NULL;
+	own_values = false;
 
 } // end MemberFuncBase::dealloc_values_array()
 
+int MemberFuncBase::realloc_values()
+{
+	// the variable's x_array_count changed, the caller needs to set the nodes and calc()
+	dealloc_values_array();
+	set_node_max_idx();
+
+	if (alloc_values_array())
+		return -1;
+
+	clear_values();
+
+	return 0;
+
+} // end MemberFuncBase::realloc_values()
+
 void MemberFuncBase::move_node(int idx, _point pt) 
 {
 	move_node(idx, pt.x, pt.y);	
@@ -369,27 +513,52 @@ void MemberFuncBase::move_node(int idx, int x, int y)
 
 void MemberFuncBase::clear_values()
 { 
-	memset(values, 0,  FuzzyVariableBase::get_x_array_count() * sizeof(DOMType));
+	int x_count = get_parent()->get_x_array_count();
+
+	if (values_stride == 1)
+		memset(values, 0, x_count * sizeof(PackedDOMType));
+	else
+		{
+		for (int i = 0; i < x_count; i++)
+			values[i * values_stride] = 0;
+		}
+
+	// every calc() starts here, so the variable's active set lists are out of date
+	if (get_parent())
+		get_parent()->invalidate_active_sets();
  
 };
 
 int MemberFuncBase::alloc_nodes(int node_count)
 {
 	nodes = new NodePoint[node_count];
+	node_values = new _node_value[node_count];
  
-	if (nodes == NULL)
+	if (nodes == NULL || node_values == NULL)
 		{
 		set_msg_text(ERR_ALLOC_MEM);
 		return -1;
 		}
 
+	set_node_max_idx();
+
 	// initialize 
 	for (int i = 0; i < node_count; i++) 
+		{
  		nodes[i].x = nodes[i].y = 0;
+		node_values[i].valid = false;
+		}
 
 	return 0;
 };
 
+void MemberFuncBase::set_node_max_idx()
+{
+	// keep the nodes within the variable's values[] array
+	for (int i = 0; i < get_node_count(); i++)
+		nodes[i].x.set_max_idx(get_parent()->get_x_array_max_idx());
+};
+
 int MemberFuncBase::get_start_x(void) const 
 {
 	return(nodes[0].x);
@@ -426,15 +595,15 @@ DOMType MemberFuncBase::get_dom(int idx)
 {
 
 	assert(idx >= 0);
-	assert(idx < FuzzyVariableBase::get_x_array_count());
+	assert(idx < get_parent()->get_x_array_count());
  
 	// make sure index is within range
 	if (idx < 0)
 		idx = 0;
-	if (idx > FuzzyVariableBase::get_x_array_max_idx())
-		idx = FuzzyVariableBase::get_x_array_max_idx();
+	if (idx > get_parent()->get_x_array_max_idx())
+		idx = get_parent()->get_x_array_max_idx();
 	
-	return values[idx];
+	return values[idx * values_stride];
 
 };
 
@@ -451,15 +620,15 @@ RealType  MemberFuncBase::get_left_x() const
 DOMType MemberFuncBase::get_value(int idx) const 
 { 
 	assert(idx >= 0);
-	assert(idx < FuzzyVariableBase::get_x_array_count());
+	assert(idx < get_parent()->get_x_array_count());
 		
 	// make sure index is within range
 	if (idx < 0)
 		idx = 0;
-	if (idx > FuzzyVariableBase::get_x_array_max_idx())
-		idx = FuzzyVariableBase::get_x_array_max_idx();
+	if (idx > get_parent()->get_x_array_max_idx())
+		idx = get_parent()->get_x_array_max_idx();
 
-	return values[idx]; 
+	return values[idx * values_stride]; 
 };
 
 int MemberFuncBase::set_value(int idx, DOMType val) 
@@ -467,15 +636,15 @@ int MemberFuncBase::set_value(int idx, DOMType val)
 	// this value accepts a value between 0 and DOM max
  
 	assert(idx >= 0);
-	assert(idx < FuzzyVariableBase::get_x_array_count());
+	assert(idx < get_parent()->get_x_array_count());
 
 	// make sure index is within range
 	if (idx < 0)
 		idx = 0;
-	if (idx > FuzzyVariableBase::get_x_array_max_idx())
-		idx = FuzzyVariableBase::get_x_array_max_idx();
+	if (idx > get_parent()->get_x_array_max_idx())
+		idx = get_parent()->get_x_array_max_idx();
 
-	values[idx] = val;
+	values[idx * values_stride] = static_cast<PackedDOMType>(val);
  
 	return 0;
 };
@@ -507,15 +676,15 @@ int MemberFuncBase::set_value(int idx, RealType val)
 		y = FuzzyVariableBase::get_dom_array_max_idx();
 
 	assert(idx >= 0);
-	assert(idx < FuzzyVariableBase::get_x_array_count());
+	assert(idx < get_parent()->get_x_array_count());
 
 	// make sure index is within range
 	if (idx < 0)
 		idx = 0;
-	if (idx > FuzzyVariableBase::get_x_array_max_idx())
-		idx = FuzzyVariableBase::get_x_array_max_idx();
+	if (idx > get_parent()->get_x_array_max_idx())
+		idx = get_parent()->get_x_array_max_idx();
 
-	values[idx] = y;
+	values[idx * values_stride] = static_cast<PackedDOMType>(y);
  
 	return 0;
 };
@@ -46,6 +46,7 @@ class  MemberFuncBase : virtual public FFLLBase
 		int get_node_y(int idx) const;
 		int get_ramp() const;
 		NodePoint get_node(int idx) const;
+		void get_node_value(int idx, RealType* x, RealType* y) const;
 		DOMType get_value(int idx) const ;
 		DOMType get_dom(int idx);
 		FuzzySetBase* get_parent() const  ;
@@ -57,6 +58,7 @@ class  MemberFuncBase : virtual public FFLLBase
 		// set functions
 
 		virtual void set_node(int idx, int x, int y, bool validate = true) = 0;
+		void set_node_value(int idx, RealType x, RealType y);
 	 	virtual void set_ramp(int hi_lo_ind, int left_right_ind);
 		int set_value(int idx, DOMType val);
 		int set_value(int idx, RealType val);
@@ -67,6 +69,8 @@ class  MemberFuncBase : virtual public FFLLBase
 		void move_node(int idx, _point pt ) ;
 		virtual void move_node(int idx, int x, int y ) ;
 		virtual void calc() = 0;
+		int realloc_values();
+		void set_values_table(PackedDOMType* table, int stride);
 
   		// save/load functions
 
@@ -82,6 +86,7 @@ class  MemberFuncBase : virtual public FFLLBase
 		virtual void dealloc_values_array();
  		int alloc_nodes(int node_count);
 		void clear_values();
+		void set_node_max_idx();
 
 	////////////////////////////////////////
 	////////// Class Variables /////////////
@@ -92,8 +97,19 @@ class  MemberFuncBase : virtual public FFLLBase
 		enum RAMP {RAMP_NONE, RAMP_LEFT, RAMP_RIGHT, RAMP_NA}; // NA is not applicable for singleton member funcs
 
 	protected:
+
+		// the exact value of a node, the node itself is an index into the values[] array
+		typedef struct _node_value_
+			{
+			RealType	x;		// 'x' value of the node
+			RealType	y;		// 'y' value of the node (0 to 1)
+			int			node_x;	// node's 'x' index when the value was set
+			int			node_y;	// node's 'y' value when the value was set
+			bool		valid;	// true if the value was set
+			} _node_value;
  
  		NodePoint* nodes;	// array of "node" points for the curve
+		_node_value* node_values;	// array of the exact values of the nodes (see get_node_value())
 		int			ramp;	/* indicates if this term is a ramp. It can be one of the
 							** RAMP enum types defined in this class. A ramp is a membership
 							** function that has the 'y' axis as one of it's sides.
@@ -105,8 +121,11 @@ class  MemberFuncBase : virtual public FFLLBase
 							**                                       ___
 							**              Right Ramp Trapezoid:   /   |  
 							*/
-		DOMType*	values;	// This points to an array that holds the 'y' values for this term.
-							// It has FuzzyVariableBase::x_array_count elements
+		PackedDOMType* values;	// This points to an array that holds the 'y' values for this term.
+							// It has the parent variable's x_array_count elements, values_stride apart.
+							// Once the set is in a variable this is a column of the variable's DOM table
+		int			values_stride;	// number of elements between the values for consecutive indexes
+		bool		own_values;	// true if we allocated values[], false if it's in the variable's DOM table
 
 }; // end class MemberFuncBase
 
@@ -13,6 +13,7 @@
 #include "MemberFuncSingle.h"
 #include "FuzzyModelBase.h"
 #include "FuzzyVariableBase.h"
+#include "FuzzySetBase.h"
  
 
 #ifdef _DEBUG  
@@ -342,8 +343,10 @@ void MemberFuncSCurve::calc()
 // Date:	5/99
 // 
 // Modification History
-// Author	Date		Modification
-// ------	----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Halve the step once it's very small, wide curves (variables 
+//								with a large x_array_count) need steps smaller than 0.0005
 //
 //   
 
@@ -495,8 +498,10 @@ void MemberFuncSCurve::calc_curve_values(NodePoint& p1, NodePoint& p2, NodePoint
 				// decrease the step
 				if (step > .001f)
 		 			step -= .001f; // a smallER step
-				else
+				else if (step > .0005f)
 					step -= .0005f; // a very small step
+				else
+					step /= 2; // a tiny step
 
 				assert(step > 0);
 
@@ -514,7 +519,7 @@ void MemberFuncSCurve::calc_curve_values(NodePoint& p1, NodePoint& p2, NodePoint
 	 if (y >= FuzzyVariableBase::get_dom_array_count())
 		 y = FuzzyVariableBase::get_dom_array_max_idx();
 
-	 if (current_idx >= FuzzyVariableBase::get_x_array_count())
+	 if (current_idx >= get_parent()->get_x_array_count())
 		 return; // saftey
  
    	set_value(current_idx, static_cast<DOMType>(y)); // explicit cast to get over ambiguity
@@ -570,7 +575,7 @@ void  MemberFuncSCurve::set_ramp(int hi_lo_ind, int left_right_ind)
 		else
 			{
 			// make the right the ramp
-			nodes[3].x = nodes[4].x = nodes[5].x = nodes[6].x   =  FuzzyVariableBase::get_x_array_max_idx();
+			nodes[3].x = nodes[4].x = nodes[5].x = nodes[6].x   =  get_parent()->get_x_array_max_idx();
 			}
 		} // end if making hi ramp
 
@@ -13,6 +13,7 @@
 #include "MemberFuncSingle.h"
 #include "FuzzyModelBase.h"
 #include "FuzzyVariableBase.h"
+#include "FuzzySetBase.h"
 
 #ifdef _DEBUG  
 #undef THIS_FILE
@@ -213,8 +214,8 @@ void MemberFuncTrap::init_nodes(int mid_pt_x, int term_width)
 
 	// if start x is too close to the end move it...
 
-	if (mid_pt_x + term_width/2 >  FuzzyVariableBase::get_x_array_count())
-		mid_pt_x = FuzzyVariableBase::get_x_array_max_idx() - term_width/2;
+	if (mid_pt_x + term_width/2 >  get_parent()->get_x_array_count())
+		mid_pt_x = get_parent()->get_x_array_max_idx() - term_width/2;
 
  	nodes[0].x = mid_pt_x - term_width/2;
 	nodes[0].y = 0;
@@ -283,7 +284,7 @@ void  MemberFuncTrap::set_ramp(int hi_lo_ind, int left_right_ind)
 		if (hi_lo_ind == 1)
 			{
 			// making a high ramp
-			nodes[2].x = nodes[3].x = FuzzyVariableBase::get_x_array_max_idx();
+			nodes[2].x = nodes[3].x = get_parent()->get_x_array_max_idx();
 			}
 		else
 			{
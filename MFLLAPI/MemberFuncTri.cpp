@@ -13,6 +13,7 @@
 #include "MemberFuncSingle.h"
 #include "FuzzyModelBase.h"
 #include "FuzzyVariableBase.h"
+#include "FuzzySetBase.h"
 
 #ifdef _DEBUG  
 #undef THIS_FILE
@@ -236,7 +237,7 @@ void  MemberFuncTri::set_ramp(int hi_lo_ind, int left_right_ind)
 		else
 			{
 			// make the right the ramp
-			nodes[2].x = nodes[1].x = FuzzyVariableBase::get_x_array_max_idx();
+			nodes[2].x = nodes[1].x = get_parent()->get_x_array_max_idx();
 			}
 		} // end if making hi ramp
 
@@ -0,0 +1,448 @@
+//
+// File:	OutputMemo.cpp
+//
+// Purpose:	Implementation of the OutputMemo class. This class remembers the
+//			output for the most recently used combinations of input indexes.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#include "OutputMemo.h"
+
+#ifdef _DEBUG
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+
+#include "debug.h"
+
+#endif
+
+//
+// Function:	OutputMemo()
+//
+// Purpose:		Constructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+OutputMemo::OutputMemo()
+{
+	key_arr = NULL;
+	value_arr = NULL;
+	hash_arr = NULL;
+	prev_arr = NULL;
+	next_arr = NULL;
+	slot_arr = NULL;
+
+	var_count = capacity = count = 0;
+	slot_count = slot_shift = 0;
+	head = tail = -1;
+	hits = misses = 0;
+
+}; // end OutputMemo::OutputMemo()
+
+//
+// Function:	~OutputMemo()
+//
+// Purpose:		Destructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+OutputMemo::~OutputMemo()
+{
+	free_memory();
+
+}; // end OutputMemo::~OutputMemo()
+
+//
+// Function:	alloc()
+//
+// Purpose:		Allocate the table for the number of entries passed in. Any
+//				entries in the table are thrown away and the hit/miss counts
+//				are reset.
+//
+// Arguments:
+//
+//		int _var_count	-	number of input variables (indexes in each key)
+//		int _capacity	-	max number of entries, 0 to disable the table
+//
+// Returns:
+//
+//		0 - success
+//		non-zero - failure (the table is disabled)
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+int OutputMemo::alloc(int _var_count, int _capacity)
+{
+	free_memory();
+
+	hits = misses = 0;
+
+	if (_capacity <= 0 || _var_count <= 0)
+		return (_capacity < 0) ? -1 : 0;
+
+	// keep the hash table at most half full
+	int slots = 2;
+
+	while (slots < _capacity * 2)
+		{
+		if (slots > (1 << 29))
+			return -1;	// way too big
+
+		slots <<= 1;
+		}
+
+	key_arr = new short[_capacity * _var_count];
+	value_arr = new RealType[_capacity];
+	hash_arr = new unsigned int[_capacity];
+	prev_arr = new int[_capacity];
+	next_arr = new int[_capacity];
+	slot_arr = new int[slots];
+
+	if (!key_arr || !value_arr || !hash_arr || !prev_arr || !next_arr || !slot_arr)
+		{
+		free_memory();
+		return -1;
+		}
+
+	var_count = _var_count;
+	capacity = _capacity;
+	slot_count = slots;
+
+	// figure out how far to shift the hash so we get a slot index
+	for (slot_shift = 32; slots > 1; slots >>= 1)
+		slot_shift--;
+
+	clear();
+
+	return 0;
+
+} // end OutputMemo::alloc()
+
+//
+// Function:	find()
+//
+// Purpose:		Look up the output for the input indexes passed in. If it's
+//				found, the entry becomes the most recently used one.
+//
+// Arguments:
+//
+//		const short*	var_idx_arr	-	index into the values[] array for each input var
+//		RealType*		value		-	gets the output if it's found
+//
+// Returns:
+//
+//		true - found (a hit)
+//		false - not found (a miss), or the table is disabled
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+bool OutputMemo::find(const short* var_idx_arr, RealType* value)
+{
+	if (capacity == 0)
+		return false;
+
+	unsigned int hash = calc_hash(var_idx_arr);
+	int mask = slot_count - 1;
+
+	for (int slot = static_cast<int>(hash >> slot_shift); slot_arr[slot] >= 0; slot = (slot + 1) & mask)
+		{
+		int entry = slot_arr[slot];
+
+		if (hash_arr[entry] != hash)
+			continue;
+
+		const short* key = key_arr + entry * var_count;
+		int i;	// counter
+
+		for (i = 0; i < var_count && key[i] == var_idx_arr[i]; i++)
+			;
+
+		if (i < var_count)
+			continue;	// same hash, different key
+
+		// move the entry to the head of the list
+		if (entry != head)
+			{
+			unlink_entry(entry);
+			link_entry(entry);
+			}
+
+		*value = value_arr[entry];
+		hits++;
+
+		return true;
+
+		} // end loop through slots
+
+	misses++;
+
+	return false;
+
+} // end OutputMemo::find()
+
+//
+// Function:	add()
+//
+// Purpose:		Add the output for the input indexes passed in as the most recently
+//				used entry. If the table is full the least recently used entry is
+//				replaced. The indexes must not already be in the table (call this
+//				after find() fails).
+//
+// Arguments:
+//
+//		const short*	var_idx_arr	-	index into the values[] array for each input var
+//		RealType		value		-	output for the indexes
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void OutputMemo::add(const short* var_idx_arr, RealType value)
+{
+	if (capacity == 0)
+		return;
+
+	int entry;	// entry to fill in
+
+	if (count < capacity)
+		entry = count++;
+	else
+		{
+		// re-use the least recently used entry
+		entry = tail;
+
+		remove_from_slots(entry);
+		unlink_entry(entry);
+		}
+
+	short* key = key_arr + entry * var_count;
+
+	for (int i = 0; i < var_count; i++)
+		key[i] = var_idx_arr[i];
+
+	value_arr[entry] = value;
+	hash_arr[entry] = calc_hash(var_idx_arr);
+
+	// put it in the first empty slot of its probe sequence
+	int mask = slot_count - 1;
+	int slot = static_cast<int>(hash_arr[entry] >> slot_shift);
+
+	while (slot_arr[slot] >= 0)
+		slot = (slot + 1) & mask;
+
+	slot_arr[slot] = entry;
+
+	link_entry(entry);
+
+} // end OutputMemo::add()
+
+//
+// Function:	remove_from_slots()
+//
+// Purpose:		Take the entry passed in out of the hash table.
+//
+// Arguments:
+//
+//		int entry - entry to remove
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void OutputMemo::remove_from_slots(int entry)
+{
+	int mask = slot_count - 1;
+	int slot = static_cast<int>(hash_arr[entry] >> slot_shift);
+
+	while (slot_arr[slot] != entry)
+		slot = (slot + 1) & mask;
+
+	slot_arr[slot] = -1;
+
+	// re-insert the rest of the probe sequence so lookups don't stop at the hole
+	for (int i = (slot + 1) & mask; slot_arr[i] >= 0; i = (i + 1) & mask)
+		{
+		int moved_entry = slot_arr[i];
+
+		slot_arr[i] = -1;
+
+		int new_slot = static_cast<int>(hash_arr[moved_entry] >> slot_shift);
+
+		while (slot_arr[new_slot] >= 0)
+			new_slot = (new_slot + 1) & mask;
+
+		slot_arr[new_slot] = moved_entry;
+		}
+
+} // end OutputMemo::remove_from_slots()
+
+//
+// Function:	calc_hash()
+//
+// Purpose:		Hash the input indexes passed in.
+//
+// Arguments:
+//
+//		const short* var_idx_arr - index into the values[] array for each input var
+//
+// Returns:
+//
+//		unsigned int - hash, the high bits pick the slot
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+unsigned int OutputMemo::calc_hash(const short* var_idx_arr) const
+{
+	// FNV-1a over the indexes then fibonacci hashing to spread it to the high bits
+	unsigned int hash = 2166136261u;
+
+	for (int i = 0; i < var_count; i++)
+		hash = (hash ^ static_cast<unsigned short>(var_idx_arr[i])) * 16777619u;
+
+	return hash * 2654435769u;
+
+} // end OutputMemo::calc_hash()
+
+/////////////////////////////////////////////////////////////////////
+////////// Trivial Functions That Don't Require Headers /////////////
+/////////////////////////////////////////////////////////////////////
+
+void OutputMemo::clear()
+{
+	for (int i = 0; i < slot_count; i++)
+		slot_arr[i] = -1;
+
+	count = 0;
+	head = tail = -1;
+
+}; // end OutputMemo::clear()
+
+void OutputMemo::free_memory()
+{
+	delete[] key_arr;
+	delete[] value_arr;
+	delete[] hash_arr;
+	delete[] prev_arr;
+	delete[] next_arr;
+	delete[] slot_arr;
+
+	key_arr = NULL;
+	value_arr = NULL;
+	hash_arr = NULL;
+	prev_arr = NULL;
+	next_arr = NULL;
+	slot_arr = NULL;
+
+	var_count = capacity = count = 0;
+	slot_count = 0;
+	head = tail = -1;
+
+}; // end OutputMemo::free_memory()
+
+void OutputMemo::unlink_entry(int entry)
+{
+	if (prev_arr[entry] >= 0)
+		next_arr[prev_arr[entry]] = next_arr[entry];
+	else
+		head = next_arr[entry];
+
+	if (next_arr[entry] >= 0)
+		prev_arr[next_arr[entry]] = prev_arr[entry];
+	else
+		tail = prev_arr[entry];
+
+}; // end OutputMemo::unlink_entry()
+
+void OutputMemo::link_entry(int entry)
+{
+	// make it the head of the list
+	prev_arr[entry] = -1;
+	next_arr[entry] = head;
+
+	if (head >= 0)
+		prev_arr[head] = entry;
+	else
+		tail = entry;
+
+	head = entry;
+
+}; // end OutputMemo::link_entry()
+
+int OutputMemo::get_capacity() const
+{
+	return capacity;
+};
+
+long long OutputMemo::get_hits() const
+{
+	return hits;
+};
+
+long long OutputMemo::get_misses() const
+{
+	return misses;
+};
@@ -0,0 +1,102 @@
+//
+// File:	OutputMemo.h
+//
+// Purpose:	Interface for the OutputMemo class. This class remembers the
+//			output for the most recently used combinations of input indexes.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#ifndef _OutputMemo_H
+#define _OutputMemo_H
+
+#include "FFLLBase.h"
+
+//
+// Class:	OutputMemo
+//
+// Bounded table that maps a combination of input indexes (the var_idx_arr of a child)
+// to the defuzzified output for it. Inputs are quantized to an index into the values[]
+// array before inference so the same combination comes up over and over, especially
+// for inputs that oscillate in a range. 
+//
+// The entries are kept in a hash table (open addressing, like RuleArray) and on a list
+// in the order they were last used. When the table is full the least recently used
+// entry is replaced. The number of hits and misses is counted so the caller can see
+// if the table is worth having.
+//
+// The table is empty (and find() always fails without counting a miss) until alloc()
+// is called with a non-zero capacity.
+//
+
+class OutputMemo
+{
+	////////////////////////////////////////
+	////////// Member Functions ////////////
+	////////////////////////////////////////
+
+	public:
+
+		// constructor/destructor funcs
+		OutputMemo();
+		virtual ~OutputMemo();
+
+		// get functions
+		int get_capacity() const;
+		long long get_hits() const;
+		long long get_misses() const;
+
+		// misc functions
+		int alloc(int _var_count, int _capacity);
+		bool find(const short* var_idx_arr, RealType* value);
+		void add(const short* var_idx_arr, RealType value);
+		void clear();
+
+	private:
+
+		// don't allow copies. No function bodies for these.
+		OutputMemo(const OutputMemo& copy_from);
+		OutputMemo& operator=(const OutputMemo& copy_from);
+
+		// misc functions
+		void free_memory();
+		unsigned int calc_hash(const short* var_idx_arr) const;
+		void unlink_entry(int entry);
+		void link_entry(int entry);
+		void remove_from_slots(int entry);
+
+	////////////////////////////////////////
+	////////// Class Variables /////////////
+	////////////////////////////////////////
+
+	private:
+
+		int				var_count;		// number of indexes in each key
+		int				capacity;		// max number of entries (0 if the table is disabled)
+		int				count;			// number of entries in use
+
+		// entries
+		short*			key_arr;		// var_count indexes for each entry
+		RealType*		value_arr;		// output for each entry
+		unsigned int*	hash_arr;		// hash of each entry's key
+		int*			prev_arr;		// previous (more recently used) entry, -1 for the head
+		int*			next_arr;		// next (less recently used) entry, -1 for the tail
+		int				head;			// most recently used entry
+		int				tail;			// least recently used entry
+
+		// hash table of entries
+		int*			slot_arr;		// entry for each slot (-1 if the slot is empty)
+		int				slot_count;		// number of slots (always a power of 2)
+		int				slot_shift;		// shift to map a hash to a slot
+
+		long long		hits;			// number of times find() found the key
+		long long		misses;			// number of times find() didn't find the key
+
+}; // end class OutputMemo
+
+#else
+
+class OutputMemo;
+
+#endif // _OutputMemo_H
@@ -13,6 +13,7 @@
  
 #include "RuleArray.h"
 #include "FuzzyModelBase.h"
+#include <algorithm>
  
 #ifdef _DEBUG  
 #undef THIS_FILE
@@ -48,6 +49,10 @@ RuleArray::RuleArray(FuzzyModelBase* _parent) :  FFLLBase(_parent)
 	rules = NULL; 
 	max = 0;
 
+	hash_index_arr = NULL;
+	hash_rule_arr = NULL;
+	hash_capacity = hash_shift = hash_count = 0;
+
 }; // end RuleArray::RuleArray()
 
 
@@ -80,7 +85,9 @@ RuleArray::~RuleArray()
 //
 // Function:	alloc()
 // 
-// Purpose:		This function allocates memory for the rule array
+// Purpose:		This function allocates memory for the rule array. If there
+//				are more than MFLL_DENSE_RULE_MAX rule combinations only the
+//				rules that are defined are stored, in a hash table.
 // 
 // Arguments:
 //
@@ -95,17 +102,15 @@ RuleArray::~RuleArray()
 // Date:	7/8/99
 // 
 // Modification History
-// Author		Date		Modification
-// ------		----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Use a hash table for large rule spaces
 //
 int RuleArray::alloc(int size) 
 {
  
-	// if we have rules, free the memory
-	if (rules != NULL)
-		{
-		free_memory();
-		}
+	// free any memory we have
+	free_memory();
 
 	// 0 size is OK - we may not have any terms yet
 	if (size <= 0)
@@ -114,6 +119,16 @@ int RuleArray::alloc(int size)
 		return 0;
 		} 
 
+	if (size > MFLL_DENSE_RULE_MAX)
+		{
+		if (alloc_hash(16))
+			return -1;
+
+		max = size;
+
+		return 0;
+		}
+
 	rules = new RuleArrayType[size]; 
 
 	if (rules == NULL)
@@ -153,15 +168,28 @@ int RuleArray::alloc(int size)
 // Date:	7/8/99
 // 
 // Modification History
-// Author		Date		Modification
-// ------		----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Add the rules one at a time if we're using the hash table
 //
  
 int RuleArray::set(RuleArrayType* source, int size) 
 {
 
 	// allocate the rules (this deletes any existing memory)
-	alloc(size);
+	if (alloc(size))
+		return -1;
+
+	if (rules == NULL)
+		{
+		for (int i = 0; i < size; i++)
+			{
+			if (source[i] != NO_RULE)
+				add_rule(i, source[i]);
+			}
+
+		return 0;
+		}
 
 	// copy the rules passed in
 	memcpy(rules, source, sizeof(RuleArrayType) * size);
@@ -190,11 +218,15 @@ int RuleArray::set(RuleArrayType* source, int size)
 // Date:	7/8/99
 // 
 // Modification History
-// Author		Date		Modification
-// ------		----		------------
+// Author			Date		Modification
+// ------			----		------------
+// Ming-Kai Jiau	2026/10/16	Check the hash table count if we're using it
 //
 bool RuleArray::no_rules() const 
 {
+	if (hash_index_arr != NULL)
+		return (hash_count == 0);
+
 	if (rules == NULL)
 		return true;
 
@@ -211,13 +243,181 @@ bool RuleArray::no_rules() const
 	
 }; // end RuleArray::no_rules()
 
+//
+// Function:	get_rule_indexes()
+// 
+// Purpose:		Get the indexes of the rules that are defined, in increasing
+//				order. This lets the caller visit just the defined rules rather
+//				than every combination.
+// 
+// Arguments:
+//
+//			std::vector<int>& index_arr - filled with the rule indexes
+// 
+// Returns:
+//
+//			number of rules defined
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+int RuleArray::get_rule_indexes(std::vector<int>& index_arr) const
+{
+	int i;	// counter
+
+	index_arr.clear();
+
+	if (hash_index_arr != NULL)
+		{
+		index_arr.reserve(hash_count);
+
+		for (i = 0; i < hash_capacity; i++)
+			{
+			if (hash_index_arr[i] >= 0)
+				index_arr.push_back(hash_index_arr[i]);
+			}
+
+		std::sort(index_arr.begin(), index_arr.end());
+		}
+	else if (rules != NULL)
+		{
+		for (i = 0; i < max; i++)
+			{
+			if (rules[i] != NO_RULE)
+				index_arr.push_back(i);
+			}
+		}
+
+	return index_arr.size();
+
+}; // end RuleArray::get_rule_indexes()
+
+//
+// Function:	alloc_hash()
+// 
+// Purpose:		Allocate the hash table with the capacity passed in and re-insert
+//				any rules that were in the old table.
+// 
+// Arguments:
+//
+//			int capacity - number of slots, must be a power of 2
+// 
+// Returns:
+//
+//			0 - success
+//			non-zero - failure
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+int RuleArray::alloc_hash(int capacity)
+{
+	int*			old_index_arr = hash_index_arr;
+	RuleArrayType*	old_rule_arr = hash_rule_arr;
+	int				old_capacity = hash_capacity;
+	int				i;	// counter
+
+	hash_index_arr = new int[capacity];
+	hash_rule_arr = new RuleArrayType[capacity];
+
+	if (hash_index_arr == NULL || hash_rule_arr == NULL)
+		{
+		delete[] hash_index_arr;
+		delete[] hash_rule_arr;
+
+		hash_index_arr = old_index_arr;
+		hash_rule_arr = old_rule_arr;
+
+		set_msg_text(ERR_ALLOC_MEM);
+		return -1;
+		}
+
+	for (i = 0; i < capacity; i++)
+		hash_index_arr[i] = -1;
+
+	hash_capacity = capacity;
+
+	// figure out how far to shift the hashed index so we get a slot index
+	for (hash_shift = 32; capacity > 1; capacity >>= 1)
+		hash_shift--;
+
+	// re-insert the old rules
+	for (i = 0; i < old_capacity; i++)
+		{
+		if (old_index_arr[i] < 0)
+			continue;
+
+		int slot = find_hash_slot(old_index_arr[i]);
+
+		hash_index_arr[slot] = old_index_arr[i];
+		hash_rule_arr[slot] = old_rule_arr[i];
+		}
+
+	delete[] old_index_arr;
+	delete[] old_rule_arr;
+
+	return 0;
+
+}; // end RuleArray::alloc_hash()
+
+//
+// Function:	find_hash_slot()
+// 
+// Purpose:		Find the slot in the hash table that holds the rule index
+//				passed in, or the empty slot where it would go.
+// 
+// Arguments:
+//
+//			int index - rule index to look for
+// 
+// Returns:
+//
+//			slot index
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+// 
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+int RuleArray::find_hash_slot(int index) const
+{
+	// fibonacci hashing, the high bits of the product pick the slot
+	int slot = static_cast<int>((static_cast<unsigned int>(index) * 2654435769u) >> hash_shift);
+
+	while (hash_index_arr[slot] >= 0 && hash_index_arr[slot] != index)
+		slot = (slot + 1) & (hash_capacity - 1);
+
+	return slot;
+
+}; // end RuleArray::find_hash_slot()
+
 /////////////////////////////////////////////////////////////////////
 ////////// Trivial Functions That Don't Require Headers /////////////
 /////////////////////////////////////////////////////////////////////
 
 void RuleArray::clear()
 {
-	memset(rules, NO_RULE, max * sizeof(RuleArrayType));
+	if (hash_index_arr != NULL)
+		{
+		for (int i = 0; i < hash_capacity; i++)
+			hash_index_arr[i] = -1;
+
+		hash_count = 0;
+		return;
+		}
+
+	if (rules != NULL)
+		memset(rules, NO_RULE, max * sizeof(RuleArrayType));
 
 }; // end RuleArray::clear()
 
@@ -228,20 +428,62 @@ void RuleArray::free_memory()
 
 	max = 0; 
 	rules = NULL;
+
+	delete[] hash_index_arr;
+	delete[] hash_rule_arr;
+
+	hash_index_arr = NULL;
+	hash_rule_arr = NULL;
+	hash_capacity = hash_shift = hash_count = 0;
 };
 
 RuleArrayType RuleArray::get_rule(int index) const 
 {
 	assert(index < max);
 
-	return(rules[index]);
+	if (rules != NULL)
+		return(rules[index]);
+
+	if (hash_index_arr == NULL)
+		return NO_RULE;
+
+	int slot = find_hash_slot(index);
+
+	return ((hash_index_arr[slot] < 0) ? NO_RULE : hash_rule_arr[slot]);
 }; 
 
 void RuleArray::add_rule(int index, RuleArrayType output_set)
 {
 	assert(index < max);
 
-	rules[index] = (RuleArrayType)(output_set);
+	if (rules != NULL)
+		{
+		rules[index] = (RuleArrayType)(output_set);
+		return;
+		}
+
+	if (hash_index_arr == NULL || index < 0 || index >= max)
+		return;
+
+	if (output_set == NO_RULE)
+		{
+		remove_rule(index);
+		return;
+		}
+
+	// keep the table at most half full so the probe sequences stay short
+	if ((hash_count + 1) * 2 > hash_capacity && alloc_hash(hash_capacity * 2))
+		return;
+
+	int slot = find_hash_slot(index);
+
+	if (hash_index_arr[slot] < 0)
+		{
+		hash_index_arr[slot] = index;
+		hash_count++;
+		}
+
+	hash_rule_arr[slot] = output_set;
 }; 
 
 int RuleArray::get_max() const
@@ -253,7 +495,43 @@ void RuleArray::remove_rule(int index)
 {
 	assert(index < max);
 
-	rules[index] = NO_RULE;
+	if (rules != NULL)
+		{
+		rules[index] = NO_RULE;
+		return;
+		}
+
+	if (hash_index_arr == NULL)
+		return;
+
+	int slot = find_hash_slot(index);
+
+	if (hash_index_arr[slot] < 0)
+		return; // not in the table
+
+	hash_index_arr[slot] = -1;
+	hash_count--;
+
+	// re-insert the rest of the probe sequence so lookups don't stop at the hole
+	int mask = hash_capacity - 1;
+
+	for (int i = (slot + 1) & mask; hash_index_arr[i] >= 0; i = (i + 1) & mask)
+		{
+		int				moved_index = hash_index_arr[i];
+		RuleArrayType	moved_rule = hash_rule_arr[i];
+
+		hash_index_arr[i] = -1;
+
+		int new_slot = find_hash_slot(moved_index);
+
+		hash_index_arr[new_slot] = moved_index;
+		hash_rule_arr[new_slot] = moved_rule;
+		}
+};
+
+bool RuleArray::is_sparse() const
+{
+	return (rules == NULL && hash_index_arr != NULL);
 };
 
 FuzzyModelBase* RuleArray::get_parent(void) const
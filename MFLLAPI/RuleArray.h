@@ -16,7 +16,13 @@
 #define AFX_RULEARRAY_H__0BBBA8C1_3467_11D3_B77E_709159C10001__INCLUDED_
  
 #include "FFLLBase.h"
+#include <vector>
 class FuzzyModelBase;
+
+// largest number of rule combinations we hold in a dense array. Models with more
+// combinations than this keep only the rules that are defined in a hash table so
+// the memory used depends on the number of rules rather than the number of combinations.
+#define MFLL_DENSE_RULE_MAX		65536
  
 // 
 // Class:	RuleArray
@@ -41,6 +47,8 @@ class  RuleArray  :  virtual public FFLLBase
 		// get funcs
 		int get_max() const ;
  		RuleArrayType get_rule(int index) const ;
+		int get_rule_indexes(std::vector<int>& index_arr) const;
+		bool is_sparse() const;
 		const char* get_model_name() const;
 		FuzzyModelBase* get_parent(void) const;
 
@@ -55,13 +63,26 @@ class  RuleArray  :  virtual public FFLLBase
 		void remove_rule(int index);
 		bool no_rules() const ;
 
+	protected:
+
+		int alloc_hash(int capacity);
+		int find_hash_slot(int index) const;
+
 	////////////////////////////////////////
 	////////// Class Variables /////////////
 	////////////////////////////////////////
 
 	protected:
-		RuleArrayType*	rules;		// array of rules
+		RuleArrayType*	rules;		// array of rules (NULL if we're using the hash table)
  		int				max;		// max number of rules we've allocated space for
+
+		// hash table used instead of the rules array when there are more than
+		// MFLL_DENSE_RULE_MAX combinations. Open addressing with linear probing.
+		int*			hash_index_arr;	// rule index for each slot (-1 if the slot is empty)
+		RuleArrayType*	hash_rule_arr;	// output set for each slot
+		int				hash_capacity;	// number of slots (always a power of 2)
+		int				hash_shift;		// shift to map a hashed rule index to a slot
+		int				hash_count;		// number of rules in the table
 	
 		
 }; // end class RuleArray  
@@ -0,0 +1,150 @@
+//
+// File:	WADefuzzSetObj.cpp
+//
+// Purpose:	Set object for the Weighted Average defuzzification method
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#include "WADefuzzSetObj.h"
+#include "FuzzyOutSet.h"
+#include "FuzzyOutVariable.h"
+
+#ifdef _DEBUG
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+
+#include "debug.h"
+
+#endif
+
+//
+// Function:	WADefuzzSetObj()
+//
+// Purpose:		Constructor
+//
+// Arguments:
+//
+//		FuzzyOutSet* par - set that this is part of
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+WADefuzzSetObj::WADefuzzSetObj(FuzzyOutSet* par)
+: DefuzzSetObj(par), FFLLBase(par)
+{
+	position = 0.0;
+
+}; // end WADefuzzSetObj::WADefuzzSetObj()
+
+//
+// Function:	~WADefuzzSetObj()
+//
+// Purpose:		Destructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+WADefuzzSetObj::~WADefuzzSetObj()
+{
+
+}; // end WADefuzzSetObj::~WADefuzzSetObj()
+
+//
+// Function:	calc()
+//
+// Purpose:		Calculates the 'x' value of the set. For a singleton that's the
+//				singleton's value. Other shapes use the middle of the first and last
+//				nodes with the highest 'y' (like MOMDefuzzSetObj), which is the centre
+//				of a symmetric triangle/trapezoid.
+//				Unlike MOMDefuzzSetObj this uses the nodes' values rather than
+//				their indexes so the position isn't rounded to the nearest index.
+//
+// Arguments:
+//
+//		void
+//
+// Returns:
+//
+//		void
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+void WADefuzzSetObj::calc()
+{
+	int			i;				// counter
+	RealType	x, y;			// node's value
+	RealType	max_y = -1.0;	// highest 'y' of the nodes
+	RealType	first_x = 0.0;	// 'x' of the first node at max_y
+	RealType	last_x = 0.0;	// 'x' of the last node at max_y
+
+	FuzzyOutSet* set_base = get_parent();
+	int node_count = set_base->get_node_count();
+
+	for (i = 0; i < node_count; i++)
+		{
+		set_base->get_node_value(i, &x, &y);
+
+		if (y > max_y)
+			{
+			max_y = y;
+			first_x = last_x = x;
+			}
+		else if (y == max_y)
+			last_x = x;
+
+		} // end loop through nodes
+
+	position = (first_x + last_x) / 2.0;
+
+	// keep it in the variable's range, just like the nodes' indexes are
+	const FuzzyOutVariable* var = set_base->get_parent();
+
+	if (position < var->get_left_x())
+		position = var->get_left_x();
+	else if (position > var->get_right_x())
+		position = var->get_right_x();
+
+} // end WADefuzzSetObj::calc()
+
+
+/////////////////////////////////////////////////////////////////////
+////////// Trivial Functions That Don't Require Headers /////////////
+/////////////////////////////////////////////////////////////////////
+RealType WADefuzzSetObj::get_position() const
+{
+	return position;
+};
+int WADefuzzSetObj::get_defuzz_type() const
+{
+	return DefuzzVarObj::DEFUZZ_WA;
+};
@@ -0,0 +1,58 @@
+//
+// File:	WADefuzzSetObj.h
+//
+// Purpose:	Set class for the Weighted Average defuzzification method.
+//			See WADefuzzVarObj for details on how this method works.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#ifndef _WADefuzzSetObj_H
+#define _WADefuzzSetObj_H
+
+#include "DefuzzVarObj.h"
+#include "DefuzzSetObj.h"
+class FuzzyOutSet;
+
+//
+// Class:	WADefuzzSetObj
+//
+// Weighted Average defuzzification set object. This object holds the 'x' value
+// the set's activation level is applied to. See WADefuzzVarObj.h for details on
+// this defuzz method.
+//
+class WADefuzzSetObj : public DefuzzSetObj
+{
+	////////////////////////////////////////
+	////////// Member Functions ////////////
+	////////////////////////////////////////
+
+	public:
+		// constructor/destructor funcs
+		WADefuzzSetObj();// No function body for this. Explicitly disallow auto-creation of it by the compiler
+		WADefuzzSetObj(FuzzyOutSet* par);
+		virtual ~WADefuzzSetObj();
+
+		// get functions
+		RealType get_position() const;
+		int get_defuzz_type() const;
+
+		// misc functions
+		void calc(void);
+
+	////////////////////////////////////////
+	////////// Class Variables /////////////
+	////////////////////////////////////////
+
+	private:
+
+		RealType position;	// 'x' value of the set (the singleton's value)
+
+}; // end class WADefuzzSetObj
+
+#else
+
+class WADefuzzSetObj;
+
+#endif // _WADefuzzSetObj_H
@@ -0,0 +1,170 @@
+//
+// File:	WADefuzzVarObj.cpp
+//
+// Purpose:	Variable object for the Weighted Average defuzzification method
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#include "WADefuzzVarObj.h"
+#include "WADefuzzSetObj.h"
+#include "FuzzyOutSet.h"
+#include "FuzzyOutVariable.h"
+
+#ifdef _DEBUG
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+
+#include "debug.h"
+
+#endif
+
+//
+// Function:	WADefuzzVarObj()
+//
+// Purpose:		Constructor
+//
+// Arguments:
+//
+//		FuzzyOutVariable* par - variable that this is part of
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+WADefuzzVarObj::WADefuzzVarObj(FuzzyOutVariable* _parent): DefuzzVarObj(_parent), FFLLBase(_parent)
+{
+	// nothing to do
+}
+
+//
+// Function:	~WADefuzzVarObj()
+//
+// Purpose:		Destructor
+//
+// Arguments:
+//
+//		none
+//
+// Returns:
+//
+//		none
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+WADefuzzVarObj::~WADefuzzVarObj()
+{
+	// nothing to do
+}
+
+//
+// Function:	calc_value()
+//
+// Purpose:		Calculates the weighted average of the sets' 'x' values using
+//				each set's DOM as its weight.
+//
+// Arguments:
+//
+//		DOMType* out_set_dom_arr - DOM value for each set in the output variable
+//
+// Returns:
+//
+//		RealType - the defuzzified value, FLT_MIN if no output sets are active
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+RealType WADefuzzVarObj::calc_value(DOMType* out_set_dom_arr)
+{
+	int			i;					// counter
+	RealType	weight_sum = 0.0;	// sum of the DOMs
+	RealType	moment_sum = 0.0;	// sum of the DOMs times the sets' positions
+	WADefuzzSetObj*	defuzz;			// defuzzification object for the set
+
+	int num_of_sets = get_parent()->get_num_of_sets();
+
+	for (i = 0; i < num_of_sets; i++)
+		{
+		defuzz = get_set_defuzz_obj(i);
+
+		if (defuzz == NULL)
+			continue;	// a set with no WA object has no weight
+
+		DOMType dom = out_set_dom_arr[i];
+
+		if (dom == 255)
+			dom = 0;
+
+		weight_sum += dom;
+		moment_sum += dom * defuzz->get_position();
+
+		} // end loop through sets
+
+	if (weight_sum == 0)
+		{
+		// no output set value to FLT_MIN - the special value that
+		// ensures we know that there is no output
+		return FLT_MIN;	// don't div by 0... just return
+		}
+
+	return moment_sum / weight_sum;
+
+} // end WADefuzzVarObj::calc_value()
+
+//
+// Function:	get_set_defuzz_obj()
+//
+// Purpose:		Gets the defuzzification object for the set
+//
+// Arguments:
+//
+//		int set_idx - index of the set to get the object for
+//
+// Returns:
+//
+//		WADefuzzSetObj* - the set's defuzzification object, NULL if it's not a WA object
+//
+// Author:	Ming-Kai Jiau
+// Date:	2026/10/16
+//
+// Modification History
+// Author	Date		Modification
+// ------	----		------------
+//
+//
+WADefuzzSetObj* WADefuzzVarObj::get_set_defuzz_obj(int set_idx) const
+{
+	FuzzyOutSet* set = get_parent()->get_set(set_idx);
+
+	return dynamic_cast<WADefuzzSetObj*>(set->get_defuzz_obj());
+
+} // end WADefuzzVarObj::get_set_defuzz_obj()
+
+/////////////////////////////////////////////////////////////////////
+////////// Trivial Functions That Don't Require Headers /////////////
+/////////////////////////////////////////////////////////////////////
+
+int WADefuzzVarObj::get_defuzz_type() const
+{
+	return DefuzzVarObj::DEFUZZ_WA;
+};
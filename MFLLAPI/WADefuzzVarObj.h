@@ -0,0 +1,64 @@
+//
+// File:	WADefuzzVarObj.h
+//
+// Purpose:	Variable class for the Weighted Average defuzzification method.
+//
+// This file is part of MFLL which is based on the FFLL (Free Fuzzy Logic Library) project (http://ffll.sourceforge.net)
+// It is released under the BSD license, see http://ffll.sourceforge.net/license.txt for the full text.
+//
+
+#ifndef _WADefuzzVarObj_H
+#define _WADefuzzVarObj_H
+
+#include "DefuzzVarObj.h"
+
+class FuzzyOutVariable;
+class WADefuzzSetObj;
+
+//
+// Class:	WADefuzzVarObj
+//
+// Variable object for the Weighted Average defuzzification method ("CoGS" in
+// IEC 61131-7, Centre of Gravity for Singletons).
+//
+// The output is the average of each set's 'x' value (see WADefuzzSetObj),
+// weighted by the set's DOM:
+//
+//		output = sum(dom[i] * x[i]) / sum(dom[i])
+//
+// For singleton output sets (a zero-order Sugeno model) this is exactly the
+// Center of Gravity, but it doesn't need COG's area/moment table for every DOM
+// and it uses the singletons' values rather than the nearest index. 
+// FuzzyModelBase uses this method when every output set is a singleton.
+//
+
+class WADefuzzVarObj : public DefuzzVarObj
+{
+	////////////////////////////////////////
+	////////// Member Functions ////////////
+	////////////////////////////////////////
+
+	public:
+		// constructor/destructor funcs
+		WADefuzzVarObj();// No function body for this. Explicitly disallow auto-creation of it by the compiler
+		WADefuzzVarObj(FuzzyOutVariable* _parent);
+		virtual ~WADefuzzVarObj();
+
+		// get functions
+		int get_defuzz_type() const;
+
+		// misc functions
+		RealType calc_value(DOMType* out_set_dom_arr);
+
+	protected:
+
+		// get functions
+		WADefuzzSetObj* get_set_defuzz_obj(int set_idx) const;
+
+}; // end class WADefuzzVarObj
+
+#else
+
+class WADefuzzVarObj;
+
+#endif // _WADefuzzVarObj_H